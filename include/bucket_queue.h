@@ -0,0 +1,175 @@
+/******************************************************************************
+ * @writer:      Tal Aharon
+ * @date:        19.10.2026
+ *
+ * @description: This header file defines the interface for a bucket queue, a
+ * FIFO per priority level found through a hierarchy of bitmaps, used as the
+ * engine of the queues of few distinct priority levels. Levels are unsigned
+ * integers below the number of levels, up to BUCKET_QUEUE_MAX_LEVELS, and the
+ * smallest level has the highest priority.
+ *
+ * Every bit of the lowest bitmap tells whether a level holds data and every
+ * bit of a bitmap above tells whether a word below it is non zero, so the
+ * smallest or largest level is found with one bit scan per bitmap: three for
+ * 65536 levels on 64 bit words. Inserting, removing and finding the smallest
+ * or largest level take O(1).
+ *
+ * Nothing is ever compared: the order comes from the levels alone, and data
+ * of equal level leaves in the order it arrived.
+ *
+ * Detailed function descriptions and usage guidelines can be found in the
+ * comments within this header file.
+ *
+******************************************************************************/
+#ifndef __BUCKET_QUEUE_H__
+#define __BUCKET_QUEUE_H__
+
+#include <stddef.h> /*size_t, NULL */
+
+#include "radix_sort.h" /* radix_sort_item_t */
+
+typedef struct bucket_queue bucket_queue_t;
+
+/******************************************************************************
+ * @typedef bucket_queue_ismatch_func_t
+ * @brief   Function pointer type for matching data elements. This function checks
+ *          if the data element matches a parameter and returns non-zero if they match.
+******************************************************************************/
+typedef int (*bucket_queue_ismatch_func_t) (void *data, void *parameter);
+
+#define BUCKET_QUEUE_MAX_LEVELS (65536UL)
+
+/******************************************************************************
+ * @brief        Creates a new, empty bucket queue.
+ * @param levels Number of levels, 1 to BUCKET_QUEUE_MAX_LEVELS.
+ * @return       Pointer to the created queue, or NULL if creation fails.
+ * @note         Time Complexity: O(levels / word bits)
+******************************************************************************/
+bucket_queue_t *BucketQueueCreate(unsigned long levels);
+
+/******************************************************************************
+ * @brief       Destroys a bucket queue and its items.
+ * @param queue Pointer to the queue to be destroyed.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+void BucketQueueDestroy(bucket_queue_t *queue);
+
+/******************************************************************************
+ * @brief       Inserts data at a level, behind the data already there.
+ * @param queue Pointer to the queue.
+ * @param level Level of the data, below the number of levels.
+ * @param data  Pointer to the data to be inserted.
+ * @return      0 on success, or a non-zero value if an allocation failed, in
+ *              which case the queue is unchanged.
+ * @note        Time Complexity: amortized O(1)
+******************************************************************************/
+int BucketQueueInsert(bucket_queue_t *queue, unsigned long level, void *data);
+
+/******************************************************************************
+ * @brief       Inserts a batch sorted by level, every data behind the data
+ *              already at its level. The items of a batch take consecutive
+ *              places of the pool, so every run of equal level is linked in
+ *              one sweep and appended to its level at once.
+ * @param queue Pointer to the queue.
+ * @param items Array of count items in ascending order of level, as RadixSort
+ *              leaves them, the key of every item being its level.
+ * @param count Number of items.
+ * @return      0 on success, or a non-zero value if the pool could not grow,
+ *              in which case the queue is unchanged.
+ * @note        Time Complexity: O(count)
+******************************************************************************/
+int BucketQueueInsertBatch(bucket_queue_t *queue, const radix_sort_item_t *items, size_t count);
+
+/******************************************************************************
+ * @brief       Returns the oldest data of the smallest level.
+ * @param queue Pointer to a non empty queue.
+ * @return      Pointer to the data.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+void *BucketQueuePeekMin(const bucket_queue_t *queue);
+
+/******************************************************************************
+ * @brief       Returns the newest data of the largest level, the one a full
+ *              queue gives up first.
+ * @param queue Pointer to a non empty queue.
+ * @return      Pointer to the data.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+void *BucketQueuePeekMax(const bucket_queue_t *queue);
+
+/******************************************************************************
+ * @brief       Removes and returns the oldest data of the smallest level.
+ * @param queue Pointer to a non empty queue.
+ * @return      Pointer to the removed data.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+void *BucketQueuePopMin(bucket_queue_t *queue);
+
+/******************************************************************************
+ * @brief       Removes and returns the newest data of the largest level.
+ * @param queue Pointer to a non empty queue.
+ * @return      Pointer to the removed data.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+void *BucketQueuePopMax(bucket_queue_t *queue);
+
+/******************************************************************************
+ * @brief       Finds the oldest data of the smallest level not below a value.
+ * @param queue Pointer to the queue.
+ * @param value Value to start from.
+ * @param data  Receives the data when found.
+ * @return      0 if found, or a non-zero value if every level is below value.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+int BucketQueueFindNext(const bucket_queue_t *queue, unsigned long value, void **data);
+
+/******************************************************************************
+ * @brief       Finds the oldest data of the largest level not above a value.
+ * @param queue Pointer to the queue.
+ * @param value Value to start from.
+ * @param data  Receives the data when found.
+ * @return      0 if found, or a non-zero value if every level is above value.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+int BucketQueueFindPrev(const bucket_queue_t *queue, unsigned long value, void **data);
+
+/******************************************************************************
+ * @brief           Removes the first data, in the order of removal from the
+ *                  minimum, that the matching function accepts.
+ * @param queue     Pointer to the queue.
+ * @param ismatch   Matching function.
+ * @param parameter Parameter passed to the matching function.
+ * @param data      Receives the removed data when found.
+ * @return          0 if data was removed, or a non-zero value if none matched.
+ * @note            Time Complexity: O(n + levels / word bits)
+******************************************************************************/
+int BucketQueueRemoveIf(bucket_queue_t *queue, bucket_queue_ismatch_func_t ismatch, void *parameter, void **data);
+
+/******************************************************************************
+ * @brief       Removes all data from the queue.
+ * @param queue Pointer to the queue.
+ * @note        Time Complexity: O(levels / word bits)
+******************************************************************************/
+void BucketQueueClear(bucket_queue_t *queue);
+
+/******************************************************************************
+ * @brief       Returns the number of data elements in the queue.
+ * @param queue Pointer to the queue.
+ * @return      Number of data elements.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+size_t BucketQueueSize(const bucket_queue_t *queue);
+
+/******************************************************************************
+ * @brief        Returns the bytes the queue has requested from malloc.
+ * @param queue  Pointer to the queue.
+ * @param nodes  Receives the bytes of the items holding data.
+ * @param spare  Receives the bytes of the free items of the pool.
+ * @param blocks Receives the number of malloc blocks the bytes are spread on.
+ * @return       Number of bytes, the queue, its bitmaps, levels and pool
+ *               included.
+ * @note         Time Complexity: O(1)
+******************************************************************************/
+size_t BucketQueueMemoryUsage(const bucket_queue_t *queue, size_t *nodes, size_t *spare, size_t *blocks);
+
+#endif /* __BUCKET_QUEUE_H__ */
@@ -39,7 +39,7 @@ void DLLDestroy(dll_t *dll);
  * @brief          Inserts a new node with data after the given iterator.
  * @param iterator Iterator to the position after which the new node should be inserted.
  * @param data     Pointer to the data to be inserted.
- * @return         Iterator pointing to the inserted node, or end of the list if insertion fails.
+ * @return         Iterator pointing to the inserted node, or NULL if insertion fails.
  * Complexity      Time complexity: O(1), Space complexity: O(1).
 ******************************************************************************/
 dll_iter_t DLLInsertAfter(dll_iter_t iterator, void *data);
@@ -48,7 +48,8 @@ dll_iter_t DLLInsertAfter(dll_iter_t iterator, void *data);
  * @brief          Inserts a new node with data before the given iterator.
  * @param iterator Iterator to the position before which the new node should be inserted.
  * @param data     Pointer to the data to be inserted.
- * @return         Iterator pointing to the inserted node, or end of the list if insertion fails.
+ * @return         Iterator pointing to the inserted node, or NULL if insertion fails.
+ *                 The list is left as it was.
  * Complexity      Time complexity: O(1), Space complexity: O(1).
 ******************************************************************************/
 dll_iter_t DLLInsertBefore(dll_iter_t iterator, void *data);
@@ -168,6 +169,16 @@ int DLLIterIsEqual(const dll_iter_t iter1, const dll_iter_t iter2);
 ******************************************************************************/
 size_t DLLCount(const dll_t *dll);
 
+/******************************************************************************
+ * @brief        Returns the bytes the list has requested from malloc.
+ * @param dll    Pointer to the list.
+ * @param nodes  Receives the bytes of the nodes holding data.
+ * @param blocks Receives the number of malloc blocks the bytes are spread on.
+ * @return       Number of bytes, the list and its dummy node included.
+ * Complexity    Time complexity: O(n), Space complexity: O(1).
+******************************************************************************/
+size_t DLLMemoryUsage(const dll_t *dll, size_t *nodes, size_t *blocks);
+
 /******************************************************************************
  * @brief       Iterates through the list and performs an action on each node's data.
  * @param from  Iterator pointing to the start of the range.
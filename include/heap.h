@@ -0,0 +1,270 @@
+/******************************************************************************
+ * @writer:      Tal Aharon
+ * @date:        18.10.2026
+ *
+ * @description: This header file defines the interface for a d-ary heap data
+ * structure, binary unless created with another arity. The heap keeps the
+ * element with the highest priority at its root,
+ * according to a user-defined comparison function, and is used as an array
+ * backed engine for the priority queue.
+ *
+ * Elements are kept in segmented arrays: every time the heap runs out of room a
+ * new chunk, twice as large as the previous one, is added after the old chunks.
+ * Existing elements are never copied, so a single push never costs more than
+ * one allocation and a constant amount of work besides the sift itself.
+ *
+ * Every element owns a handle taken from a pool that also lives in a segmented
+ * array. A handle follows its element while the heap reorders itself, so it
+ * can be used to remove or re-prioritize that element until it leaves the heap.
+ *
+ * Detailed function descriptions and usage guidelines can be found in the
+ * comments within this header file.
+ *
+******************************************************************************/
+#ifndef __HEAP_H__
+#define __HEAP_H__
+
+#include <stddef.h> /*size_t, NULL */
+
+typedef struct heap heap_t;
+
+typedef struct heap_handle *heap_handle_t;
+
+/******************************************************************************
+ * @typedef heap_compare_func_t
+ * @brief   Function pointer type for ordering the heap. Same contract as the
+ *          priority queue comparison function:
+ * - A positive value if the new data has higher priority than the data.
+ * - A negative value if the new data has lower priority than the data.
+ * - Zero if both have the same priority.
+******************************************************************************/
+typedef int (*heap_compare_func_t) (void *data, void *new_data);
+
+/******************************************************************************
+ * @typedef heap_ismatch_func_t
+ * @brief   Function pointer type for matching data elements. This function checks
+ *          if the data element matches a parameter and returns non-zero if they match.
+******************************************************************************/
+typedef int (*heap_ismatch_func_t) (void *data, void *parameter);
+
+/******************************************************************************
+ * @typedef heap_compare_batch_func_t
+ * @brief   Function pointer type comparing one data element against several at
+ *          once. Bit i of the result is set when new_data[i] has higher 
+ *          priority than data, that is when the compare function would return
+ *          a positive value. count is at most HEAP_MAX_ARITY.
+******************************************************************************/
+typedef unsigned long (*heap_compare_batch_func_t) (void *data, void **new_data, size_t count);
+
+#define HEAP_MAX_ARITY (8)
+
+/******************************************************************************
+ * @brief         Creates a new heap.
+ * @param compare Function to use for ordering the heap.
+ * @return        Pointer to the created heap, or NULL if creation fails.
+ * @note          Time Complexity: O(1)
+******************************************************************************/
+heap_t *HeapCreate(heap_compare_func_t compare);
+
+/******************************************************************************
+ * @brief         Creates a new heap where every element has up to arity 
+ *                children. A wider heap is shallower, so sifting down touches
+ *                fewer levels but compares more children on each.
+ * @param compare Function to use for ordering the heap.
+ * @param arity   Number of children per element, 2 to HEAP_MAX_ARITY.
+ * @return        Pointer to the created heap, or NULL if creation fails.
+ * @note          Time Complexity: O(1)
+******************************************************************************/
+heap_t *HeapCreateArity(heap_compare_func_t compare, size_t arity);
+
+/******************************************************************************
+ * @brief         Sets a batch compare function, used to compare the element
+ *                being sifted down with all children of a level in one call.
+ *                It has to agree with the compare function of the heap.
+ * @param heap    Pointer to the heap.
+ * @param batch   Batch compare function, or NULL to compare one by one.
+ * @note          Time Complexity: O(1)
+******************************************************************************/
+void HeapSetCompareBatch(heap_t *heap, heap_compare_batch_func_t batch);
+
+/******************************************************************************
+ * @brief      Destroys a heap and its storage.
+ * @param heap Pointer to the heap to be destroyed.
+ * @note       Time Complexity: O(log n)
+******************************************************************************/
+void HeapDestroy(heap_t *heap);
+
+/******************************************************************************
+ * @brief      Pushes data into the heap.
+ * @param heap Pointer to the heap.
+ * @param data Pointer to the data to be pushed.
+ * @return     0 on success, or a non-zero value if storage could not grow.
+ * @note       Time Complexity: O(log n). Growth allocates one chunk and never
+ *             copies existing elements.
+******************************************************************************/
+int HeapPush(heap_t *heap, void *data);
+
+/******************************************************************************
+ * @brief      Pushes data into the heap and returns a handle to it.
+ * @param heap Pointer to the heap.
+ * @param data Pointer to the data to be pushed.
+ * @return     Handle to the pushed element, or NULL if storage could not grow.
+ *             The handle stays valid until its element is popped or removed,
+ *             or the heap is cleared or destroyed.
+ * @note       Time Complexity: O(log n)
+******************************************************************************/
+heap_handle_t HeapPushHandle(heap_t *heap, void *data);
+
+/******************************************************************************
+ * @brief       Pushes several data elements at once. They are appended and the
+ *              heap is rebuilt bottom up when they are at least as many as the
+ *              elements already in it, sifted up one by one otherwise.
+ * @param heap  Pointer to the heap.
+ * @param data  Array of data to be pushed.
+ * @param count Number of elements in data.
+ * @return      0 on success, or a non-zero value if storage could not grow, in
+ *              which case nothing was pushed.
+ * @note        Time Complexity: O(n + m) when m is at least n, O(m log(n + m))
+ *              otherwise.
+******************************************************************************/
+int HeapPushBatch(heap_t *heap, void **data, size_t count);
+
+/******************************************************************************
+ * @brief        Removes the element owning the handle and returns its data.
+ * @param heap   Pointer to the heap.
+ * @param handle Valid handle returned by HeapPushHandle.
+ * @return       Pointer to the removed data.
+ * @note         Time Complexity: O(log n)
+******************************************************************************/
+void *HeapRemoveHandle(heap_t *heap, heap_handle_t handle);
+
+/******************************************************************************
+ * @brief        Replaces the data of the element owning the handle and moves
+ *               the element to the position matching its new priority.
+ * @param heap   Pointer to the heap.
+ * @param handle Valid handle returned by HeapPushHandle.
+ * @param data   Pointer to the new data.
+ * @note         Time Complexity: O(log n)
+******************************************************************************/
+void HeapUpdateHandle(heap_t *heap, heap_handle_t handle, void *data);
+
+/******************************************************************************
+ * @brief        Returns the data of the element owning the handle.
+ * @param heap   Pointer to the heap.
+ * @param handle Valid handle returned by HeapPushHandle.
+ * @return       Pointer to the data.
+ * @note         Time Complexity: O(1)
+******************************************************************************/
+void *HeapHandleData(const heap_t *heap, heap_handle_t handle);
+
+/******************************************************************************
+ * @brief      Removes and returns the data with the highest priority.
+ * @param heap Pointer to the heap.
+ * @return     Pointer to the removed data, or NULL if the heap is empty.
+ * @note       Time Complexity: O(log n)
+******************************************************************************/
+void *HeapPop(heap_t *heap);
+
+/******************************************************************************
+ * @brief      Returns the data with the highest priority without removing it.
+ * @param heap Pointer to the heap.
+ * @return     Pointer to the data, or NULL if the heap is empty.
+ * @note       Time Complexity: O(1)
+******************************************************************************/
+void *HeapPeek(const heap_t *heap);
+
+/******************************************************************************
+ * @brief      Returns the number of elements in the heap.
+ * @param heap Pointer to the heap.
+ * @return     Number of elements in the heap.
+ * @note       Time Complexity: O(1)
+******************************************************************************/
+size_t HeapSize(const heap_t *heap);
+
+/******************************************************************************
+ * @brief      Returns the number of comparisons the heap has made since its
+ *             creation.
+ * @param heap Pointer to the heap.
+ * @return     Number of calls to the compare function.
+ * @note       Time Complexity: O(1)
+******************************************************************************/
+size_t HeapComparisons(const heap_t *heap);
+
+/******************************************************************************
+ * @brief        Returns the bytes the heap has requested from malloc.
+ * @param heap   Pointer to the heap.
+ * @param nodes  Receives the bytes of the slots and handles holding elements.
+ * @param spare  Receives the bytes of slots and handles reserved but unused.
+ * @param blocks Receives the number of malloc blocks the bytes are spread on.
+ * @return       Number of bytes, the heap and the array directories included.
+ * @note         Time Complexity: O(1)
+******************************************************************************/
+size_t HeapMemoryUsage(const heap_t *heap, size_t *nodes, size_t *spare, size_t *blocks);
+
+/******************************************************************************
+ * @brief      Checks if the heap is empty.
+ * @param heap Pointer to the heap.
+ * @return     Non-zero value if empty, 0 if not empty.
+ * @note       Time Complexity: O(1)
+******************************************************************************/
+int HeapIsEmpty(const heap_t *heap);
+
+/******************************************************************************
+ * @brief           Finds the index of the first element matching the parameter.
+ * @param heap      Pointer to the heap.
+ * @param match     Matching function.
+ * @param parameter Pointer to the parameter used for matching.
+ * @return          Index of the found element, or HeapSize(heap) if not found.
+ * @note            Time Complexity: O(n)
+******************************************************************************/
+size_t HeapFindIf(const heap_t *heap, heap_ismatch_func_t match, void *parameter);
+
+/******************************************************************************
+ * @brief       Returns the data of the element at the given index.
+ * @param heap  Pointer to the heap.
+ * @param index Index of the element, as returned by HeapFindIf or HeapLowest.
+ * @return      Pointer to the data.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+void *HeapDataAt(const heap_t *heap, size_t index);
+
+/******************************************************************************
+ * @brief      Finds the index of the element with the lowest priority. Only the
+ *             leaves can hold it, so only they are compared.
+ * @param heap Pointer to the heap, its comparison count grows by the
+ *             comparisons made.
+ * @return     Index of the lowest element, or HeapSize(heap) if empty.
+ * @note       Time Complexity: O(n)
+******************************************************************************/
+size_t HeapLowest(heap_t *heap);
+
+/******************************************************************************
+ * @brief       Removes the element at the given index and returns its data.
+ * @param heap  Pointer to the heap.
+ * @param index Index of the element, as returned by HeapFindIf.
+ * @return      Pointer to the removed data.
+ * @note        Time Complexity: O(log n)
+******************************************************************************/
+void *HeapRemoveAt(heap_t *heap, size_t index);
+
+/******************************************************************************
+ * @brief        Moves all elements of source into dest. Handles into dest stay
+ *               valid, handles into source are invalidated. Both heaps must
+ *               use the same ordering.
+ * @param dest   Pointer to the heap receiving the elements.
+ * @param source Pointer to the heap giving the elements.
+ * @return       0 on success, or a non-zero value if storage could not grow;
+ *               elements not moved yet remain in source.
+ * @note         Time Complexity: O(n + m) when source is at least as large as
+ *               dest, O(m log(n + m)) otherwise.
+******************************************************************************/
+int HeapMerge(heap_t *dest, heap_t *source);
+
+/******************************************************************************
+ * @brief      Removes all elements from the heap. Invalidates all handles.
+ * @param heap Pointer to the heap.
+ * @note       Time Complexity: O(log n)
+******************************************************************************/
+void HeapClear(heap_t *heap);
+
+#endif /* __HEAP_H__ */
@@ -22,10 +22,152 @@
 #ifndef __PRIORITY_QUEUE_H__
 #define __PRIORITY_QUEUE_H__
 
-#include <stddef.h> /*size_t, NULL */
+#include <stddef.h>             /*size_t, NULL */
+#include "priority_queue_api.h" /* PRIORITY_QUEUE_API */
 
 typedef struct priority_queue priority_queue_t;
 
+typedef struct priority_queue_handle *priority_queue_handle_t;
+
+typedef struct priority_queue_selector priority_queue_selector_t;
+
+/******************************************************************************
+ * @typedef Engine used to keep the queue ordered.
+ *
+ * - PRIORITY_QUEUE_SORTED_LIST: Sorted doubly linked list. O(n) enqueue, O(1)
+ *   dequeue. Elements of equal priority keep a fixed relative order.
+ * - PRIORITY_QUEUE_BINARY_HEAP: Binary heap over segmented storage. O(log n)
+ *   enqueue and dequeue, growth never copies existing elements. The order of
+ *   elements of equal priority is unspecified. Supports handles.
+ * - PRIORITY_QUEUE_DARY_HEAP: The same heap with four children per element.
+ *   Half as deep, so a dequeue touches half as many levels for up to twice
+ *   the comparisons per level. Supports handles.
+ * - PRIORITY_QUEUE_VEB: van Emde Boas tree over integer keys, created with
+ *   PriorityQueueCreateKeyed. The smallest key is dequeued first, elements of
+ *   equal key in the order they were enqueued. O(log log U) enqueue and 
+ *   dequeue for a universe of U keys, no comparisons, and the next or previous
+ *   key to any value is found in O(log log U) as well. No handles.
+ * - PRIORITY_QUEUE_BUCKETS: A FIFO per key over at most 
+ *   PRIORITY_QUEUE_MAX_LEVELS keys, created with PriorityQueueCreateBuckets. 
+ *   The smallest non empty key is found through a hierarchy of bitmaps, three
+ *   bit scans for 65536 keys, so enqueue, dequeue and the next or previous key
+ *   take O(1). Same order as PRIORITY_QUEUE_VEB, no comparisons, no handles.
+******************************************************************************/
+typedef enum priority_queue_engine
+{
+	PRIORITY_QUEUE_SORTED_LIST = 0,
+	PRIORITY_QUEUE_BINARY_HEAP,
+	PRIORITY_QUEUE_DARY_HEAP,
+	PRIORITY_QUEUE_VEB,
+	PRIORITY_QUEUE_BUCKETS
+
+} priority_queue_engine_t;
+
+/******************************************************************************
+ * @typedef Status codes of the queue operations. The data of the element an
+ * operation removes is passed back through an out-parameter, so any pointer,
+ * NULL or the queue itself included, can be stored as data.
+ *
+ * - PRIORITY_QUEUE_SUCCESS:   The operation was carried out.
+ * - PRIORITY_QUEUE_NO_MEMORY: Storage for an element could not be allocated.
+ * - PRIORITY_QUEUE_FULL:      A bounded queue could not make room.
+ * - PRIORITY_QUEUE_EMPTY:     There was no element to return.
+ * - PRIORITY_QUEUE_NOT_FOUND: No element matched.
+******************************************************************************/
+typedef enum priority_queue_status
+{
+	PRIORITY_QUEUE_SUCCESS = 0,
+	PRIORITY_QUEUE_NO_MEMORY,
+	PRIORITY_QUEUE_FULL,
+	PRIORITY_QUEUE_EMPTY,
+	PRIORITY_QUEUE_NOT_FOUND
+
+} priority_queue_status_t;
+
+/******************************************************************************
+ * @typedef What an enqueue does when the queue holds as many elements as its
+ * capacity.
+ *
+ * - PRIORITY_QUEUE_REJECT:       The new element is refused with
+ *   PRIORITY_QUEUE_FULL and the queue is left as it is.
+ * - PRIORITY_QUEUE_EVICT_LOWEST: The element of lowest priority makes room. If
+ *   it is a queued element it is removed and handed to the evict function; if
+ *   the new element has the lowest priority it is refused as with reject.
+******************************************************************************/
+typedef enum priority_queue_overflow
+{
+	PRIORITY_QUEUE_REJECT = 0,
+	PRIORITY_QUEUE_EVICT_LOWEST
+
+} priority_queue_overflow_t;
+
+#define PRIORITY_QUEUE_HISTOGRAM_BUCKETS (32)
+#define PRIORITY_QUEUE_MAX_LEVELS (65536UL)
+
+/******************************************************************************
+ * @typedef Histogram of a per operation cost, in power of two buckets. Bucket 0
+ * counts operations of cost 0, bucket b counts costs in [2^(b-1), 2^b), and the
+ * last bucket also counts every larger cost.
+******************************************************************************/
+typedef struct priority_queue_histogram
+{
+	size_t samples;
+	size_t total;
+	size_t max;
+	size_t buckets[PRIORITY_QUEUE_HISTOGRAM_BUCKETS];
+
+} priority_queue_histogram_t;
+
+/******************************************************************************
+ * @typedef Operation costs recorded by a queue since creation or the last reset.
+ *
+ * - insert_comparisons:  Compare calls per enqueue. A sorted list close to its 
+ *                        size here is hitting the worst case on every insert.
+ * - dequeue_comparisons: Compare calls per dequeue, zero for the sorted list.
+ * - scan_length:         Elements visited per erase.
+ * - sojourn_us:          Microseconds a dequeued element spent in the queue.
+ *                        Only recorded by a library built with
+ *                        PRIORITY_QUEUE_SOJOURN defined, empty otherwise.
+ * - enqueued:            Elements enqueued one at a time or in a batch.
+ * - dequeued:            Elements removed one at a time: dequeued from either
+ *                        end, erased, evicted or dropped. Merges and clears move
+ *                        or discard elements without counting them in either.
+ * - dropped:             Elements dropped by active queue management.
+ * - evicted:             Queued elements removed to make room for a new one.
+ * - rejected:            Enqueues refused because the queue was full.
+******************************************************************************/
+typedef struct priority_queue_stats
+{
+	priority_queue_histogram_t insert_comparisons;
+	priority_queue_histogram_t dequeue_comparisons;
+	priority_queue_histogram_t scan_length;
+	priority_queue_histogram_t sojourn_us;
+	size_t enqueued;
+	size_t dequeued;
+	size_t dropped;
+	size_t evicted;
+	size_t rejected;
+
+} priority_queue_stats_t;
+
+/******************************************************************************
+ * @typedef Bytes a queue holds on the heap, not counting the user data.
+ *
+ * - nodes:    Per element storage: list nodes, or heap slots and handles.
+ * - index:    The queue, engine and directory structures.
+ * - spare:    Storage reserved for elements that are not there.
+ * - overhead: Allocator bookkeeping, estimated as one size_t header per malloc
+ *             block the way glibc does it. Alignment padding is not included.
+******************************************************************************/
+typedef struct priority_queue_memory
+{
+	size_t nodes;
+	size_t index;
+	size_t spare;
+	size_t overhead;
+
+} priority_queue_memory_t;
+
 /******************************************************************************
  * @typedef Comparison function type for prioritizing elements in the queue. This 
  * function type defines the signature of a comparison function that determines 
@@ -37,12 +179,40 @@ typedef struct priority_queue priority_queue_t;
  * - Negative: 'new_data' has lower priority than 'data' (dequeued after).
  * - Zero: 'data' and 'new_data' have the same priority (new_data dequeued after data).
  *
+ * The sign must be consistent: swapping the arguments negates it, and the order
+ * it defines is transitive. Returning the difference of two keys truncated to
+ * int breaks both for large keys, the PriorityQueueCompare helpers below return
+ * (new_key > key) - (new_key < key) instead.
+ *
  * @param data     Pointer to the existing data element for comparison.
  * @param new_data Pointer to the new data element to compare.
  * @return         Integer indicating the comparison result.
 ******************************************************************************/
 typedef int (*priority_queue_compare_func_t) (void *data, void *new_data);
 
+/******************************************************************************
+ * @typedef Batch comparison function type, comparing one data element against
+ * several at once so the comparisons can be vectorized. It must agree with the
+ * compare function of the queue.
+ *
+ * @param data     Pointer to the data element compared against.
+ * @param new_data Array of count data elements, count is at most 8.
+ * @param count    Number of elements in new_data.
+ * @return         Mask with bit i set when new_data[i] has higher priority 
+ *                 than data, that is when compare(data, new_data[i]) > 0.
+******************************************************************************/
+typedef unsigned long (*priority_queue_compare_batch_func_t) (void *data, void **new_data, size_t count);
+
+/******************************************************************************
+ * @typedef Key function type of the keyed queues. The key orders the elements
+ * instead of a comparison function: the smaller key is dequeued first. The key
+ * of an element must not change while it is queued.
+ *
+ * @param data Pointer to the data element.
+ * @return     Key of the element, below 2^bits of its queue.
+******************************************************************************/
+typedef unsigned long (*priority_queue_key_func_t) (void *data);
+
 /******************************************************************************
  * @typedef Matching function type for erasing elements in the queue.
  * This function type defines the signature of a matching function used to
@@ -57,6 +227,25 @@ typedef int (*priority_queue_compare_func_t) (void *data, void *new_data);
 ******************************************************************************/
 typedef int (*priority_queue_ismatch_func_t) (void *data, void *new_data);
 
+/******************************************************************************
+ * @typedef Function receiving the elements dropped by active queue management.
+ * The element has already left the queue when it is called.
+ *
+ * @param data      Pointer to the dropped data element.
+ * @param parameter User-defined parameter given with the drop function.
+******************************************************************************/
+typedef void (*priority_queue_drop_func_t) (void *data, void *parameter);
+
+/******************************************************************************
+ * @typedef Function told when the number of elements crosses a watermark.
+ *
+ * @param size      Number of elements in the queue.
+ * @param high      1 when the high watermark was reached, 0 when the queue
+ *                  drained back to the low watermark.
+ * @param parameter User-defined parameter given with the watermark function.
+******************************************************************************/
+typedef void (*priority_queue_watermark_func_t) (size_t size, int high, void *parameter);
+
 /******************************************************************************
  * @brief Creates a new priority queue.This function creates a new priority queue 
  * and returns a pointer to it. The comparison function passed as an argument will 
@@ -65,7 +254,44 @@ typedef int (*priority_queue_ismatch_func_t) (void *data, void *new_data);
  * @param compare Comparison function for element priority.
  * @return        Pointer to the newly created priority queue, or NULL on failure.
 ******************************************************************************/
-priority_queue_t *PriorityQueueCreate(priority_queue_compare_func_t compare);
+PRIORITY_QUEUE_API priority_queue_t *PriorityQueueCreate(priority_queue_compare_func_t compare);
+
+/******************************************************************************
+ * @brief Creates a new priority queue backed by the given engine. Behaves like 
+ * PriorityQueueCreate, which is equivalent to using PRIORITY_QUEUE_SORTED_LIST.
+ * 
+ * @param compare Comparison function for element priority.
+ * @param engine  Engine used to keep the queue ordered.
+ * @return        Pointer to the newly created priority queue, or NULL on failure
+ *                and for PRIORITY_QUEUE_VEB and PRIORITY_QUEUE_BUCKETS, which
+ *                need keys.
+******************************************************************************/
+PRIORITY_QUEUE_API priority_queue_t *PriorityQueueCreateEngine(priority_queue_compare_func_t compare, priority_queue_engine_t engine);
+
+/******************************************************************************
+ * @brief Creates a priority queue ordered by integer keys, backed by the
+ * PRIORITY_QUEUE_VEB engine, which PriorityQueueCreateEngine can not create.
+ * The smallest key is dequeued first and the key with the lowest priority is
+ * the largest. Keyed queues have no compare function, so they add to a 
+ * selector only through its own compare function.
+ *
+ * @param key  Key function of the elements.
+ * @param bits Number of bits of the keys, 1 to 32.
+ * @return     Pointer to the newly created priority queue, or NULL on failure.
+******************************************************************************/
+PRIORITY_QUEUE_API priority_queue_t *PriorityQueueCreateKeyed(priority_queue_key_func_t key, unsigned int bits);
+
+/******************************************************************************
+ * @brief Creates a priority queue ordered by integer keys below a number of 
+ * levels, backed by the PRIORITY_QUEUE_BUCKETS engine. It orders like a queue
+ * of PriorityQueueCreateKeyed and takes memory for every level up front, 
+ * about 16 bytes each, so it suits a small dense range of priorities.
+ *
+ * @param key    Key function of the elements, returning a key below levels.
+ * @param levels Number of levels, 1 to PRIORITY_QUEUE_MAX_LEVELS.
+ * @return       Pointer to the newly created priority queue, or NULL on failure.
+******************************************************************************/
+PRIORITY_QUEUE_API priority_queue_t *PriorityQueueCreateBuckets(priority_queue_key_func_t key, unsigned long levels);
 
 /******************************************************************************
  * @brief Destroys a priority queue. This function deallocates the memory used by 
@@ -74,7 +300,7 @@ priority_queue_t *PriorityQueueCreate(priority_queue_compare_func_t compare);
  *
  * @param queue Pointer to the priority queue to destroy.
 ******************************************************************************/
-void PriorityQueueDestroy(priority_queue_t *queue);
+PRIORITY_QUEUE_API void PriorityQueueDestroy(priority_queue_t *queue);
 
 /******************************************************************************
  * @brief Adds an element to the priority queue. This function inserts the specified 
@@ -84,9 +310,44 @@ void PriorityQueueDestroy(priority_queue_t *queue);
  *
  * @param queue Pointer to the priority queue.
  * @param data  Pointer to the data element to enqueue.
- * @return      0 on success, or a non-zero value on failure.
+ * @return      PRIORITY_QUEUE_SUCCESS, PRIORITY_QUEUE_FULL if the queue is at 
+ *              capacity and could not make room, or PRIORITY_QUEUE_NO_MEMORY 
+ *              if memory ran out, in which case nothing is enqueued.
+******************************************************************************/
+PRIORITY_QUEUE_API int PriorityQueueEnqueue(priority_queue_t *queue, void *data);
+
+/******************************************************************************
+ * @brief Adds an element to the priority queue and returns a handle to it. The 
+ * handle keeps referring to the element while the queue reorders itself and can 
+ * be used to erase or re-prioritize it. It is valid until the element leaves 
+ * the queue, or the queue is cleared or destroyed.
+ *
+ * @param queue Pointer to the priority queue.
+ * @param data  Pointer to the data element to enqueue.
+ * @return      Handle to the enqueued element, or NULL on failure or if the 
+ *              queue is full. Always NULL for engines that do not support 
+ *              handles (sorted list, vEB, buckets), in which case nothing is enqueued.
+******************************************************************************/
+PRIORITY_QUEUE_API priority_queue_handle_t PriorityQueueEnqueueHandle(priority_queue_t *queue, void *data);
+
+/******************************************************************************
+ * @brief Removes the element owning the handle from the queue.
+ *
+ * @param queue  Pointer to the priority queue.
+ * @param handle Valid handle returned by PriorityQueueEnqueueHandle.
+ * @return       Pointer to the data of the removed element.
+******************************************************************************/
+PRIORITY_QUEUE_API void *PriorityQueueEraseHandle(priority_queue_t *queue, priority_queue_handle_t handle);
+
+/******************************************************************************
+ * @brief Replaces the data of the element owning the handle and moves it to the 
+ * position matching its new priority. The handle stays valid.
+ *
+ * @param queue  Pointer to the priority queue.
+ * @param handle Valid handle returned by PriorityQueueEnqueueHandle.
+ * @param data   Pointer to the new data element.
 ******************************************************************************/
-int PriorityQueueEnqueue(priority_queue_t *queue, void *data);
+PRIORITY_QUEUE_API void PriorityQueueUpdateHandle(priority_queue_t *queue, priority_queue_handle_t handle, void *data);
 
 /******************************************************************************
  * @brief Removes and returns the highest-priority element from the queue. This 
@@ -96,7 +357,7 @@ int PriorityQueueEnqueue(priority_queue_t *queue, void *data);
  * @param queue Pointer to the priority queue.
  * @return      Pointer to the data of the dequeued element, or NULL if the queue is empty.
 ******************************************************************************/
-void *PriorityQueueDequeue(priority_queue_t *queue);
+PRIORITY_QUEUE_API void *PriorityQueueDequeue(priority_queue_t *queue);
 
 /******************************************************************************
  * @brief Retrieves the data of the highest-priority element without removing it. 
@@ -107,7 +368,7 @@ void *PriorityQueueDequeue(priority_queue_t *queue);
  * @return      Pointer to the data of the highest-priority element, or NULL if 
  *              the queue is empty.
 ******************************************************************************/
-void *PriorityQueuePeek(const priority_queue_t *queue);
+PRIORITY_QUEUE_API void *PriorityQueuePeek(const priority_queue_t *queue);
 
 /******************************************************************************
  * @brief Checks if the priority queue is empty. This function determines whether 
@@ -116,7 +377,7 @@ void *PriorityQueuePeek(const priority_queue_t *queue);
  * @param queue Pointer to the priority queue.
  * @return      1 if the queue is empty, 0 if it is not.
 ******************************************************************************/
-int PriorityQueueIsEmpty(const priority_queue_t *queue);
+PRIORITY_QUEUE_API int PriorityQueueIsEmpty(const priority_queue_t *queue);
 
 /******************************************************************************
  * @brief Returns the number of elements in the priority queue. This function 
@@ -125,7 +386,7 @@ int PriorityQueueIsEmpty(const priority_queue_t *queue);
  * @param queue Pointer to the priority queue.
  * @return      The number of elements in the queue.
 ******************************************************************************/
-size_t PriorityQueueSize(const priority_queue_t *queue);
+PRIORITY_QUEUE_API size_t PriorityQueueSize(const priority_queue_t *queue);
 
 /******************************************************************************
  * @brief Removes an element from the priority queue based on a matching function. 
@@ -139,7 +400,131 @@ size_t PriorityQueueSize(const priority_queue_t *queue);
  * @param parameter User-defined parameter to pass to the ismatch function.
  * @return Pointer to the data of the removed element, or the queue itself if no match is found.
 ******************************************************************************/
-void *PriorityQueueErase(priority_queue_t *queue, priority_queue_ismatch_func_t ismatch, void *parameter);
+PRIORITY_QUEUE_API void *PriorityQueueErase(priority_queue_t *queue, priority_queue_ismatch_func_t ismatch, void *parameter);
+
+/******************************************************************************
+ * @brief Removes the highest-priority element like PriorityQueueDequeue, 
+ * reporting an empty queue by status instead of a NULL sentinel.
+ *
+ * @param queue Pointer to the priority queue.
+ * @param data  Receives the data of the dequeued element, untouched unless the
+ *              status is PRIORITY_QUEUE_SUCCESS.
+ * @return      PRIORITY_QUEUE_SUCCESS, or PRIORITY_QUEUE_EMPTY if there was no
+ *              element.
+******************************************************************************/
+PRIORITY_QUEUE_API priority_queue_status_t PriorityQueueDequeueInto(priority_queue_t *queue, void **data);
+
+/******************************************************************************
+ * @brief Removes the lowest-priority element, the one PRIORITY_QUEUE_EVICT_LOWEST
+ * gives up first: the last of a sorted list, the newest element of the largest
+ * key of a keyed queue, and a lowest leaf of a heap. Active queue management
+ * does not apply.
+ *
+ * @param queue Pointer to the priority queue.
+ * @param data  Receives the data of the removed element, untouched unless the
+ *              status is PRIORITY_QUEUE_SUCCESS.
+ * @return      PRIORITY_QUEUE_SUCCESS, or PRIORITY_QUEUE_EMPTY.
+ * @note        O(1) for the sorted list and buckets, O(log log U) for the vEB,
+ *              O(n) for the heaps, which scan their leaves.
+******************************************************************************/
+PRIORITY_QUEUE_API priority_queue_status_t PriorityQueueDequeueLast(priority_queue_t *queue, void **data);
+
+/******************************************************************************
+ * @brief Retrieves the highest-priority element without removing it, 
+ * reporting an empty queue by status.
+ *
+ * @param queue Pointer to the priority queue.
+ * @param data  Receives the data of the element, untouched unless the status 
+ *              is PRIORITY_QUEUE_SUCCESS.
+ * @return      PRIORITY_QUEUE_SUCCESS, or PRIORITY_QUEUE_EMPTY.
+******************************************************************************/
+PRIORITY_QUEUE_API priority_queue_status_t PriorityQueuePeekInto(const priority_queue_t *queue, void **data);
+
+/******************************************************************************
+ * @brief Removes the first element the matching function accepts, like 
+ * PriorityQueueErase, without returning the queue as a sentinel.
+ *
+ * @param queue     Pointer to the priority queue.
+ * @param ismatch   Matching function to determine if an element should be removed.
+ * @param parameter User-defined parameter to pass to the ismatch function.
+ * @param data      Receives the data of the removed element, untouched unless 
+ *                  the status is PRIORITY_QUEUE_SUCCESS.
+ * @return          PRIORITY_QUEUE_SUCCESS, or PRIORITY_QUEUE_NOT_FOUND.
+******************************************************************************/
+PRIORITY_QUEUE_API priority_queue_status_t PriorityQueueEraseInto(priority_queue_t *queue, priority_queue_ismatch_func_t ismatch, void *parameter, void **data);
+
+/******************************************************************************
+ * @brief Finds the element of the smallest key not below a value in a keyed
+ * queue, without removing it. Among elements of that key, the one enqueued
+ * first is found.
+ *
+ * @param queue Pointer to a priority queue created by PriorityQueueCreateKeyed
+ *              or PriorityQueueCreateBuckets.
+ * @param key   Value to search from, below 2^bits for the vEB.
+ * @param data  Receives the data of the element, untouched unless the status 
+ *              is PRIORITY_QUEUE_SUCCESS.
+ * @return      PRIORITY_QUEUE_SUCCESS, or PRIORITY_QUEUE_NOT_FOUND if every 
+ *              key is below the value.
+******************************************************************************/
+PRIORITY_QUEUE_API priority_queue_status_t PriorityQueueFindNext(const priority_queue_t *queue, unsigned long key, void **data);
+
+/******************************************************************************
+ * @brief Finds the element of the largest key not above a value in a keyed
+ * queue, without removing it. Among elements of that key, the one enqueued
+ * first is found.
+ *
+ * @param queue Pointer to a priority queue created by PriorityQueueCreateKeyed
+ *              or PriorityQueueCreateBuckets.
+ * @param key   Value to search from, below 2^bits for the vEB.
+ * @param data  Receives the data of the element, untouched unless the status 
+ *              is PRIORITY_QUEUE_SUCCESS.
+ * @return      PRIORITY_QUEUE_SUCCESS, or PRIORITY_QUEUE_NOT_FOUND if every 
+ *              key is above the value.
+******************************************************************************/
+PRIORITY_QUEUE_API priority_queue_status_t PriorityQueueFindPrev(const priority_queue_t *queue, unsigned long key, void **data);
+
+/******************************************************************************
+ * @brief Enqueues count elements. Every element is attempted, whatever 
+ * happened to the ones before it, and gets its own status. The heap engines
+ * insert a batch that fits as a whole in one step, rebuilding the heap bottom
+ * up when the batch is at least as large as the queue. The keyed engines radix
+ * sort a batch of 4096 elements or more by key, in the calling thread, and 
+ * insert it in key order. Elements of equal key keep the order of the batch.
+ *
+ * @param queue    Pointer to the priority queue.
+ * @param data     Array of count data elements.
+ * @param count    Number of elements.
+ * @param statuses Receives the status of every element, may be NULL when only
+ *                 the number enqueued matters.
+ * @return         Number of elements enqueued.
+******************************************************************************/
+PRIORITY_QUEUE_API size_t PriorityQueueEnqueueBatch(priority_queue_t *queue, void **data, size_t count, priority_queue_status_t *statuses);
+
+/******************************************************************************
+ * @brief Dequeues up to count elements, highest priority first.
+ *
+ * @param queue Pointer to the priority queue.
+ * @param data  Receives the data of the dequeued elements.
+ * @param count Maximal number of elements to dequeue.
+ * @return      Number of elements dequeued, less than count once the queue is
+ *              empty.
+******************************************************************************/
+PRIORITY_QUEUE_API size_t PriorityQueueDequeueBatch(priority_queue_t *queue, void **data, size_t count);
+
+/******************************************************************************
+ * @brief Moves all elements of the source queue into the destination queue, 
+ * leaving the source empty. Both queues must order elements the same way; they 
+ * may use different engines. Handles into dest stay valid, handles into source 
+ * are invalidated.
+ *
+ * @param dest   Pointer to the priority queue receiving the elements.
+ * @param source Pointer to the priority queue giving the elements.
+ * @return       PRIORITY_QUEUE_SUCCESS, PRIORITY_QUEUE_FULL without moving anything if 
+ *               the elements would not fit the capacity of dest, or 
+ *               PRIORITY_QUEUE_NO_MEMORY if dest could not grow; the elements 
+ *               not moved yet remain in source.
+******************************************************************************/
+PRIORITY_QUEUE_API int PriorityQueueMerge(priority_queue_t *dest, priority_queue_t *source);
 
 /******************************************************************************
  * @brief Clears all elements from the priority queue. This function removes 
@@ -147,6 +532,211 @@ void *PriorityQueueErase(priority_queue_t *queue, priority_queue_ismatch_func_t
  *
  * @param queue Pointer to the priority queue.
 ******************************************************************************/
-void PriorityQueueClear(priority_queue_t *queue);
+PRIORITY_QUEUE_API void PriorityQueueClear(priority_queue_t *queue);
+
+/******************************************************************************
+ * @brief Copies the operation cost histograms recorded by the queue.
+ *
+ * @param queue Pointer to the priority queue.
+ * @param stats Receives the histograms.
+******************************************************************************/
+PRIORITY_QUEUE_API void PriorityQueueStats(const priority_queue_t *queue, priority_queue_stats_t *stats);
+
+/******************************************************************************
+ * @brief Clears the operation cost histograms of the queue.
+ *
+ * @param queue Pointer to the priority queue.
+******************************************************************************/
+PRIORITY_QUEUE_API void PriorityQueueStatsReset(priority_queue_t *queue);
+
+/******************************************************************************
+ * @brief Turns on CoDel active queue management at dequeue. Once elements have
+ * waited longer than target for a whole interval, dequeue still returns the 
+ * head but also drops the element of lowest priority and hands it to the drop 
+ * function, at a rate growing with the square root of the drops until the wait
+ * is back under target. Under overload the queue sheds its least important 
+ * work first, and keeps depth and wait bounded without a monitoring loop. A 
+ * heap finds its lowest element by a scan, so drops cost O(n) there. The usual
+ * values are a target of 5000 and an interval of 100000.
+ *
+ * @param queue       Pointer to the priority queue.
+ * @param target_us   Acceptable time in queue, in microseconds.
+ * @param interval_us Time the wait may stay above target before dropping
+ *                    starts, in microseconds. Zero turns dropping off.
+ * @param drop        Function receiving the dropped elements, may be NULL.
+ * @param parameter   User-defined parameter passed to the drop function.
+ * @return            0 on success, or a non-zero value if the library was
+ *                    built without PRIORITY_QUEUE_SOJOURN and measures no wait.
+******************************************************************************/
+PRIORITY_QUEUE_API int PriorityQueueSetCodel(priority_queue_t *queue, unsigned long target_us, unsigned long interval_us, priority_queue_drop_func_t drop, void *parameter);
+
+/******************************************************************************
+ * @brief Bounds the number of elements the queue holds, so that its memory
+ * stays predictable under load spikes. An enqueue into a full queue fails with
+ * PRIORITY_QUEUE_FULL or evicts the lowest element, depending on the policy.
+ * Evicting from the heap engine compares the leaves, which takes O(n).
+ *
+ * @param queue     Pointer to the priority queue.
+ * @param capacity  Maximal number of elements, zero for no bound.
+ * @param overflow  What an enqueue into a full queue does.
+ * @param evict     Function receiving the evicted elements, may be NULL. The 
+ *                  handle of an evicted element is no longer valid.
+ * @param parameter User-defined parameter passed to the evict function.
+ * @return          0 on success, or a non-zero value if the queue already holds
+ *                  more than capacity elements.
+******************************************************************************/
+PRIORITY_QUEUE_API int PriorityQueueSetCapacity(priority_queue_t *queue, size_t capacity, priority_queue_overflow_t overflow, priority_queue_drop_func_t evict, void *parameter);
+
+/******************************************************************************
+ * @brief Sets watermarks for backpressure. The watermark function is called 
+ * once when the number of elements rises to high, and once when it falls back 
+ * to low, so a producer can pause and resume before the queue is full. If the 
+ * queue already holds high elements, the function is called at once.
+ *
+ * @param queue     Pointer to the priority queue.
+ * @param high      Size that reports the queue as high, zero turns the 
+ *                  watermarks off.
+ * @param low       Size that reports the queue as drained, lower than high.
+ * @param watermark Function told about the crossings.
+ * @param parameter User-defined parameter passed to the watermark function.
+******************************************************************************/
+PRIORITY_QUEUE_API void PriorityQueueSetWatermarks(priority_queue_t *queue, size_t high, size_t low, priority_queue_watermark_func_t watermark, void *parameter);
+
+/******************************************************************************
+ * @brief Reports the memory footprint of the queue.
+ *
+ * @param queue Pointer to the priority queue.
+ * @param usage Receives the bytes by category.
+ * @note        Walks the list of the sorted list engine, constant otherwise.
+******************************************************************************/
+PRIORITY_QUEUE_API void PriorityQueueMemoryUsage(const priority_queue_t *queue, priority_queue_memory_t *usage);
+
+/******************************************************************************
+ * @brief Sets a batch compare function the heap engines use to compare the 
+ * element sifted down with all the children of a level in one call. A dequeue
+ * makes about a third fewer calls but more comparisons, so it pays off when a
+ * call costs more than a comparison, as with a function vectorizing over keys
+ * behind the pointers, and not for a trivial compare function.
+ *
+ * @param queue Pointer to the priority queue.
+ * @param batch Batch compare function agreeing with the compare function, or
+ *              NULL to compare one pair at a time.
+ * @return      0 if the engine uses it, or a non-zero value for the sorted 
+ *              list and for a library built with PRIORITY_QUEUE_SOJOURN, whose
+ *              engines compare records rather than data.
+******************************************************************************/
+PRIORITY_QUEUE_API int PriorityQueueSetCompareBatch(priority_queue_t *queue, priority_queue_compare_batch_func_t batch);
+
+/******************************************************************************
+ * @brief Creates a selector, which keeps a heap over the heads of the queues
+ * added to it so the queue holding the best head is known without visiting
+ * every queue. The queues update their place themselves whenever their head
+ * may have changed.
+ *
+ * @param compare Comparison function applied to the heads of the queues, 
+ *                normally the one the queues were created with.
+ * @return        Pointer to the selector, or NULL on failure.
+ * @note          complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+PRIORITY_QUEUE_API priority_queue_selector_t *PriorityQueueSelectorCreate(priority_queue_compare_func_t compare);
+
+/******************************************************************************
+ * @brief Destroys a selector. The queues still added to it are released from
+ * it and are otherwise untouched.
+ *
+ * @param selector Pointer to the selector.
+ * @note           complexity   Time: O(n) in the number of queues, Space: O(1)
+******************************************************************************/
+PRIORITY_QUEUE_API void PriorityQueueSelectorDestroy(priority_queue_selector_t *selector);
+
+/******************************************************************************
+ * @brief Adds a queue to a selector. A queue belongs to at most one selector,
+ * and leaves it when removed or destroyed. Every operation that changes the 
+ * queue then also costs O(log n) in the number of queues of the selector, 
+ * O(1) while the head keeps its place.
+ *
+ * @param selector Pointer to the selector.
+ * @param queue    Queue that is not added to any selector.
+ * @return         PRIORITY_QUEUE_SUCCESS or PRIORITY_QUEUE_NO_MEMORY.
+ * @note           complexity   Time: O(log n), Space: O(1)
+******************************************************************************/
+PRIORITY_QUEUE_API priority_queue_status_t PriorityQueueSelectorAdd(priority_queue_selector_t *selector, priority_queue_t *queue);
+
+/******************************************************************************
+ * @brief Removes a queue from the selector it was added to. A queue that is
+ * not added to this selector is left as it is.
+ *
+ * @param selector Pointer to the selector.
+ * @param queue    Queue added to the selector.
+ * @note           complexity   Time: O(log n), Space: O(1)
+******************************************************************************/
+PRIORITY_QUEUE_API void PriorityQueueSelectorRemove(priority_queue_selector_t *selector, priority_queue_t *queue);
+
+/******************************************************************************
+ * @brief Returns the queue whose head has the highest priority among the 
+ * queues of the selector.
+ *
+ * @param selector Pointer to the selector.
+ * @return         The queue, or NULL if every queue is empty or none is added.
+ * @note           complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+PRIORITY_QUEUE_API priority_queue_t *PriorityQueueSelectorPeek(const priority_queue_selector_t *selector);
+
+/******************************************************************************
+ * @brief Compares keys stored in the data pointers as size_t, the larger key
+ * is dequeued first. Branch-free and never overflows.
+ *
+ * @param data     Existing key, cast to a pointer.
+ * @param new_data New key, cast to a pointer.
+ * @return         1, -1 or 0 as described by priority_queue_compare_func_t.
+******************************************************************************/
+PRIORITY_QUEUE_API int PriorityQueueCompareSize(void *data, void *new_data);
+
+/******************************************************************************
+ * @brief Compares signed keys stored in the data pointers as long, the larger
+ * key is dequeued first. Branch-free and never overflows.
+ *
+ * @param data     Existing key, cast to a pointer.
+ * @param new_data New key, cast to a pointer.
+ * @return         1, -1 or 0 as described by priority_queue_compare_func_t.
+******************************************************************************/
+PRIORITY_QUEUE_API int PriorityQueueCompareLong(void *data, void *new_data);
+
+/******************************************************************************
+ * @brief Compares the ints the data points to, the larger int is dequeued
+ * first. Branch-free and never overflows.
+ *
+ * @param data     Pointer to the existing int.
+ * @param new_data Pointer to the new int.
+ * @return         1, -1 or 0 as described by priority_queue_compare_func_t.
+******************************************************************************/
+PRIORITY_QUEUE_API int PriorityQueueCompareInt(void *data, void *new_data);
+
+/******************************************************************************
+ * @brief Compares the doubles the data points to, the larger double is 
+ * dequeued first. Branch-free.
+ *
+ * @param data     Pointer to the existing double.
+ * @param new_data Pointer to the new double.
+ * @return         1, -1 or 0 as described by priority_queue_compare_func_t.
+ * @note           NaN compares equal to everything, which is not transitive,
+ *                 so NaN must not be enqueued.
+******************************************************************************/
+PRIORITY_QUEUE_API int PriorityQueueCompareDouble(void *data, void *new_data);
+
+/******************************************************************************
+ * @brief Checks that a compare function is a consistent order over a sample of
+ * data: every element compares equal to itself, swapping the arguments negates
+ * the sign, and the order is transitive over every triple. Built with 
+ * PRIORITY_QUEUE_CHECK_COMPARE defined, every enqueue asserts this check over 
+ * the new data and a few queued elements.
+ *
+ * @param compare Comparison function to check.
+ * @param data    Sample of data elements.
+ * @param count   Number of elements in the sample.
+ * @return        Number of violations found, 0 if none.
+ * @note          complexity   Time: O(count^3), Space: O(1)
+******************************************************************************/
+PRIORITY_QUEUE_API size_t PriorityQueueCheckCompare(priority_queue_compare_func_t compare, void **data, size_t count);
 
 #endif /* __PRIORITY_QUEUE_H__ */
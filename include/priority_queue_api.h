@@ -0,0 +1,26 @@
+/******************************************************************************
+ * @writer:      Tal Aharon
+ * @date:        19.10.2026
+ *
+ * @description: This header file defines the marker of the exported library
+ * API, shared by every public header of the library so the libraries export
+ * the same set of functions whichever header declares them.
+ *
+******************************************************************************/
+#ifndef __PRIORITY_QUEUE_API_H__
+#define __PRIORITY_QUEUE_API_H__
+
+/******************************************************************************
+ * @brief Marks a function as part of the exported library API. The libraries
+ * are built with -fvisibility=hidden, so everything not marked this way, such
+ * as the sorted list, dll, heap and segmented array, stays internal to them.
+******************************************************************************/
+#ifndef PRIORITY_QUEUE_API
+#if defined(__GNUC__) && 4 <= __GNUC__
+#define PRIORITY_QUEUE_API __attribute__((visibility("default")))
+#else
+#define PRIORITY_QUEUE_API
+#endif
+#endif
+
+#endif /* __PRIORITY_QUEUE_API_H__ */
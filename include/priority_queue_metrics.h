@@ -0,0 +1,109 @@
+/******************************************************************************
+ * @writer:      Tal Aharon
+ * @date:        19.10.2026
+ *
+ * @description: This header file defines the interface of the metrics exporter
+ * for priority queues. Queues are registered under a name and rendered on
+ * demand in the Prometheus text exposition format: depth, enqueued, dequeued,
+ * dropped, evicted and rejected totals, comparator calls and a time in queue
+ * histogram.
+ *
+ * A registration is a source owned by the thread that owns the queue. The
+ * owner records into the source without any locking and publishes it from time
+ * to time, which takes the lock of that source once. Rendering only reads the
+ * published values, so scraping never touches a queue and never blocks the
+ * queue operations. Sources registered under the same name are summed, so a
+ * queue per worker thread is exported as a single series.
+ *
+ * Detailed function descriptions and usage guidelines can be found in the
+ * comments within this header file.
+ *
+******************************************************************************/
+#ifndef __PRIORITY_QUEUE_METRICS_H__
+#define __PRIORITY_QUEUE_METRICS_H__
+
+#include <stddef.h>         /* size_t, NULL */
+#include "priority_queue.h" /* Internal API */
+
+#define PRIORITY_QUEUE_METRICS_NAME_LENGTH (64)
+
+typedef struct priority_queue_metrics priority_queue_metrics_t;
+
+typedef struct priority_queue_metrics_source priority_queue_metrics_source_t;
+
+/******************************************************************************
+ * @brief Creates an empty metrics registry.
+ *
+ * @return Pointer to the registry, or NULL on failure.
+ * @note   complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+PRIORITY_QUEUE_API priority_queue_metrics_t *PriorityQueueMetricsCreate(void);
+
+/******************************************************************************
+ * @brief Destroys a registry together with every source still registered.
+ *        The queues themselves are not touched.
+ *
+ * @param metrics Pointer to the registry.
+ * @note          complexity   Time: O(n), Space: O(1)
+******************************************************************************/
+PRIORITY_QUEUE_API void PriorityQueueMetricsDestroy(priority_queue_metrics_t *metrics);
+
+/******************************************************************************
+ * @brief Registers a queue under a name.
+ *
+ * @param metrics Pointer to the registry.
+ * @param queue   Queue the source publishes, it must outlive the source.
+ * @param name    Label value of the series, at most
+ *                PRIORITY_QUEUE_METRICS_NAME_LENGTH characters.
+ * @return        Pointer to the source, or NULL on failure.
+ * @note          complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+PRIORITY_QUEUE_API priority_queue_metrics_source_t *PriorityQueueMetricsRegister(priority_queue_metrics_t *metrics, const priority_queue_t *queue, const char *name);
+
+/******************************************************************************
+ * @brief Removes a source from the registry and frees it. What it published
+ *        is no longer rendered.
+ *
+ * @param metrics Pointer to the registry.
+ * @param source  Source returned by PriorityQueueMetricsRegister.
+ * @note          complexity   Time: O(n), Space: O(1)
+******************************************************************************/
+PRIORITY_QUEUE_API void PriorityQueueMetricsUnregister(priority_queue_metrics_t *metrics, priority_queue_metrics_source_t *source);
+
+/******************************************************************************
+ * @brief Records how long a dequeued element spent in the queue. Only the
+ *        thread owning the source may call it; nothing is locked. A library
+ *        built with PRIORITY_QUEUE_SOJOURN ignores it and publishes the time
+ *        in queue it measured itself.
+ *
+ * @param source  Pointer to the source.
+ * @param seconds Time between the enqueue and the dequeue of the element.
+ * @note          complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+PRIORITY_QUEUE_API void PriorityQueueMetricsObserveSojourn(priority_queue_metrics_source_t *source, double seconds);
+
+/******************************************************************************
+ * @brief Makes the current state of the queue and the recorded time in queue
+ *        visible to PriorityQueueMetricsRender. Only the thread owning the
+ *        source may call it.
+ *
+ * @param source Pointer to the source.
+ * @note         complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+PRIORITY_QUEUE_API void PriorityQueueMetricsPublish(priority_queue_metrics_source_t *source);
+
+/******************************************************************************
+ * @brief Renders what every source has published in the Prometheus text
+ *        exposition format. May be called from any thread.
+ *
+ * @param metrics Pointer to the registry.
+ * @param buffer  Receives the text, always terminated when size is not zero.
+ * @param size    Size of the buffer in bytes.
+ * @return        Length of the full text without the terminator. A value of
+ *                size or more means the text was truncated.
+ * @note          complexity   Time: O(n^2) in the number of sources,
+ *                             Space: O(n)
+******************************************************************************/
+PRIORITY_QUEUE_API size_t PriorityQueueMetricsRender(priority_queue_metrics_t *metrics, char *buffer, size_t size);
+
+#endif /* __PRIORITY_QUEUE_METRICS_H__ */
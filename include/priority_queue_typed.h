@@ -0,0 +1,238 @@
+/******************************************************************************
+ * @writer:      Tal Aharon
+ * @date:        19.10.2026
+ *
+ * @description: This header file generates priority queues typed for an
+ * element type chosen by the user. Elements are stored by value in one array
+ * and compared by an expression expanded into the sift loops, so there is no
+ * cast through void *, no callback and no per element allocation, and the
+ * compiler sees the key type of every comparison.
+ *
+ * A queue type is generated in two parts, like any other C interface:
+ *
+ *   PRIORITY_QUEUE_TYPED_DECLARE(name, type)
+ *       in a header, declares name_t and the functions below.
+ *
+ *   PRIORITY_QUEUE_TYPED_DEFINE(name, type, higher)
+ *       in exactly one source file, defines them. higher(a, b) is a macro or
+ *       function taking two elements by value and returning non-zero when a
+ *       has to be dequeued before b. It may evaluate its arguments more than
+ *       once.
+ *
+ * For example, a queue of longs dequeuing the largest first:
+ *
+ *   #define LONG_HIGHER(a, b) ((a) > (b))
+ *   PRIORITY_QUEUE_TYPED_DECLARE(LongQueue, long)
+ *   PRIORITY_QUEUE_TYPED_DEFINE(LongQueue, long, LONG_HIGHER)
+ *
+ * generates LongQueue_t, LongQueueCreate, LongQueueEnqueue and so on. A void *
+ * queue is one more instantiation, with higher calling a compare function.
+ *
+ * The generated functions behave as their priority queue counterparts:
+ *
+ *   name_t *nameCreate(void)
+ *   void nameDestroy(name_t *queue)
+ *   priority_queue_status_t nameReserve(name_t *queue, size_t capacity)
+ *   priority_queue_status_t nameEnqueue(name_t *queue, type value)
+ *   priority_queue_status_t nameDequeue(name_t *queue, type *value)
+ *   priority_queue_status_t namePeek(const name_t *queue, type *value)
+ *   size_t nameSize(const name_t *queue)
+ *   int nameIsEmpty(const name_t *queue)
+ *   void nameClear(name_t *queue)
+ *
+ * Enqueue and dequeue take O(log n), growth doubles the array and copies it,
+ * so enqueue is amortized. The order of elements of equal priority is
+ * unspecified. The generated code is ANSI C and only depends on the C library.
+ *
+******************************************************************************/
+#ifndef __PRIORITY_QUEUE_TYPED_H__
+#define __PRIORITY_QUEUE_TYPED_H__
+
+#include <assert.h>         /* assert                 */
+#include <stdlib.h>         /* malloc, realloc, free  */
+#include "priority_queue.h" /* priority_queue_status_t */
+
+#define PRIORITY_QUEUE_TYPED_MIN_CAPACITY (16)
+
+/******************************************************************************
+ * @brief Declares the queue type name_t and its functions.
+ *
+ * @param name Prefix of the generated type and functions.
+ * @param type Element type, stored by value.
+******************************************************************************/
+#define PRIORITY_QUEUE_TYPED_DECLARE(name, type)                               \
+	typedef struct name name##_t;                                              \
+	name##_t *name##Create(void);                                              \
+	void name##Destroy(name##_t *queue);                                       \
+	priority_queue_status_t name##Reserve(name##_t *queue, size_t capacity);   \
+	priority_queue_status_t name##Enqueue(name##_t *queue, type value);        \
+	priority_queue_status_t name##Dequeue(name##_t *queue, type *value);       \
+	priority_queue_status_t name##Peek(const name##_t *queue, type *value);    \
+	size_t name##Size(const name##_t *queue);                                  \
+	int name##IsEmpty(const name##_t *queue);                                  \
+	void name##Clear(name##_t *queue);
+
+/******************************************************************************
+ * @brief Defines the functions declared by PRIORITY_QUEUE_TYPED_DECLARE. The
+ * sifts move a hole instead of swapping elements, so every level costs one
+ * comparison on the way up, two on the way down and a single copy.
+ *
+ * @param name   Prefix of the generated type and functions.
+ * @param type   Element type, stored by value.
+ * @param higher Expression higher(a, b), non-zero when a comes out first.
+******************************************************************************/
+#define PRIORITY_QUEUE_TYPED_DEFINE(name, type, higher)                        \
+	struct name                                                                \
+	{                                                                          \
+		type *elements;                                                        \
+		size_t size;                                                           \
+		size_t capacity;                                                       \
+	};                                                                         \
+                                                                               \
+	name##_t *name##Create(void)                                               \
+	{                                                                          \
+		name##_t *queue = (name##_t *)malloc(sizeof(name##_t));                \
+		if(NULL == queue)                                                      \
+		{                                                                      \
+			return NULL;                                                       \
+		}                                                                      \
+                                                                               \
+		queue -> elements = NULL;                                              \
+		queue -> size = 0;                                                     \
+		queue -> capacity = 0;                                                 \
+		return queue;                                                          \
+	}                                                                          \
+                                                                               \
+	void name##Destroy(name##_t *queue)                                        \
+	{                                                                          \
+		assert(queue && "Queue is not valid");                                 \
+		free(queue -> elements);                                               \
+		free(queue);                                                           \
+	}                                                                          \
+                                                                               \
+	priority_queue_status_t name##Reserve(name##_t *queue, size_t capacity)    \
+	{                                                                          \
+		type *elements = NULL;                                                 \
+		assert(queue && "Queue is not valid");                                 \
+		if(capacity <= queue -> capacity)                                      \
+		{                                                                      \
+			return PRIORITY_QUEUE_SUCCESS;                                     \
+		}                                                                      \
+                                                                               \
+		elements = (type *)realloc(queue -> elements, capacity * sizeof(type)); \
+		if(NULL == elements)                                                   \
+		{                                                                      \
+			return PRIORITY_QUEUE_NO_MEMORY;                                   \
+		}                                                                      \
+                                                                               \
+		queue -> elements = elements;                                          \
+		queue -> capacity = capacity;                                          \
+		return PRIORITY_QUEUE_SUCCESS;                                         \
+	}                                                                          \
+                                                                               \
+	priority_queue_status_t name##Enqueue(name##_t *queue, type value)         \
+	{                                                                          \
+		size_t hole = 0;                                                       \
+		size_t parent = 0;                                                     \
+		type *elements = NULL;                                                 \
+		assert(queue && "Queue is not valid");                                 \
+                                                                               \
+		if(queue -> size == queue -> capacity &&                               \
+		   name##Reserve(queue, queue -> capacity < PRIORITY_QUEUE_TYPED_MIN_CAPACITY ? \
+		                 PRIORITY_QUEUE_TYPED_MIN_CAPACITY : 2 * queue -> capacity)) \
+		{                                                                      \
+			return PRIORITY_QUEUE_NO_MEMORY;                                   \
+		}                                                                      \
+                                                                               \
+		elements = queue -> elements;                                          \
+		hole = queue -> size++;                                                \
+		while(0 < hole)                                                        \
+		{                                                                      \
+			parent = (hole - 1) / 2;                                           \
+			if(!(higher(value, elements[parent])))                             \
+			{                                                                  \
+				break;                                                         \
+			}                                                                  \
+                                                                               \
+			elements[hole] = elements[parent];                                 \
+			hole = parent;                                                     \
+		}                                                                      \
+                                                                               \
+		elements[hole] = value;                                                \
+		return PRIORITY_QUEUE_SUCCESS;                                         \
+	}                                                                          \
+                                                                               \
+	priority_queue_status_t name##Dequeue(name##_t *queue, type *value)        \
+	{                                                                          \
+		size_t hole = 0;                                                       \
+		size_t child = 0;                                                      \
+		size_t size = 0;                                                       \
+		type last;                                                             \
+		type *elements = NULL;                                                 \
+		assert(queue && "Queue is not valid");                                 \
+                                                                               \
+		if(0 == queue -> size)                                                 \
+		{                                                                      \
+			return PRIORITY_QUEUE_EMPTY;                                       \
+		}                                                                      \
+                                                                               \
+		elements = queue -> elements;                                          \
+		if(NULL != value)                                                      \
+		{                                                                      \
+			*value = elements[0];                                              \
+		}                                                                      \
+                                                                               \
+		size = --queue -> size;                                                \
+		last = elements[size];                                                 \
+		while((child = 2 * hole + 1) < size)                                   \
+		{                                                                      \
+			if(child + 1 < size && higher(elements[child + 1], elements[child])) \
+			{                                                                  \
+				++child;                                                       \
+			}                                                                  \
+                                                                               \
+			if(!(higher(elements[child], last)))                               \
+			{                                                                  \
+				break;                                                         \
+			}                                                                  \
+                                                                               \
+			elements[hole] = elements[child];                                  \
+			hole = child;                                                      \
+		}                                                                      \
+                                                                               \
+		elements[hole] = last;                                                 \
+		return PRIORITY_QUEUE_SUCCESS;                                         \
+	}                                                                          \
+                                                                               \
+	priority_queue_status_t name##Peek(const name##_t *queue, type *value)     \
+	{                                                                          \
+		assert(queue && "Queue is not valid");                                 \
+		assert(value && "Value is not valid");                                 \
+		if(0 == queue -> size)                                                 \
+		{                                                                      \
+			return PRIORITY_QUEUE_EMPTY;                                       \
+		}                                                                      \
+                                                                               \
+		*value = queue -> elements[0];                                         \
+		return PRIORITY_QUEUE_SUCCESS;                                         \
+	}                                                                          \
+                                                                               \
+	size_t name##Size(const name##_t *queue)                                   \
+	{                                                                          \
+		assert(queue && "Queue is not valid");                                 \
+		return queue -> size;                                                  \
+	}                                                                          \
+                                                                               \
+	int name##IsEmpty(const name##_t *queue)                                   \
+	{                                                                          \
+		assert(queue && "Queue is not valid");                                 \
+		return 0 == queue -> size;                                             \
+	}                                                                          \
+                                                                               \
+	void name##Clear(name##_t *queue)                                          \
+	{                                                                          \
+		assert(queue && "Queue is not valid");                                 \
+		queue -> size = 0;                                                     \
+	}
+
+#endif /* __PRIORITY_QUEUE_TYPED_H__ */
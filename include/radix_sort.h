@@ -0,0 +1,40 @@
+/******************************************************************************
+ * @writer:      Tal Aharon
+ * @date:        19.10.2026
+ *
+ * @description: This header file defines the interface for a least significant
+ * digit radix sort of data by unsigned integer keys, used to order a batch
+ * before it enters a keyed queue. The sort is stable, so data of equal key
+ * keeps the order of the batch, and it never compares: it takes O(n) per byte
+ * of the largest key.
+ *
+ * Detailed function descriptions and usage guidelines can be found in the
+ * comments within this header file.
+ *
+******************************************************************************/
+#ifndef __RADIX_SORT_H__
+#define __RADIX_SORT_H__
+
+#include <stddef.h> /*size_t, NULL */
+
+/* A key and its data move as one record, so a pass writes a single stream per digit */
+typedef struct radix_sort_item
+{
+	unsigned long key;
+	void *data;
+
+} radix_sort_item_t;
+
+/******************************************************************************
+ * @brief       Sorts items by key in ascending order. Items of equal key keep
+ *              their relative order.
+ * @param items Array of count items.
+ * @param count Number of items.
+ * @return      0 on success, or a non-zero value if the scratch buffer could
+ *              not be allocated, in which case the array is unchanged.
+ * @note        Time Complexity: O(n) per byte of the largest key, bytes that
+ *              all keys share are skipped. Space: O(n)
+******************************************************************************/
+int RadixSort(radix_sort_item_t *items, size_t count);
+
+#endif /* __RADIX_SORT_H__ */
@@ -0,0 +1,119 @@
+/******************************************************************************
+ * @writer:      Tal Aharon
+ * @date:        19.10.2026
+ *
+ * @description: This header file defines the interface for a reference queue,
+ * a priority queue whose elements are stored by value as (key, offset) pairs.
+ * The offset locates the payload inside a buffer managed by the caller, such as
+ * a memory mapped file or a shared memory segment, so payloads are never copied
+ * and the queue never holds a pointer that is only meaningful in one process.
+ *
+ * The entry with the highest key is dequeued first. By default keys are longs
+ * and offsets are unsigned longs. Building with REF_QUEUE_COMPACT defined makes
+ * both 32 bits wide, halving the size of an entry; every translation unit and
+ * every process sharing entries must agree on that setting. That includes the
+ * library: a program built with REF_QUEUE_COMPACT must link a static or shared
+ * library built with it too, otherwise the two disagree on the layout of every
+ * entry without any error at link time. make compact runs the tests that way.
+ *
+ * Detailed function descriptions and usage guidelines can be found in the
+ * comments within this header file.
+ *
+******************************************************************************/
+#ifndef __REF_QUEUE_H__
+#define __REF_QUEUE_H__
+
+#include <stddef.h>             /*size_t, NULL */
+#include "priority_queue_api.h" /* PRIORITY_QUEUE_API */
+
+#ifdef REF_QUEUE_COMPACT
+typedef int ref_queue_key_t;
+typedef unsigned int ref_queue_offset_t;
+#else
+typedef long ref_queue_key_t;
+typedef unsigned long ref_queue_offset_t;
+#endif
+
+typedef struct ref_queue_ref
+{
+	ref_queue_key_t key;
+	ref_queue_offset_t offset;
+
+} ref_queue_ref_t;
+
+typedef struct ref_queue ref_queue_t;
+
+/******************************************************************************
+ * @brief  Resolves a reference into the address of its payload.
+ * @param  base Start of the buffer the offsets are relative to.
+ * @param  ref  Reference to resolve.
+ * @return Address of the payload in the calling process.
+******************************************************************************/
+#define REF_QUEUE_RESOLVE(base, ref) ((void *)((char *)(base) + (ref).offset))
+
+/******************************************************************************
+ * @brief  Creates a new, empty reference queue.
+ * @return Pointer to the created queue, or NULL if creation fails.
+ * @note   Time Complexity: O(1)
+******************************************************************************/
+PRIORITY_QUEUE_API ref_queue_t *RefQueueCreate(void);
+
+/******************************************************************************
+ * @brief       Destroys a reference queue. Payloads are not touched.
+ * @param queue Pointer to the queue to be destroyed.
+ * @note        Time Complexity: O(log n)
+******************************************************************************/
+PRIORITY_QUEUE_API void RefQueueDestroy(ref_queue_t *queue);
+
+/******************************************************************************
+ * @brief        Adds a reference to the queue.
+ * @param queue  Pointer to the queue.
+ * @param key    Priority of the reference, higher keys are dequeued first.
+ * @param offset Offset of the payload in the caller's buffer.
+ * @return       0 on success, or a non-zero value if storage could not grow.
+ * @note         Time Complexity: O(log n), growth never copies entries.
+******************************************************************************/
+PRIORITY_QUEUE_API int RefQueueEnqueue(ref_queue_t *queue, ref_queue_key_t key, ref_queue_offset_t offset);
+
+/******************************************************************************
+ * @brief       Removes the reference with the highest key.
+ * @param queue Pointer to the queue.
+ * @param ref   Receives the removed reference. May be NULL.
+ * @return      0 on success, or a non-zero value if the queue is empty.
+ * @note        Time Complexity: O(log n)
+******************************************************************************/
+PRIORITY_QUEUE_API int RefQueueDequeue(ref_queue_t *queue, ref_queue_ref_t *ref);
+
+/******************************************************************************
+ * @brief       Copies the reference with the highest key without removing it.
+ * @param queue Pointer to the queue.
+ * @param ref   Receives the reference.
+ * @return      0 on success, or a non-zero value if the queue is empty.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+PRIORITY_QUEUE_API int RefQueuePeek(const ref_queue_t *queue, ref_queue_ref_t *ref);
+
+/******************************************************************************
+ * @brief       Returns the number of references in the queue.
+ * @param queue Pointer to the queue.
+ * @return      Number of references in the queue.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+PRIORITY_QUEUE_API size_t RefQueueSize(const ref_queue_t *queue);
+
+/******************************************************************************
+ * @brief       Checks if the queue is empty.
+ * @param queue Pointer to the queue.
+ * @return      Non-zero value if empty, 0 if not empty.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+PRIORITY_QUEUE_API int RefQueueIsEmpty(const ref_queue_t *queue);
+
+/******************************************************************************
+ * @brief       Removes all references from the queue.
+ * @param queue Pointer to the queue.
+ * @note        Time Complexity: O(log n)
+******************************************************************************/
+PRIORITY_QUEUE_API void RefQueueClear(ref_queue_t *queue);
+
+#endif /* __REF_QUEUE_H__ */
@@ -0,0 +1,89 @@
+/******************************************************************************
+ * @writer:      Tal Aharon
+ * @date:        18.10.2026
+ *
+ * @description: This header file defines the interface for a segmented array.
+ * A segmented array addresses its elements by index like an ordinary array, but
+ * keeps them in a list of chunks where chunk k is twice as large as chunk k - 1.
+ * Growing the array adds a chunk and never moves existing elements, so the
+ * address of an element stays valid for as long as the array holds its slot.
+ *
+ * The array only manages storage; it does not track how many of its slots are
+ * in use. Callers reserve slots before writing them and trim the array once
+ * they stop using the topmost slots.
+ *
+ * Detailed function descriptions and usage guidelines can be found in the
+ * comments within this header file.
+ *
+******************************************************************************/
+#ifndef __SEGMENTED_ARRAY_H__
+#define __SEGMENTED_ARRAY_H__
+
+#include <stddef.h> /*size_t, NULL */
+
+typedef struct segmented_array segmented_array_t;
+
+/******************************************************************************
+ * @brief              Creates a new, empty segmented array.
+ * @param element_size Size in bytes of a single element.
+ * @return             Pointer to the created array, or NULL if creation fails.
+ * @note               Time Complexity: O(1)
+******************************************************************************/
+segmented_array_t *SegmentedArrayCreate(size_t element_size);
+
+/******************************************************************************
+ * @brief       Destroys a segmented array and all of its chunks.
+ * @param array Pointer to the array to be destroyed.
+ * @note        Time Complexity: O(log n)
+******************************************************************************/
+void SegmentedArrayDestroy(segmented_array_t *array);
+
+/******************************************************************************
+ * @brief       Returns the address of the element at the given index.
+ * @param array Pointer to the array.
+ * @param index Index smaller than SegmentedArrayCapacity(array).
+ * @return      Address of the element. Stays valid until the chunk holding it
+ *              is trimmed or the array is destroyed.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+void *SegmentedArrayAt(const segmented_array_t *array, size_t index);
+
+/******************************************************************************
+ * @brief       Returns the number of elements the array can hold right now.
+ * @param array Pointer to the array.
+ * @return      Number of addressable elements.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+size_t SegmentedArrayCapacity(const segmented_array_t *array);
+
+/******************************************************************************
+ * @brief       Makes sure that at least count elements are addressable.
+ * @param array Pointer to the array.
+ * @param count Number of elements that must be addressable.
+ * @return      0 on success, or a non-zero value if allocation fails.
+ * @note        Time Complexity: O(1) per added chunk. Reserving one element
+ *              past the capacity adds exactly one chunk and copies nothing.
+******************************************************************************/
+int SegmentedArrayReserve(segmented_array_t *array, size_t count);
+
+/******************************************************************************
+ * @brief        Returns the bytes the array has requested from malloc, the
+ *               directory included.
+ * @param array  Pointer to the array.
+ * @param blocks Receives the number of malloc blocks the bytes are spread on.
+ * @return       Number of bytes.
+ * @note         Time Complexity: O(1)
+******************************************************************************/
+size_t SegmentedArrayMemoryUsage(const segmented_array_t *array, size_t *blocks);
+
+/******************************************************************************
+ * @brief       Releases chunks that are no longer needed to hold count elements.
+ *              One spare chunk is always kept above the used ones so callers
+ *              that grow and shrink around a chunk border do not thrash.
+ * @param array Pointer to the array.
+ * @param count Number of elements still in use.
+ * @note        Time Complexity: O(1) per released chunk.
+******************************************************************************/
+void SegmentedArrayTrim(segmented_array_t *array, size_t count);
+
+#endif /* __SEGMENTED_ARRAY_H__ */
@@ -0,0 +1,159 @@
+/******************************************************************************
+ * @writer:      Tal Aharon
+ * @date:        18.10.2026
+ *
+ * @description: This header file defines the interface for a priority queue
+ * that lives entirely inside a POSIX shared memory segment, so that several
+ * local processes can enqueue and dequeue through it directly.
+ *
+ * The segment holds a header followed by a fixed-capacity binary heap of
+ * entries. Nothing inside the segment is a pointer: entries are found by index
+ * relative to the segment, so every process may map it at a different address.
+ * Access is serialized by a process-shared robust mutex kept in the header; an
+ * uncontended lock or unlock is a single atomic operation and does not enter
+ * the kernel. Producers may wait for room on a process-shared condition
+ * variable kept next to it. If a process dies while holding the lock, the next process to
+ * take it finishes the interrupted operation and restores heap order.
+ *
+ * Entries are reference queue entries: a key and the offset of a payload that
+ * lives elsewhere in shared memory, resolved by each process against its own
+ * mapping with REF_QUEUE_RESOLVE. The entry with the highest key is dequeued
+ * first. Payloads are never copied into or out of the queue.
+ *
+ * Detailed function descriptions and usage guidelines can be found in the
+ * comments within this header file.
+ *
+******************************************************************************/
+#ifndef __SHM_PRIORITY_QUEUE_H__
+#define __SHM_PRIORITY_QUEUE_H__
+
+#include <stddef.h>    /*size_t, NULL */
+#include "ref_queue.h" /*Internal API */
+
+typedef struct shm_priority_queue shm_priority_queue_t;
+
+typedef ref_queue_ref_t shm_priority_queue_entry_t;
+
+/******************************************************************************
+ * @typedef Status codes returned by the shared memory queue operations.
+******************************************************************************/
+typedef enum shm_priority_queue_status
+{
+	SHM_PRIORITY_QUEUE_SUCCESS = 0,
+	SHM_PRIORITY_QUEUE_EMPTY,
+	SHM_PRIORITY_QUEUE_FULL,
+	SHM_PRIORITY_QUEUE_ERROR
+
+} shm_priority_queue_status_t;
+
+/******************************************************************************
+ * @brief Creates a new shared memory segment holding an empty queue and maps
+ * it into the calling process. Fails if a segment with that name exists.
+ *
+ * @param name     Name of the segment, in shm_open format ("/name").
+ * @param capacity Maximal number of entries the queue can hold.
+ * @return         Pointer to the process-local queue object, or NULL on failure.
+ * @note           complexity   Time: O(1), Space: O(capacity)
+******************************************************************************/
+PRIORITY_QUEUE_API shm_priority_queue_t *ShmPriorityQueueCreate(const char *name, size_t capacity);
+
+/******************************************************************************
+ * @brief Maps an existing queue segment, created by any process, into the
+ * calling process.
+ *
+ * @param name Name of the segment, in shm_open format ("/name").
+ * @return     Pointer to the process-local queue object, or NULL on failure.
+ * @note       complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+PRIORITY_QUEUE_API shm_priority_queue_t *ShmPriorityQueueOpen(const char *name);
+
+/******************************************************************************
+ * @brief Unmaps the queue from the calling process. The segment and its
+ * entries remain available to other processes.
+ *
+ * @param queue Pointer to the queue object.
+ * @note        complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+PRIORITY_QUEUE_API void ShmPriorityQueueClose(shm_priority_queue_t *queue);
+
+/******************************************************************************
+ * @brief Removes the segment name. The memory is released once every process
+ * has closed the queue.
+ *
+ * @param name Name of the segment.
+ * @return     0 on success, or a non-zero value on failure.
+******************************************************************************/
+PRIORITY_QUEUE_API int ShmPriorityQueueUnlink(const char *name);
+
+/******************************************************************************
+ * @brief Adds an entry to the queue.
+ *
+ * @param queue  Pointer to the queue object.
+ * @param key    Priority of the entry, higher keys are dequeued first.
+ * @param offset Offset of the payload in the shared memory holding it.
+ * @return       SHM_PRIORITY_QUEUE_SUCCESS, SHM_PRIORITY_QUEUE_FULL, or
+ *               SHM_PRIORITY_QUEUE_ERROR if the lock could not be taken.
+ * @note         complexity   Time: O(log n), Space: O(1)
+******************************************************************************/
+PRIORITY_QUEUE_API shm_priority_queue_status_t ShmPriorityQueueEnqueue(shm_priority_queue_t *queue, ref_queue_key_t key, ref_queue_offset_t offset);
+
+/******************************************************************************
+ * @brief Adds an entry to the queue, waiting for a dequeue in any process to
+ * make room while the queue is full. This is the blocking backpressure policy:
+ * a producer is slowed down to the pace of the consumers instead of failing.
+ * Waiting sleeps in the kernel; a dequeue only wakes a waiter if there is one.
+ *
+ * @param queue      Pointer to the queue object.
+ * @param key        Priority of the entry, higher keys are dequeued first.
+ * @param offset     Offset of the payload in the shared memory holding it.
+ * @param timeout_us Longest time to wait for room, in microseconds. Zero
+ *                   behaves like ShmPriorityQueueEnqueue.
+ * @return           SHM_PRIORITY_QUEUE_SUCCESS, SHM_PRIORITY_QUEUE_FULL if the
+ *                   queue was still full when the time ran out, or
+ *                   SHM_PRIORITY_QUEUE_ERROR if the lock could not be taken.
+ * @note             complexity   Time: O(log n) besides the wait, Space: O(1)
+******************************************************************************/
+PRIORITY_QUEUE_API shm_priority_queue_status_t ShmPriorityQueueEnqueueTimed(shm_priority_queue_t *queue, ref_queue_key_t key, ref_queue_offset_t offset, unsigned long timeout_us);
+
+/******************************************************************************
+ * @brief Removes the entry with the highest key from the queue.
+ *
+ * @param queue Pointer to the queue object.
+ * @param entry Receives the removed entry. May be NULL.
+ * @return      SHM_PRIORITY_QUEUE_SUCCESS, SHM_PRIORITY_QUEUE_EMPTY, or
+ *              SHM_PRIORITY_QUEUE_ERROR if the lock could not be taken.
+ * @note        complexity   Time: O(log n), Space: O(1)
+******************************************************************************/
+PRIORITY_QUEUE_API shm_priority_queue_status_t ShmPriorityQueueDequeue(shm_priority_queue_t *queue, shm_priority_queue_entry_t *entry);
+
+/******************************************************************************
+ * @brief Copies the entry with the highest key without removing it.
+ *
+ * @param queue Pointer to the queue object.
+ * @param entry Receives the entry.
+ * @return      SHM_PRIORITY_QUEUE_SUCCESS, SHM_PRIORITY_QUEUE_EMPTY, or
+ *              SHM_PRIORITY_QUEUE_ERROR if the lock could not be taken.
+ * @note        complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+PRIORITY_QUEUE_API shm_priority_queue_status_t ShmPriorityQueuePeek(shm_priority_queue_t *queue, shm_priority_queue_entry_t *entry);
+
+/******************************************************************************
+ * @brief Returns the number of entries in the queue. The value may be stale by
+ * the time it is used if other processes access the queue concurrently.
+ *
+ * @param queue Pointer to the queue object.
+ * @return      Number of entries in the queue.
+ * @note        complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+PRIORITY_QUEUE_API size_t ShmPriorityQueueSize(const shm_priority_queue_t *queue);
+
+/******************************************************************************
+ * @brief Returns the number of entries the queue can hold.
+ *
+ * @param queue Pointer to the queue object.
+ * @return      Capacity of the queue.
+ * @note        complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+PRIORITY_QUEUE_API size_t ShmPriorityQueueCapacity(const shm_priority_queue_t *queue);
+
+#endif /* __SHM_PRIORITY_QUEUE_H__ */
@@ -85,6 +85,25 @@ void SortedListDestroy(sorted_list_t *sorted_list);
 ******************************************************************************/
 size_t SortedListCount(const sorted_list_t *sorted_list);
 
+/******************************************************************************
+ * @brief             Returns the number of comparisons the sorted list has made
+ *                    since its creation.
+ * @param sorted_list Pointer to the sorted list.
+ * @return            Number of calls to the compare function.
+ * @note              Time Complexity: O(1)
+******************************************************************************/
+size_t SortedListComparisons(const sorted_list_t *sorted_list);
+
+/******************************************************************************
+ * @brief             Returns the bytes the sorted list has requested from malloc.
+ * @param sorted_list Pointer to the sorted list.
+ * @param nodes       Receives the bytes of the nodes holding data.
+ * @param blocks      Receives the number of malloc blocks the bytes are spread on.
+ * @return            Number of bytes, the list itself included.
+ * @note              Time Complexity: O(n)
+******************************************************************************/
+size_t SortedListMemoryUsage(const sorted_list_t *sorted_list, size_t *nodes, size_t *blocks);
+
 /******************************************************************************
  * @brief             Returns an iterator pointing to the start of the sorted list.
  * @param sorted_list Pointer to the sorted list.
@@ -196,7 +215,8 @@ void SortedListMerge(sorted_list_t *dest, sorted_list_t *source);
  * @brief           Finds the iterator to a position with comparable data to 
  *                  the parameter.
  * 
- * @param list      Pointer to the sorted list.
+ * @param list      Pointer to the sorted list, its comparison count grows by
+ *                  the comparisons made.
  * @param from      Starting iterator.
  * @param to        Iterator pointing to the end of the range (not included).
  * @param parameter Pointer to the parameter used for comparison.
@@ -205,7 +225,7 @@ void SortedListMerge(sorted_list_t *dest, sorted_list_t *source);
  *
  * @note            Time Complexity: O(n)
 ******************************************************************************/
-sorted_list_iter_t SortedListFind(const sorted_list_t *list, const sorted_list_iter_t from, const sorted_list_iter_t to, void *parameter);
+sorted_list_iter_t SortedListFind(sorted_list_t *list, const sorted_list_iter_t from, const sorted_list_iter_t to, void *parameter);
 
 /******************************************************************************
  * @brief           Finds the iterator to a position with matching data to the parameter.
@@ -0,0 +1,173 @@
+/******************************************************************************
+ * @writer:      Tal Aharon
+ * @date:        19.10.2026
+ *
+ * @description: This header file defines the interface for a van Emde Boas
+ * tree mapping integer keys of a bounded universe to data, used as the engine
+ * of the keyed priority queues. Keys are unsigned integers below 2^bits, and
+ * the smallest key has the highest priority.
+ *
+ * The tree holds every distinct key once, so finding the smallest or largest
+ * key takes O(1), and inserting a key, removing one or finding the key next
+ * to any value takes O(log log U) where U is the size of the universe. The
+ * data of each key waits in a FIFO bucket, found through a hash table, so
+ * elements of equal key leave in the order they arrived.
+ *
+ * Nothing is ever compared: the order comes from the keys alone.
+ *
+ * Detailed function descriptions and usage guidelines can be found in the
+ * comments within this header file.
+ *
+******************************************************************************/
+#ifndef __VEB_H__
+#define __VEB_H__
+
+#include <stddef.h> /*size_t, NULL */
+
+#include "radix_sort.h" /* radix_sort_item_t */
+
+typedef struct veb veb_t;
+
+/******************************************************************************
+ * @typedef veb_ismatch_func_t
+ * @brief   Function pointer type for matching data elements. This function checks
+ *          if the data element matches a parameter and returns non-zero if they match.
+******************************************************************************/
+typedef int (*veb_ismatch_func_t) (void *data, void *parameter);
+
+#define VEB_MAX_BITS (32)
+
+/******************************************************************************
+ * @brief      Creates a new, empty tree.
+ * @param bits Number of bits of the keys, 1 to VEB_MAX_BITS.
+ * @return     Pointer to the created tree, or NULL if creation fails.
+ * @note       Time Complexity: O(1)
+******************************************************************************/
+veb_t *VebCreate(unsigned int bits);
+
+/******************************************************************************
+ * @brief     Destroys a tree, its buckets and its nodes.
+ * @param veb Pointer to the tree to be destroyed.
+ * @note      Time Complexity: O(n)
+******************************************************************************/
+void VebDestroy(veb_t *veb);
+
+/******************************************************************************
+ * @brief      Inserts data under a key, behind the data already under it.
+ * @param veb  Pointer to the tree.
+ * @param key  Key of the data, below 2^bits.
+ * @param data Pointer to the data to be inserted.
+ * @return     0 on success, or a non-zero value if an allocation failed, in
+ *             which case the tree is unchanged.
+ * @note       Time Complexity: O(1) for a key already present, O(log log U)
+ *             for a new one.
+******************************************************************************/
+int VebInsert(veb_t *veb, unsigned long key, void *data);
+
+/******************************************************************************
+ * @brief       Inserts a batch, every data behind the data already under its
+ *              key. Any order is accepted, but a batch sorted by key walks
+ *              the tree in order, its nodes still cached from the key before.
+ * @param veb   Pointer to the tree.
+ * @param items Array of count items, every key below 2^bits.
+ * @param count Number of items.
+ * @return      0 on success, or a non-zero value if an allocation failed, in
+ *              which case the tree is unchanged.
+ * @note        Time Complexity: O(count log log U)
+******************************************************************************/
+int VebInsertBatch(veb_t *veb, const radix_sort_item_t *items, size_t count);
+
+/******************************************************************************
+ * @brief     Returns the oldest data of the smallest key.
+ * @param veb Pointer to a non empty tree.
+ * @return    Pointer to the data.
+ * @note      Time Complexity: O(1)
+******************************************************************************/
+void *VebPeekMin(const veb_t *veb);
+
+/******************************************************************************
+ * @brief     Returns the newest data of the largest key, the one a full queue
+ *            gives up first.
+ * @param veb Pointer to a non empty tree.
+ * @return    Pointer to the data.
+ * @note      Time Complexity: O(1)
+******************************************************************************/
+void *VebPeekMax(const veb_t *veb);
+
+/******************************************************************************
+ * @brief     Removes and returns the oldest data of the smallest key.
+ * @param veb Pointer to a non empty tree.
+ * @return    Pointer to the removed data.
+ * @note      Time Complexity: O(1) while the key has more data, O(log log U)
+ *            when it leaves.
+******************************************************************************/
+void *VebPopMin(veb_t *veb);
+
+/******************************************************************************
+ * @brief     Removes and returns the newest data of the largest key.
+ * @param veb Pointer to a non empty tree.
+ * @return    Pointer to the removed data.
+ * @note      Time Complexity: O(1) while the key has more data, O(log log U)
+ *            when it leaves.
+******************************************************************************/
+void *VebPopMax(veb_t *veb);
+
+/******************************************************************************
+ * @brief       Finds the oldest data of the smallest key not below a value.
+ * @param veb   Pointer to the tree.
+ * @param value Value to start from, below 2^bits.
+ * @param data  Receives the data when found.
+ * @return      0 if found, or a non-zero value if every key is below value.
+ * @note        Time Complexity: O(log log U)
+******************************************************************************/
+int VebFindNext(const veb_t *veb, unsigned long value, void **data);
+
+/******************************************************************************
+ * @brief       Finds the oldest data of the largest key not above a value.
+ * @param veb   Pointer to the tree.
+ * @param value Value to start from, below 2^bits.
+ * @param data  Receives the data when found.
+ * @return      0 if found, or a non-zero value if every key is above value.
+ * @note        Time Complexity: O(log log U)
+******************************************************************************/
+int VebFindPrev(const veb_t *veb, unsigned long value, void **data);
+
+/******************************************************************************
+ * @brief           Removes the first data, in the order of removal from the
+ *                  minimum, that the matching function accepts.
+ * @param veb       Pointer to the tree.
+ * @param ismatch   Matching function.
+ * @param parameter Parameter passed to the matching function.
+ * @param data      Receives the removed data when found.
+ * @return          0 if data was removed, or a non-zero value if none matched.
+ * @note            Time Complexity: O(n + k log log U) for k distinct keys.
+******************************************************************************/
+int VebRemoveIf(veb_t *veb, veb_ismatch_func_t ismatch, void *parameter, void **data);
+
+/******************************************************************************
+ * @brief     Removes all data from the tree.
+ * @param veb Pointer to the tree.
+ * @note      Time Complexity: O(n)
+******************************************************************************/
+void VebClear(veb_t *veb);
+
+/******************************************************************************
+ * @brief     Returns the number of data elements in the tree.
+ * @param veb Pointer to the tree.
+ * @return    Number of data elements.
+ * @note      Time Complexity: O(1)
+******************************************************************************/
+size_t VebSize(const veb_t *veb);
+
+/******************************************************************************
+ * @brief        Returns the bytes the tree has requested from malloc.
+ * @param veb    Pointer to the tree.
+ * @param nodes  Receives the bytes of the items holding data.
+ * @param spare  Receives the bytes of the free hash table slots.
+ * @param blocks Receives the number of malloc blocks the bytes are spread on.
+ * @return       Number of bytes, the tree, its nodes and hash table included.
+ * @note         Time Complexity: O(1)
+******************************************************************************/
+size_t VebMemoryUsage(const veb_t *veb, size_t *nodes, size_t *spare, size_t *blocks);
+
+#endif /* __VEB_H__ */
@@ -0,0 +1,809 @@
+/******************************************************************************
+ * @writer:      Tal Aharon
+ * @date:        19.10.2026
+ *
+ * @description: Implementation of a bucket queue indexed by a hierarchy of
+ * bitmaps. Bitmap 0 has a bit per level, set while the level holds data, and
+ * every bitmap above has a bit per word of the one below, set while that word
+ * is non zero. The top bitmap is a single word, so the smallest level is found
+ * by scanning the lowest set bit of one word per bitmap, top down.
+ *
+ * The data of a level waits in a FIFO of items linked by their index in one
+ * pool, so an insert allocates nothing while the pool has room and the links
+ * survive the pool growing. Freed items are kept on a free list. The head and
+ * tail of a level are only read while its bit is set, so the table of levels
+ * is never initialized and the pages of levels never used are never touched.
+ *
+******************************************************************************/
+#include <assert.h>          /* assert       */
+#include <limits.h>          /* CHAR_BIT     */
+#include <stdlib.h>          /* malloc, free */
+#include <string.h>          /* memcpy       */
+
+#include "bucket_queue.h"    /* Internal API */
+/*****************************************************************************/
+#define BUCKET_QUEUE_WORD_BITS ((unsigned long)(sizeof(unsigned long) * CHAR_BIT))
+#define BUCKET_QUEUE_BIT(index) (1UL << ((index) % BUCKET_QUEUE_WORD_BITS))
+
+/* 65536 levels take three bitmaps of 64 bit words, four of 32 bit words */
+#define BUCKET_QUEUE_MAX_DEPTH (4)
+#define BUCKET_QUEUE_MIN_ITEMS (16)
+#define BUCKET_QUEUE_NONE ((size_t)-1)
+
+typedef struct bucket_queue_item
+{
+	void *data;
+	size_t prev;
+	size_t next;
+
+} bucket_queue_item_t;
+
+/* Indexes of the oldest and newest items of a level, valid while it is marked */
+typedef struct bucket_queue_level
+{
+	size_t head;
+	size_t tail;
+
+} bucket_queue_level_t;
+
+struct bucket_queue
+{
+	unsigned long *bitmaps[BUCKET_QUEUE_MAX_DEPTH];
+	size_t widths[BUCKET_QUEUE_MAX_DEPTH];
+	size_t words;
+	bucket_queue_level_t *levels;
+	bucket_queue_item_t *items;
+	size_t capacity;
+	size_t used;
+	size_t free;
+	size_t size;
+	unsigned long count;
+	unsigned int depth;
+};
+
+static int BucketQueueGrow(bucket_queue_t *queue, size_t count);
+static int BucketQueueIsMarked(const bucket_queue_t *queue, unsigned long level);
+static void BucketQueueMark(bucket_queue_t *queue, unsigned long level);
+static void BucketQueueUnmark(bucket_queue_t *queue, unsigned long level);
+static unsigned long BucketQueueMin(const bucket_queue_t *queue);
+static unsigned long BucketQueueMax(const bucket_queue_t *queue);
+static int BucketQueueNext(const bucket_queue_t *queue, unsigned long value, unsigned long *level);
+static int BucketQueuePrev(const bucket_queue_t *queue, unsigned long value, unsigned long *level);
+static void *BucketQueueUnlink(bucket_queue_t *queue, unsigned long level, size_t index);
+static unsigned long BucketQueueLowestBit(unsigned long word);
+static unsigned long BucketQueueHighestBit(unsigned long word);
+
+/******************************************************************************
+ * @brief        Creates a new, empty bucket queue.
+ * @param levels Number of levels, 1 to BUCKET_QUEUE_MAX_LEVELS.
+ * @return       Pointer to the created queue, or NULL if creation fails.
+ * @note         Time Complexity: O(levels / word bits)
+******************************************************************************/
+bucket_queue_t *BucketQueueCreate(unsigned long levels)
+{
+	size_t i = 0;
+	size_t width = levels;
+	bucket_queue_t *queue = NULL;
+
+	assert(0 < levels && levels <= BUCKET_QUEUE_MAX_LEVELS && "Levels aren't valid.");
+	queue = (bucket_queue_t *)malloc(sizeof(bucket_queue_t));
+	if(NULL == queue)
+	{
+		return (NULL);
+	}
+
+	/* Every bitmap has a bit per word of the one below, up to a single word */
+	queue->words = 0;
+	queue->depth = 0;
+	do
+	{
+		width = (width + BUCKET_QUEUE_WORD_BITS - 1) / BUCKET_QUEUE_WORD_BITS;
+		queue->widths[queue->depth++] = width;
+		queue->words += width;
+	}
+	while(1 < width);
+
+	queue->bitmaps[0] = (unsigned long *)malloc(queue->words * sizeof(unsigned long));
+	queue->levels = (bucket_queue_level_t *)malloc(levels * sizeof(bucket_queue_level_t));
+	if(NULL == queue->bitmaps[0] || NULL == queue->levels)
+	{
+		free(queue->bitmaps[0]);
+		free(queue->levels);
+		free(queue);
+		return (NULL);
+	}
+
+	for(i = 0; i < queue->words; ++i)
+	{
+		queue->bitmaps[0][i] = 0;
+	}
+
+	for(i = 1; i < queue->depth; ++i)
+	{
+		queue->bitmaps[i] = queue->bitmaps[i - 1] + queue->widths[i - 1];
+	}
+
+	queue->items = NULL;
+	queue->capacity = 0;
+	queue->used = 0;
+	queue->free = BUCKET_QUEUE_NONE;
+	queue->size = 0;
+	queue->count = levels;
+	return (queue);
+}
+
+/******************************************************************************
+ * @brief       Destroys a bucket queue and its items.
+ * @param queue Pointer to the queue to be destroyed.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+void BucketQueueDestroy(bucket_queue_t *queue)
+{
+	assert(queue && "Bucket queue isn't valid.");
+
+	free(queue->items);
+	free(queue->levels);
+	free(queue->bitmaps[0]);
+	free(queue);
+}
+
+/******************************************************************************
+ * @brief       Inserts data at a level, behind the data already there.
+ * @param queue Pointer to the queue.
+ * @param level Level of the data, below the number of levels.
+ * @param data  Pointer to the data to be inserted.
+ * @return      0 on success, or a non-zero value if an allocation failed.
+ * @note        Time Complexity: amortized O(1)
+******************************************************************************/
+int BucketQueueInsert(bucket_queue_t *queue, unsigned long level, void *data)
+{
+	size_t index = 0;
+	bucket_queue_item_t *item = NULL;
+	bucket_queue_level_t *bucket = NULL;
+
+	assert(queue && "Bucket queue isn't valid.");
+	assert(level < queue->count && "Level is out of range.");
+
+	if(BUCKET_QUEUE_NONE == queue->free && queue->used == queue->capacity && BucketQueueGrow(queue, 1))
+	{
+		return (1);
+	}
+
+	if(BUCKET_QUEUE_NONE != queue->free)
+	{
+		index = queue->free;
+		queue->free = queue->items[index].next;
+	}
+	else
+	{
+		index = queue->used++;
+	}
+
+	item = &queue->items[index];
+	item->data = data;
+	item->next = BUCKET_QUEUE_NONE;
+	bucket = &queue->levels[level];
+	if(BucketQueueIsMarked(queue, level))
+	{
+		item->prev = bucket->tail;
+		queue->items[bucket->tail].next = index;
+	}
+	else
+	{
+		item->prev = BUCKET_QUEUE_NONE;
+		bucket->head = index;
+		BucketQueueMark(queue, level);
+	}
+
+	bucket->tail = index;
+	++queue->size;
+	return (0);
+}
+
+/******************************************************************************
+ * @brief       Inserts a batch sorted by level, every data behind the data
+ *              already at its level.
+ * @param queue Pointer to the queue.
+ * @param items Array of count items in ascending order of level.
+ * @param count Number of items.
+ * @return      0 on success, or a non-zero value if the pool could not grow.
+ * @note        Time Complexity: O(count)
+******************************************************************************/
+int BucketQueueInsertBatch(bucket_queue_t *queue, const radix_sort_item_t *items, size_t count)
+{
+	size_t i = 0;
+	size_t first = 0;
+	size_t index = 0;
+	unsigned long level = 0;
+	bucket_queue_item_t *pool = NULL;
+	bucket_queue_level_t *bucket = NULL;
+
+	assert(queue && "Bucket queue isn't valid.");
+	assert((items || 0 == count) && "Items aren't valid.");
+
+	/* The free list is left for single inserts, a batch takes the end of the pool */
+	if(queue->capacity - queue->used < count && BucketQueueGrow(queue, count))
+	{
+		return (1);
+	}
+
+	pool = queue->items;
+	for(first = 0; first < count; first = i)
+	{
+		level = items[first].key;
+		assert(level < queue->count && "Level is out of range.");
+		assert((0 == first || items[first - 1].key < level) && "Levels aren't sorted.");
+
+		/* The run of the level links its consecutive items in one sweep */
+		index = queue->used;
+		for(i = first; i < count && items[i].key == level; ++i, ++index)
+		{
+			pool[index].data = items[i].data;
+			pool[index].prev = index - 1;
+			pool[index].next = index + 1;
+		}
+
+		bucket = &queue->levels[level];
+		pool[index - 1].next = BUCKET_QUEUE_NONE;
+		if(BucketQueueIsMarked(queue, level))
+		{
+			pool[queue->used].prev = bucket->tail;
+			pool[bucket->tail].next = queue->used;
+		}
+		else
+		{
+			pool[queue->used].prev = BUCKET_QUEUE_NONE;
+			bucket->head = queue->used;
+			BucketQueueMark(queue, level);
+		}
+
+		bucket->tail = index - 1;
+		queue->used = index;
+	}
+
+	queue->size += count;
+	return (0);
+}
+
+/******************************************************************************
+ * @brief       Returns the oldest data of the smallest level.
+ * @param queue Pointer to a non empty queue.
+ * @return      Pointer to the data.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+void *BucketQueuePeekMin(const bucket_queue_t *queue)
+{
+	assert(queue && "Bucket queue isn't valid.");
+	assert(0 < queue->size && "Bucket queue is empty.");
+
+	return (queue->items[queue->levels[BucketQueueMin(queue)].head].data);
+}
+
+/******************************************************************************
+ * @brief       Returns the newest data of the largest level.
+ * @param queue Pointer to a non empty queue.
+ * @return      Pointer to the data.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+void *BucketQueuePeekMax(const bucket_queue_t *queue)
+{
+	assert(queue && "Bucket queue isn't valid.");
+	assert(0 < queue->size && "Bucket queue is empty.");
+
+	return (queue->items[queue->levels[BucketQueueMax(queue)].tail].data);
+}
+
+/******************************************************************************
+ * @brief       Removes and returns the oldest data of the smallest level.
+ * @param queue Pointer to a non empty queue.
+ * @return      Pointer to the removed data.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+void *BucketQueuePopMin(bucket_queue_t *queue)
+{
+	unsigned long level = 0;
+
+	assert(queue && "Bucket queue isn't valid.");
+	assert(0 < queue->size && "Bucket queue is empty.");
+
+	level = BucketQueueMin(queue);
+	return (BucketQueueUnlink(queue, level, queue->levels[level].head));
+}
+
+/******************************************************************************
+ * @brief       Removes and returns the newest data of the largest level.
+ * @param queue Pointer to a non empty queue.
+ * @return      Pointer to the removed data.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+void *BucketQueuePopMax(bucket_queue_t *queue)
+{
+	unsigned long level = 0;
+
+	assert(queue && "Bucket queue isn't valid.");
+	assert(0 < queue->size && "Bucket queue is empty.");
+
+	level = BucketQueueMax(queue);
+	return (BucketQueueUnlink(queue, level, queue->levels[level].tail));
+}
+
+/******************************************************************************
+ * @brief       Finds the oldest data of the smallest level not below a value.
+ * @param queue Pointer to the queue.
+ * @param value Value to start from.
+ * @param data  Receives the data when found.
+ * @return      0 if found, or a non-zero value if every level is below value.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+int BucketQueueFindNext(const bucket_queue_t *queue, unsigned long value, void **data)
+{
+	unsigned long level = 0;
+
+	assert(queue && "Bucket queue isn't valid.");
+	assert(data && "Data isn't valid.");
+
+	if(BucketQueueNext(queue, value, &level))
+	{
+		return (1);
+	}
+
+	*data = queue->items[queue->levels[level].head].data;
+	return (0);
+}
+
+/******************************************************************************
+ * @brief       Finds the oldest data of the largest level not above a value.
+ * @param queue Pointer to the queue.
+ * @param value Value to start from.
+ * @param data  Receives the data when found.
+ * @return      0 if found, or a non-zero value if every level is above value.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+int BucketQueueFindPrev(const bucket_queue_t *queue, unsigned long value, void **data)
+{
+	unsigned long level = 0;
+
+	assert(queue && "Bucket queue isn't valid.");
+	assert(data && "Data isn't valid.");
+
+	if(BucketQueuePrev(queue, value, &level))
+	{
+		return (1);
+	}
+
+	*data = queue->items[queue->levels[level].head].data;
+	return (0);
+}
+
+/******************************************************************************
+ * @brief           Removes the first data, in the order of removal from the
+ *                  minimum, that the matching function accepts.
+ * @param queue     Pointer to the queue.
+ * @param ismatch   Matching function.
+ * @param parameter Parameter passed to the matching function.
+ * @param data      Receives the removed data when found.
+ * @return          0 if data was removed, or a non-zero value if none matched.
+ * @note            Time Complexity: O(n + levels / word bits)
+******************************************************************************/
+int BucketQueueRemoveIf(bucket_queue_t *queue, bucket_queue_ismatch_func_t ismatch, void *parameter, void **data)
+{
+	size_t index = 0;
+	unsigned long level = 0;
+	unsigned long max = 0;
+
+	assert(queue && "Bucket queue isn't valid.");
+	assert(ismatch && "Match isn't valid.");
+	assert(data && "Data isn't valid.");
+
+	if(0 == queue->size)
+	{
+		return (1);
+	}
+
+	level = BucketQueueMin(queue);
+	max = BucketQueueMax(queue);
+	for(;;)
+	{
+		for(index = queue->levels[level].head; BUCKET_QUEUE_NONE != index; index = queue->items[index].next)
+		{
+			if(ismatch(queue->items[index].data, parameter))
+			{
+				*data = BucketQueueUnlink(queue, level, index);
+				return (0);
+			}
+		}
+
+		if(level == max)
+		{
+			return (1);
+		}
+
+		(void)BucketQueueNext(queue, level + 1, &level);
+	}
+}
+
+/******************************************************************************
+ * @brief       Removes all data from the queue and frees the pool.
+ * @param queue Pointer to the queue.
+ * @note        Time Complexity: O(levels / word bits)
+******************************************************************************/
+void BucketQueueClear(bucket_queue_t *queue)
+{
+	size_t i = 0;
+
+	assert(queue && "Bucket queue isn't valid.");
+
+	for(i = 0; i < queue->words; ++i)
+	{
+		queue->bitmaps[0][i] = 0;
+	}
+
+	free(queue->items);
+	queue->items = NULL;
+	queue->capacity = 0;
+	queue->used = 0;
+	queue->free = BUCKET_QUEUE_NONE;
+	queue->size = 0;
+}
+
+/******************************************************************************
+ * @brief       Returns the number of data elements in the queue.
+ * @param queue Pointer to the queue.
+ * @return      Number of data elements.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+size_t BucketQueueSize(const bucket_queue_t *queue)
+{
+	assert(queue && "Bucket queue isn't valid.");
+	return (queue->size);
+}
+
+/******************************************************************************
+ * @brief        Returns the bytes the queue has requested from malloc.
+ * @param queue  Pointer to the queue.
+ * @param nodes  Receives the bytes of the items holding data.
+ * @param spare  Receives the bytes of the free items of the pool.
+ * @param blocks Receives the number of malloc blocks the bytes are spread on.
+ * @return       Number of bytes, the queue, its bitmaps, levels and pool
+ *               included.
+ * @note         Time Complexity: O(1)
+******************************************************************************/
+size_t BucketQueueMemoryUsage(const bucket_queue_t *queue, size_t *nodes, size_t *spare, size_t *blocks)
+{
+	assert(queue && "Bucket queue isn't valid.");
+	assert(nodes && spare && blocks && "Counters aren't valid.");
+
+	*nodes = queue->size * sizeof(bucket_queue_item_t);
+	*spare = (queue->capacity - queue->size) * sizeof(bucket_queue_item_t);
+	*blocks = 3 + (NULL != queue->items);
+	return (sizeof(bucket_queue_t) + queue->words * sizeof(unsigned long) +
+	        queue->count * sizeof(bucket_queue_level_t) + queue->capacity * sizeof(bucket_queue_item_t));
+}
+
+/******************************************************************************
+ * @brief       Grows the pool to room for count more items at its end, at
+ *              least doubling it, keeping the indexes of the items.
+ * @param queue Pointer to the queue.
+ * @param count Number of items to make room for.
+ * @return      0 on success, or a non-zero value if the pool could not grow,
+ *              in which case it is unchanged.
+ * @note        Time Complexity: O(n)
+******************************************************************************/
+static int BucketQueueGrow(bucket_queue_t *queue, size_t count)
+{
+	size_t capacity = 0 == queue->capacity ? BUCKET_QUEUE_MIN_ITEMS : 2 * queue->capacity;
+	bucket_queue_item_t *items = NULL;
+
+	if(capacity < queue->used + count)
+	{
+		capacity = queue->used + count;
+	}
+
+	items = (bucket_queue_item_t *)malloc(capacity * sizeof(bucket_queue_item_t));
+	if(NULL == items)
+	{
+		return (1);
+	}
+
+	if(0 < queue->used)
+	{
+		memcpy(items, queue->items, queue->used * sizeof(bucket_queue_item_t));
+	}
+
+	free(queue->items);
+	queue->items = items;
+	queue->capacity = capacity;
+	return (0);
+}
+
+/******************************************************************************
+ * @brief       Tells whether a level holds data.
+ * @param queue Pointer to the queue.
+ * @param level Level to check.
+ * @return      Non-zero if the level holds data.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+static int BucketQueueIsMarked(const bucket_queue_t *queue, unsigned long level)
+{
+	return (0 != (queue->bitmaps[0][level / BUCKET_QUEUE_WORD_BITS] & BUCKET_QUEUE_BIT(level)));
+}
+
+/******************************************************************************
+ * @brief       Sets the bit of a level, and the bits above it of the words
+ *              that were zero.
+ * @param queue Pointer to the queue.
+ * @param level Level that received its first data.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+static void BucketQueueMark(bucket_queue_t *queue, unsigned long level)
+{
+	unsigned int depth = 0;
+	unsigned long *word = NULL;
+
+	for(depth = 0; depth < queue->depth; ++depth)
+	{
+		word = &queue->bitmaps[depth][level / BUCKET_QUEUE_WORD_BITS];
+		if(0 != *word)
+		{
+			*word |= BUCKET_QUEUE_BIT(level);
+			return;
+		}
+
+		*word = BUCKET_QUEUE_BIT(level);
+		level /= BUCKET_QUEUE_WORD_BITS;
+	}
+}
+
+/******************************************************************************
+ * @brief       Clears the bit of a level, and the bits above it of the words
+ *              that became zero.
+ * @param queue Pointer to the queue.
+ * @param level Level that lost its last data.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+static void BucketQueueUnmark(bucket_queue_t *queue, unsigned long level)
+{
+	unsigned int depth = 0;
+	unsigned long *word = NULL;
+
+	for(depth = 0; depth < queue->depth; ++depth)
+	{
+		word = &queue->bitmaps[depth][level / BUCKET_QUEUE_WORD_BITS];
+		*word &= ~BUCKET_QUEUE_BIT(level);
+		if(0 != *word)
+		{
+			return;
+		}
+
+		level /= BUCKET_QUEUE_WORD_BITS;
+	}
+}
+
+/******************************************************************************
+ * @brief       Returns the smallest level holding data, one bit scan per
+ *              bitmap from the top.
+ * @param queue Pointer to a non empty queue.
+ * @return      Smallest marked level.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+static unsigned long BucketQueueMin(const bucket_queue_t *queue)
+{
+	unsigned long level = 0;
+	unsigned int depth = queue->depth;
+
+	while(0 < depth)
+	{
+		--depth;
+		level = level * BUCKET_QUEUE_WORD_BITS + BucketQueueLowestBit(queue->bitmaps[depth][level]);
+	}
+
+	return (level);
+}
+
+/******************************************************************************
+ * @brief       Returns the largest level holding data, one bit scan per
+ *              bitmap from the top.
+ * @param queue Pointer to a non empty queue.
+ * @return      Largest marked level.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+static unsigned long BucketQueueMax(const bucket_queue_t *queue)
+{
+	unsigned long level = 0;
+	unsigned int depth = queue->depth;
+
+	while(0 < depth)
+	{
+		--depth;
+		level = level * BUCKET_QUEUE_WORD_BITS + BucketQueueHighestBit(queue->bitmaps[depth][level]);
+	}
+
+	return (level);
+}
+
+/******************************************************************************
+ * @brief       Finds the smallest marked level not below a value. The search
+ *              climbs until a word has a set bit at or after the position,
+ *              then descends to the lowest set bit of every word below it.
+ * @param queue Pointer to the queue.
+ * @param value Value to start from.
+ * @param level Receives the level when found.
+ * @return      0 if found, or a non-zero value otherwise.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+static int BucketQueueNext(const bucket_queue_t *queue, unsigned long value, unsigned long *level)
+{
+	unsigned int depth = 0;
+	unsigned long word = 0;
+
+	for(depth = 0; depth < queue->depth; ++depth)
+	{
+		if(value / BUCKET_QUEUE_WORD_BITS >= queue->widths[depth])
+		{
+			return (1);
+		}
+
+		word = queue->bitmaps[depth][value / BUCKET_QUEUE_WORD_BITS] & (~0UL << (value % BUCKET_QUEUE_WORD_BITS));
+		if(0 != word)
+		{
+			value = value - value % BUCKET_QUEUE_WORD_BITS + BucketQueueLowestBit(word);
+			break;
+		}
+
+		value = value / BUCKET_QUEUE_WORD_BITS + 1;
+	}
+
+	if(depth == queue->depth)
+	{
+		return (1);
+	}
+
+	while(0 < depth)
+	{
+		--depth;
+		value = value * BUCKET_QUEUE_WORD_BITS + BucketQueueLowestBit(queue->bitmaps[depth][value]);
+	}
+
+	*level = value;
+	return (0);
+}
+
+/******************************************************************************
+ * @brief       Finds the largest marked level not above a value, climbing and
+ *              descending like BucketQueueNext.
+ * @param queue Pointer to the queue.
+ * @param value Value to start from.
+ * @param level Receives the level when found.
+ * @return      0 if found, or a non-zero value otherwise.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+static int BucketQueuePrev(const bucket_queue_t *queue, unsigned long value, unsigned long *level)
+{
+	unsigned int depth = 0;
+	unsigned long word = 0;
+
+	if(value >= queue->count)
+	{
+		value = queue->count - 1;
+	}
+
+	for(depth = 0; depth < queue->depth; ++depth)
+	{
+		word = queue->bitmaps[depth][value / BUCKET_QUEUE_WORD_BITS] &
+		       (~0UL >> (BUCKET_QUEUE_WORD_BITS - 1 - value % BUCKET_QUEUE_WORD_BITS));
+		if(0 != word)
+		{
+			value = value - value % BUCKET_QUEUE_WORD_BITS + BucketQueueHighestBit(word);
+			break;
+		}
+
+		if(value < BUCKET_QUEUE_WORD_BITS)
+		{
+			return (1);
+		}
+
+		value = value / BUCKET_QUEUE_WORD_BITS - 1;
+	}
+
+	if(depth == queue->depth)
+	{
+		return (1);
+	}
+
+	while(0 < depth)
+	{
+		--depth;
+		value = value * BUCKET_QUEUE_WORD_BITS + BucketQueueHighestBit(queue->bitmaps[depth][value]);
+	}
+
+	*level = value;
+	return (0);
+}
+
+/******************************************************************************
+ * @brief       Removes an item from the FIFO of its level and returns it to
+ *              the pool, which starts over once the queue is empty.
+ * @param queue Pointer to the queue.
+ * @param level Level of the item.
+ * @param index Index of the item in the pool.
+ * @return      Pointer to the data of the item.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+static void *BucketQueueUnlink(bucket_queue_t *queue, unsigned long level, size_t index)
+{
+	bucket_queue_item_t *item = &queue->items[index];
+	bucket_queue_level_t *bucket = &queue->levels[level];
+
+	if(BUCKET_QUEUE_NONE == item->prev)
+	{
+		bucket->head = item->next;
+	}
+	else
+	{
+		queue->items[item->prev].next = item->next;
+	}
+
+	if(BUCKET_QUEUE_NONE == item->next)
+	{
+		bucket->tail = item->prev;
+	}
+	else
+	{
+		queue->items[item->next].prev = item->prev;
+	}
+
+	if(BUCKET_QUEUE_NONE == bucket->head)
+	{
+		BucketQueueUnmark(queue, level);
+	}
+
+	if(0 == --queue->size)
+	{
+		queue->used = 0;
+		queue->free = BUCKET_QUEUE_NONE;
+	}
+	else
+	{
+		item->next = queue->free;
+		queue->free = index;
+	}
+
+	return (item->data);
+}
+
+/******************************************************************************
+ * @brief      Returns the index of the lowest set bit of a non zero word.
+ * @param word Word to scan.
+ * @note       Time Complexity: O(1) with GCC builtins, O(bits) otherwise.
+******************************************************************************/
+static unsigned long BucketQueueLowestBit(unsigned long word)
+{
+	#if defined(__GNUC__)
+	return ((unsigned long)__builtin_ctzl(word));
+	#else
+	unsigned long bit = 0;
+	for(; 0 == (word & 1UL); word >>= 1, ++bit);
+
+	return (bit);
+	#endif
+}
+
+/******************************************************************************
+ * @brief      Returns the index of the highest set bit of a non zero word.
+ * @param word Word to scan.
+ * @note       Time Complexity: O(1) with GCC builtins, O(bits) otherwise.
+******************************************************************************/
+static unsigned long BucketQueueHighestBit(unsigned long word)
+{
+	#if defined(__GNUC__)
+	return ((unsigned long)(BUCKET_QUEUE_WORD_BITS - 1 - __builtin_clzl(word)));
+	#else
+	unsigned long bit = 0;
+	while(word >>= 1)
+	{
+		++bit;
+	}
+
+	return (bit);
+	#endif
+}
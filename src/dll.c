@@ -86,7 +86,7 @@ void DLLDestroy(dll_t *dll)
  * @brief          Inserts a new node with data after the given iterator.
  * @param iterator Iterator to the position after which the new node should be inserted.
  * @param data     Pointer to the data to be inserted.
- * @return         Iterator pointing to the inserted node, or end of the list if insertion fails.
+ * @return         Iterator pointing to the inserted node, or NULL if insertion fails.
 ******************************************************************************/
 dll_iter_t DLLInsertAfter(dll_iter_t iterator, void *data)
 {
@@ -98,21 +98,17 @@ dll_iter_t DLLInsertAfter(dll_iter_t iterator, void *data)
  * @brief          Inserts a new node with data before the given iterator.
  * @param iterator Iterator to the position before which the new node should be inserted.
  * @param data     Pointer to the data to be inserted.
- * @return         Iterator pointing to the inserted node, or end of the list if insertion fails.
+ * @return         Iterator pointing to the inserted node, or NULL if insertion fails.
 ******************************************************************************/
 dll_iter_t DLLInsertBefore(dll_iter_t iterator, void *data)
 {
 	dll_node_t *new_node = (dll_node_t *)malloc(sizeof(dll_node_t));
 	assert(iterator && "Iterator isn't valid.");
 
+	/* Nodes do not know their list, callers holding it map this to the end */
 	if(NULL == new_node)
 	{
-		while(iterator->next)
-		{
-			iterator = iterator->next;
-		}
-
-		return (iterator);
+		return (NULL);
 	}
 
 	if(NULL == iterator->next)
@@ -167,8 +163,11 @@ dll_iter_t DLLRemove(dll_iter_t iterator)
 ******************************************************************************/
 dll_iter_t DLLPushBack(dll_t *dll, void *data)
 {
+	dll_iter_t pushed = NULL;
 	assert(dll && "dll isn't valid.");
-	return (DLLInsertBefore(dll->tail, data)); 
+
+	pushed = DLLInsertBefore(dll->tail, data);
+	return (NULL == pushed ? dll->tail : pushed);
 }
 
 /******************************************************************************
@@ -179,8 +178,11 @@ dll_iter_t DLLPushBack(dll_t *dll, void *data)
 ******************************************************************************/
 dll_iter_t DLLPushFront(dll_t *dll, void *data)
 {
+	dll_iter_t pushed = NULL;
 	assert(dll && "dll isn't valid.");
-	return (DLLInsertBefore(dll->head, data));
+
+	pushed = DLLInsertBefore(dll->head, data);
+	return (NULL == pushed ? dll->tail : pushed);
 }
 
 /******************************************************************************
@@ -314,6 +316,25 @@ size_t DLLCount(const dll_t *dll)
 	return (count);
 }
 
+/******************************************************************************
+ * @brief        Returns the bytes the list has requested from malloc.
+ * @param dll    Pointer to the list.
+ * @param nodes  Receives the bytes of the nodes holding data.
+ * @param blocks Receives the number of malloc blocks the bytes are spread on.
+ * @return       Number of bytes, the list and its dummy node included.
+******************************************************************************/
+size_t DLLMemoryUsage(const dll_t *dll, size_t *nodes, size_t *blocks)
+{
+	size_t count = 0;
+	assert(dll && "dll isn't valid.");
+	assert(nodes && blocks && "Counters aren't valid.");
+
+	count = DLLCount(dll);
+	*nodes = count * sizeof(dll_node_t);
+	*blocks = count + 2;
+	return (sizeof(dll_t) + sizeof(dll_node_t) + *nodes);
+}
+
 /******************************************************************************
  * @brief       Iterates through the list and performs an action on each node's data.
  * @param from  Iterator pointing to the start of the range.
@@ -0,0 +1,802 @@
+/******************************************************************************
+ * @writer:      Tal Aharon
+ * @date:        18.10.2026
+ *
+ * @description: Implementation of a d-ary heap over segmented storage. Slots
+ * hold the data together with the handle of the element, so comparisons never
+ * have to dereference the handle; the handle only records the current slot
+ * index and is updated whenever its element moves. Handles are recycled through
+ * a free list and live in their own segmented array, so their addresses never
+ * change while the heap grows or shrinks.
+ *
+******************************************************************************/
+#include <assert.h>          /* assert       */
+#include <stdlib.h>          /* malloc, free */
+
+#include "segmented_array.h" /* Internal API */
+#include "heap.h"            /* Internal API */
+/*****************************************************************************/
+struct heap_handle
+{
+	size_t index;
+	struct heap_handle *next;
+};
+
+typedef struct heap_slot
+{
+	void *data;
+	heap_handle_t handle;
+
+} heap_slot_t;
+
+struct heap
+{
+	segmented_array_t *slots;
+	segmented_array_t *handles;
+	heap_handle_t free_handles;
+	size_t handle_count;
+	size_t size;
+	size_t comparisons;
+	size_t arity;
+	heap_compare_func_t cmp;
+	heap_compare_batch_func_t batch;
+};
+
+#define HEAP_PARENT(heap, index) (((index) - 1) / (heap)->arity)
+#define HEAP_CHILD(heap, index) ((heap)->arity * (index) + 1)
+#define HEAP_FIRST_LEAF(heap) (1 < (heap)->size ? HEAP_PARENT(heap, (heap)->size - 1) + 1 : 0)
+
+static heap_slot_t *HeapSlot(const heap_t *heap, size_t index);
+static heap_handle_t HeapHandleAlloc(heap_t *heap);
+static void HeapHandleFree(heap_t *heap, heap_handle_t handle);
+static void HeapRestore(heap_t *heap, size_t index);
+static void HeapSiftUp(heap_t *heap, size_t index);
+static void HeapSiftDown(heap_t *heap, size_t index);
+static size_t HeapBatchChild(heap_t *heap, void *data, size_t first, size_t last);
+static void HeapRebuild(heap_t *heap, size_t old_size);
+
+/******************************************************************************
+ * @brief         Creates a new heap.
+ * @param compare Function to use for ordering the heap.
+ * @return        Pointer to the created heap, or NULL if creation fails.
+ * @note          Time Complexity: O(1)
+******************************************************************************/
+heap_t *HeapCreate(heap_compare_func_t compare)
+{
+	return (HeapCreateArity(compare, 2));
+}
+
+/******************************************************************************
+ * @brief         Creates a new heap where every element has up to arity 
+ *                children.
+ * @param compare Function to use for ordering the heap.
+ * @param arity   Number of children per element, 2 to HEAP_MAX_ARITY.
+ * @return        Pointer to the created heap, or NULL if creation fails.
+ * @note          Time Complexity: O(1)
+******************************************************************************/
+heap_t *HeapCreateArity(heap_compare_func_t compare, size_t arity)
+{
+	heap_t *heap = NULL;
+
+	assert(2 <= arity && arity <= HEAP_MAX_ARITY && "Arity isn't valid.");
+	heap = (heap_t *)malloc(sizeof(heap_t));
+	if(NULL == heap)
+	{
+		return (NULL);
+	}
+
+	heap->slots = SegmentedArrayCreate(sizeof(heap_slot_t));
+	if(NULL == heap->slots)
+	{
+		free(heap);
+		return (NULL);
+	}
+
+	heap->handles = SegmentedArrayCreate(sizeof(struct heap_handle));
+	if(NULL == heap->handles)
+	{
+		SegmentedArrayDestroy(heap->slots);
+		free(heap);
+		return (NULL);
+	}
+
+	heap->free_handles = NULL;
+	heap->handle_count = 0;
+	heap->size = 0;
+	heap->comparisons = 0;
+	heap->arity = arity;
+	heap->cmp = compare;
+	heap->batch = NULL;
+	return (heap);
+}
+
+/******************************************************************************
+ * @brief         Sets a batch compare function for sifting down.
+ * @param heap    Pointer to the heap.
+ * @param batch   Batch compare function, or NULL to compare one by one.
+ * @note          Time Complexity: O(1)
+******************************************************************************/
+void HeapSetCompareBatch(heap_t *heap, heap_compare_batch_func_t batch)
+{
+	assert(heap && "Heap isn't valid.");
+	heap->batch = batch;
+}
+
+/******************************************************************************
+ * @brief      Destroys a heap and its storage.
+ * @param heap Pointer to the heap to be destroyed.
+ * @note       Time Complexity: O(log n)
+******************************************************************************/
+void HeapDestroy(heap_t *heap)
+{
+	assert(heap && "Heap isn't valid.");
+	SegmentedArrayDestroy(heap->handles);
+	SegmentedArrayDestroy(heap->slots);
+	free(heap);
+}
+
+/******************************************************************************
+ * @brief      Pushes data into the heap.
+ * @param heap Pointer to the heap.
+ * @param data Pointer to the data to be pushed.
+ * @return     0 on success, or a non-zero value if storage could not grow.
+ * @note       Time Complexity: O(log n)
+******************************************************************************/
+int HeapPush(heap_t *heap, void *data)
+{
+	return (NULL == HeapPushHandle(heap, data));
+}
+
+/******************************************************************************
+ * @brief      Pushes data into the heap and returns a handle to it.
+ * @param heap Pointer to the heap.
+ * @param data Pointer to the data to be pushed.
+ * @return     Handle to the pushed element, or NULL if storage could not grow.
+ * @note       Time Complexity: O(log n)
+******************************************************************************/
+heap_handle_t HeapPushHandle(heap_t *heap, void *data)
+{
+	heap_slot_t *slot = NULL;
+	heap_handle_t handle = NULL;
+
+	assert(heap && "Heap isn't valid.");
+	if(SegmentedArrayReserve(heap->slots, heap->size + 1))
+	{
+		return (NULL);
+	}
+
+	handle = HeapHandleAlloc(heap);
+	if(NULL == handle)
+	{
+		return (NULL);
+	}
+
+	slot = HeapSlot(heap, heap->size);
+	slot->data = data;
+	slot->handle = handle;
+	handle->index = heap->size;
+	++heap->size;
+
+	HeapSiftUp(heap, heap->size - 1);
+	return (handle);
+}
+
+/******************************************************************************
+ * @brief       Pushes several data elements at once.
+ * @param heap  Pointer to the heap.
+ * @param data  Array of data to be pushed.
+ * @param count Number of elements in data.
+ * @return      0 on success, or a non-zero value if storage could not grow, in
+ *              which case nothing was pushed.
+ * @note        Time Complexity: O(n + m) when m is at least n, O(m log(n + m))
+ *              otherwise.
+******************************************************************************/
+int HeapPushBatch(heap_t *heap, void **data, size_t count)
+{
+	size_t i = 0;
+	size_t old_size = 0;
+	heap_slot_t *slot = NULL;
+	heap_handle_t handle = NULL;
+
+	assert(heap && "Heap isn't valid.");
+	assert((data || 0 == count) && "Data isn't valid.");
+	if(SegmentedArrayReserve(heap->slots, heap->size + count))
+	{
+		return (1);
+	}
+
+	/* Handles are linked through the new slots, so a failure returns them all */
+	for(i = 0; i < count; ++i)
+	{
+		handle = HeapHandleAlloc(heap);
+		if(NULL == handle)
+		{
+			for(; 0 < i; --i)
+			{
+				HeapHandleFree(heap, HeapSlot(heap, heap->size + i - 1)->handle);
+			}
+
+			SegmentedArrayTrim(heap->slots, heap->size);
+			return (1);
+		}
+
+		slot = HeapSlot(heap, heap->size + i);
+		slot->data = data[i];
+		slot->handle = handle;
+		handle->index = heap->size + i;
+	}
+
+	old_size = heap->size;
+	heap->size += count;
+	HeapRebuild(heap, old_size);
+	return (0);
+}
+
+/******************************************************************************
+ * @brief        Removes the element owning the handle and returns its data.
+ * @param heap   Pointer to the heap.
+ * @param handle Valid handle returned by HeapPushHandle.
+ * @return       Pointer to the removed data.
+ * @note         Time Complexity: O(log n)
+******************************************************************************/
+void *HeapRemoveHandle(heap_t *heap, heap_handle_t handle)
+{
+	assert(heap && "Heap isn't valid.");
+	assert(handle && "Handle isn't valid.");
+	return (HeapRemoveAt(heap, handle->index));
+}
+
+/******************************************************************************
+ * @brief        Replaces the data of the element owning the handle and moves
+ *               the element to the position matching its new priority.
+ * @param heap   Pointer to the heap.
+ * @param handle Valid handle returned by HeapPushHandle.
+ * @param data   Pointer to the new data.
+ * @note         Time Complexity: O(log n)
+******************************************************************************/
+void HeapUpdateHandle(heap_t *heap, heap_handle_t handle, void *data)
+{
+	assert(heap && "Heap isn't valid.");
+	assert(handle && "Handle isn't valid.");
+	assert(handle->index < heap->size && "Handle isn't in the heap.");
+
+	HeapSlot(heap, handle->index)->data = data;
+	HeapRestore(heap, handle->index);
+}
+
+/******************************************************************************
+ * @brief        Returns the data of the element owning the handle.
+ * @param heap   Pointer to the heap.
+ * @param handle Valid handle returned by HeapPushHandle.
+ * @return       Pointer to the data.
+ * @note         Time Complexity: O(1)
+******************************************************************************/
+void *HeapHandleData(const heap_t *heap, heap_handle_t handle)
+{
+	assert(heap && "Heap isn't valid.");
+	assert(handle && "Handle isn't valid.");
+	assert(handle->index < heap->size && "Handle isn't in the heap.");
+
+	return (HeapSlot(heap, handle->index)->data);
+}
+
+/******************************************************************************
+ * @brief      Removes and returns the data with the highest priority.
+ * @param heap Pointer to the heap.
+ * @return     Pointer to the removed data, or NULL if the heap is empty.
+ * @note       Time Complexity: O(log n)
+******************************************************************************/
+void *HeapPop(heap_t *heap)
+{
+	assert(heap && "Heap isn't valid.");
+	if(0 == heap->size)
+	{
+		return (NULL);
+	}
+
+	return (HeapRemoveAt(heap, 0));
+}
+
+/******************************************************************************
+ * @brief      Returns the data with the highest priority without removing it.
+ * @param heap Pointer to the heap.
+ * @return     Pointer to the data, or NULL if the heap is empty.
+ * @note       Time Complexity: O(1)
+******************************************************************************/
+void *HeapPeek(const heap_t *heap)
+{
+	assert(heap && "Heap isn't valid.");
+	if(0 == heap->size)
+	{
+		return (NULL);
+	}
+
+	return (HeapSlot(heap, 0)->data);
+}
+
+/******************************************************************************
+ * @brief      Returns the number of elements in the heap.
+ * @param heap Pointer to the heap.
+ * @return     Number of elements in the heap.
+ * @note       Time Complexity: O(1)
+******************************************************************************/
+size_t HeapSize(const heap_t *heap)
+{
+	assert(heap && "Heap isn't valid.");
+	return (heap->size);
+}
+
+/******************************************************************************
+ * @brief      Returns the number of comparisons the heap has made since its
+ *             creation.
+ * @param heap Pointer to the heap.
+ * @return     Number of calls to the compare function.
+ * @note       Time Complexity: O(1)
+******************************************************************************/
+size_t HeapComparisons(const heap_t *heap)
+{
+	assert(heap && "Heap isn't valid.");
+	return (heap->comparisons);
+}
+
+/******************************************************************************
+ * @brief        Returns the bytes the heap has requested from malloc.
+ * @param heap   Pointer to the heap.
+ * @param nodes  Receives the bytes of the slots and handles holding elements.
+ * @param spare  Receives the bytes of slots and handles reserved but unused.
+ * @param blocks Receives the number of malloc blocks the bytes are spread on.
+ * @return       Number of bytes, the heap and the array directories included.
+ * @note         Time Complexity: O(1)
+******************************************************************************/
+size_t HeapMemoryUsage(const heap_t *heap, size_t *nodes, size_t *spare, size_t *blocks)
+{
+	size_t bytes = 0;
+	size_t handle_blocks = 0;
+	assert(heap && "Heap isn't valid.");
+	assert(nodes && spare && blocks && "Counters aren't valid.");
+
+	/* Every element owns a slot and a handle, the rest is reserve */
+	bytes = sizeof(heap_t) + SegmentedArrayMemoryUsage(heap->slots, blocks) +
+	        SegmentedArrayMemoryUsage(heap->handles, &handle_blocks);
+	*blocks += handle_blocks + 1;
+	*nodes = heap->size * (sizeof(heap_slot_t) + sizeof(struct heap_handle));
+	*spare = (SegmentedArrayCapacity(heap->slots) - heap->size) * sizeof(heap_slot_t) +
+	         (SegmentedArrayCapacity(heap->handles) - heap->size) * sizeof(struct heap_handle);
+	return (bytes);
+}
+
+/******************************************************************************
+ * @brief      Checks if the heap is empty.
+ * @param heap Pointer to the heap.
+ * @return     Non-zero value if empty, 0 if not empty.
+ * @note       Time Complexity: O(1)
+******************************************************************************/
+int HeapIsEmpty(const heap_t *heap)
+{
+	assert(heap && "Heap isn't valid.");
+	return (0 == heap->size);
+}
+
+/******************************************************************************
+ * @brief           Finds the index of the first element matching the parameter.
+ * @param heap      Pointer to the heap.
+ * @param match     Matching function.
+ * @param parameter Pointer to the parameter used for matching.
+ * @return          Index of the found element, or HeapSize(heap) if not found.
+ * @note            Time Complexity: O(n)
+******************************************************************************/
+size_t HeapFindIf(const heap_t *heap, heap_ismatch_func_t match, void *parameter)
+{
+	size_t index = 0;
+
+	assert(heap && "Heap isn't valid.");
+	assert(match && "Match function isn't valid.");
+
+	for(; index < heap->size; ++index)
+	{
+		if(match(HeapSlot(heap, index)->data, parameter))
+		{
+			return (index);
+		}
+	}
+
+	return (heap->size);
+}
+
+/******************************************************************************
+ * @brief       Returns the data of the element at the given index.
+ * @param heap  Pointer to the heap.
+ * @param index Index of the element, as returned by HeapFindIf or HeapLowest.
+ * @return      Pointer to the data.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+void *HeapDataAt(const heap_t *heap, size_t index)
+{
+	assert(heap && "Heap isn't valid.");
+	assert(index < heap->size && "Index out of range.");
+	return (HeapSlot(heap, index)->data);
+}
+
+/******************************************************************************
+ * @brief      Finds the index of the element with the lowest priority. Only the
+ *             leaves can hold it, so only they are compared.
+ * @param heap Pointer to the heap, its comparison count grows by the
+ *             comparisons made.
+ * @return     Index of the lowest element, or HeapSize(heap) if empty.
+ * @note       Time Complexity: O(n)
+******************************************************************************/
+size_t HeapLowest(heap_t *heap)
+{
+	size_t index = 0;
+	size_t lowest = 0;
+
+	assert(heap && "Heap isn't valid.");
+	if(0 == heap->size)
+	{
+		return (heap->size);
+	}
+
+	lowest = HEAP_FIRST_LEAF(heap);
+	for(index = lowest + 1; index < heap->size; ++index)
+	{
+		++heap->comparisons;
+		if(0 < heap->cmp(HeapSlot(heap, index)->data, HeapSlot(heap, lowest)->data))
+		{
+			lowest = index;
+		}
+	}
+
+	return (lowest);
+}
+
+/******************************************************************************
+ * @brief       Removes the element at the given index and returns its data.
+ * @param heap  Pointer to the heap.
+ * @param index Index of the element, as returned by HeapFindIf.
+ * @return      Pointer to the removed data.
+ * @note        Time Complexity: O(log n)
+******************************************************************************/
+void *HeapRemoveAt(heap_t *heap, size_t index)
+{
+	heap_slot_t *slot = NULL;
+	void *data = NULL;
+
+	assert(heap && "Heap isn't valid.");
+	assert(index < heap->size && "Index out of range.");
+
+	slot = HeapSlot(heap, index);
+	data = slot->data;
+	HeapHandleFree(heap, slot->handle);
+	--heap->size;
+
+	if(index != heap->size)
+	{
+		*slot = *HeapSlot(heap, heap->size);
+		slot->handle->index = index;
+		HeapRestore(heap, index);
+	}
+
+	SegmentedArrayTrim(heap->slots, heap->size);
+	return (data);
+}
+
+/******************************************************************************
+ * @brief        Moves all elements of source into dest. Handles into dest stay
+ *               valid, handles into source are invalidated.
+ * @param dest   Pointer to the heap receiving the elements.
+ * @param source Pointer to the heap giving the elements.
+ * @return       0 on success, or a non-zero value if storage could not grow.
+ * @note         Time Complexity: O(n + m) when source is at least as large as
+ *               dest, O(m log(n + m)) otherwise.
+******************************************************************************/
+int HeapMerge(heap_t *dest, heap_t *source)
+{
+	size_t old_size = 0;
+	heap_slot_t *slot = NULL;
+	heap_handle_t handle = NULL;
+
+	assert(dest && "Heap isn't valid.");
+	assert(source && "Heap isn't valid.");
+	assert(dest != source && "Heap can't merge into itself.");
+
+	if(SegmentedArrayReserve(dest->slots, dest->size + source->size))
+	{
+		return (1);
+	}
+
+	/* Taking from the back of source keeps it a valid heap at every step */
+	old_size = dest->size;
+	while(0 < source->size)
+	{
+		handle = HeapHandleAlloc(dest);
+		if(NULL == handle)
+		{
+			break;
+		}
+
+		--source->size;
+		slot = HeapSlot(dest, dest->size);
+		*slot = *HeapSlot(source, source->size);
+		HeapHandleFree(source, slot->handle);
+		slot->handle = handle;
+		handle->index = dest->size;
+		++dest->size;
+	}
+
+	HeapRebuild(dest, old_size);
+	SegmentedArrayTrim(source->slots, source->size);
+	return (0 != source->size);
+}
+
+/******************************************************************************
+ * @brief      Removes all elements from the heap. Invalidates all handles.
+ * @param heap Pointer to the heap.
+ * @note       Time Complexity: O(log n)
+******************************************************************************/
+void HeapClear(heap_t *heap)
+{
+	assert(heap && "Heap isn't valid.");
+	heap->size = 0;
+	heap->handle_count = 0;
+	heap->free_handles = NULL;
+	SegmentedArrayTrim(heap->slots, 0);
+	SegmentedArrayTrim(heap->handles, 0);
+}
+
+/******************************************************************************
+ * @brief       Translates a heap index into the address of its slot.
+ * @param heap  Pointer to the heap.
+ * @param index Index smaller than the slots capacity.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+static heap_slot_t *HeapSlot(const heap_t *heap, size_t index)
+{
+	return ((heap_slot_t *)SegmentedArrayAt(heap->slots, index));
+}
+
+/******************************************************************************
+ * @brief      Takes a handle from the free list, or a fresh one from the pool.
+ *             The pool only grows; handles are recycled rather than released
+ *             so that no live handle is ever moved or freed.
+ * @param heap Pointer to the heap.
+ * @return     A handle, or NULL if the pool could not grow.
+ * @note       Time Complexity: O(1)
+******************************************************************************/
+static heap_handle_t HeapHandleAlloc(heap_t *heap)
+{
+	heap_handle_t handle = heap->free_handles;
+
+	if(NULL != handle)
+	{
+		heap->free_handles = handle->next;
+		return (handle);
+	}
+
+	if(SegmentedArrayReserve(heap->handles, heap->handle_count + 1))
+	{
+		return (NULL);
+	}
+
+	handle = (heap_handle_t)SegmentedArrayAt(heap->handles, heap->handle_count);
+	++heap->handle_count;
+	return (handle);
+}
+
+/******************************************************************************
+ * @brief        Returns a handle to the free list.
+ * @param heap   Pointer to the heap.
+ * @param handle Handle that no longer owns an element.
+ * @note         Time Complexity: O(1)
+******************************************************************************/
+static void HeapHandleFree(heap_t *heap, heap_handle_t handle)
+{
+	handle->next = heap->free_handles;
+	heap->free_handles = handle;
+}
+
+/******************************************************************************
+ * @brief       Moves the element at index up or down to restore heap order.
+ * @param heap  Pointer to the heap.
+ * @param index Index of an element whose priority may have changed.
+ * @note        Time Complexity: O(log n)
+******************************************************************************/
+static void HeapRestore(heap_t *heap, size_t index)
+{
+	if(0 == index)
+	{
+		HeapSiftDown(heap, index);
+		return;
+	}
+
+	++heap->comparisons;
+	if(0 < heap->cmp(HeapSlot(heap, HEAP_PARENT(heap, index))->data, HeapSlot(heap, index)->data))
+	{
+		HeapSiftUp(heap, index);
+	}
+	else
+	{
+		HeapSiftDown(heap, index);
+	}
+}
+
+/******************************************************************************
+ * @brief       Moves the element at index up until its parent outranks it.
+ * @param heap  Pointer to the heap.
+ * @param index Index of the element to move.
+ * @note        Time Complexity: O(log n)
+******************************************************************************/
+static void HeapSiftUp(heap_t *heap, size_t index)
+{
+	heap_slot_t *slot = HeapSlot(heap, index);
+	heap_slot_t *parent_slot = NULL;
+	heap_slot_t moving = *slot;
+
+	while(0 < index)
+	{
+		parent_slot = HeapSlot(heap, HEAP_PARENT(heap, index));
+		++heap->comparisons;
+		if(0 >= heap->cmp(parent_slot->data, moving.data))
+		{
+			break;
+		}
+
+		*slot = *parent_slot;
+		slot->handle->index = index;
+		slot = parent_slot;
+		index = HEAP_PARENT(heap, index);
+	}
+
+	*slot = moving;
+	moving.handle->index = index;
+}
+
+/******************************************************************************
+ * @brief       Moves the element at index down until it outranks its children.
+ *              The best child of a level is found by the batch compare function
+ *              when there is one, by comparing the children in turn otherwise.
+ * @param heap  Pointer to the heap.
+ * @param index Index of the element to move.
+ * @note        Time Complexity: O(d log n / log d)
+******************************************************************************/
+static void HeapSiftDown(heap_t *heap, size_t index)
+{
+	heap_slot_t *slot = HeapSlot(heap, index);
+	heap_slot_t *child_slot = NULL;
+	heap_slot_t *next_slot = NULL;
+	heap_slot_t moving = *slot;
+	size_t child = 0;
+	size_t next = 0;
+	size_t last = 0;
+
+	while((child = HEAP_CHILD(heap, index)) < heap->size)
+	{
+		last = heap->size - child > heap->arity ? child + heap->arity : heap->size;
+		if(NULL != heap->batch)
+		{
+			child = HeapBatchChild(heap, moving.data, child, last);
+			if(child == last)
+			{
+				break;
+			}
+
+			child_slot = HeapSlot(heap, child);
+		}
+		else
+		{
+			child_slot = HeapSlot(heap, child);
+			for(next = child + 1; next < last; ++next)
+			{
+				next_slot = HeapSlot(heap, next);
+				++heap->comparisons;
+				if(0 < heap->cmp(child_slot->data, next_slot->data))
+				{
+					child_slot = next_slot;
+					child = next;
+				}
+			}
+
+			++heap->comparisons;
+			if(0 >= heap->cmp(moving.data, child_slot->data))
+			{
+				break;
+			}
+		}
+
+		*slot = *child_slot;
+		slot->handle->index = index;
+		slot = child_slot;
+		index = child;
+	}
+
+	*slot = moving;
+	moving.handle->index = index;
+}
+
+/******************************************************************************
+ * @brief       Finds the child with the highest priority among the children
+ *              that outrank data. The first batch call keeps the children that
+ *              outrank data, every further call keeps those that outrank the 
+ *              first candidate left, until a single one remains or none does.
+ * @param heap  Pointer to the heap.
+ * @param data  Data of the element being sifted down.
+ * @param first Index of the first child.
+ * @param last  Index past the last child.
+ * @return      Index of the best child, or last if no child outranks data.
+ * @note        Time Complexity: O(d) per call, O(log d) calls on average.
+******************************************************************************/
+static size_t HeapBatchChild(heap_t *heap, void *data, size_t first, size_t last)
+{
+	void *candidates[HEAP_MAX_ARITY];
+	size_t offsets[HEAP_MAX_ARITY];
+	void **rest = candidates;
+	size_t *rest_offsets = offsets;
+	size_t count = last - first;
+	size_t kept = 0;
+	size_t i = 0;
+	unsigned long mask = 0;
+
+	for(i = 0; i < count; ++i)
+	{
+		candidates[i] = HeapSlot(heap, first + i)->data;
+		offsets[i] = i;
+	}
+
+	heap->comparisons += count;
+	mask = heap->batch(data, candidates, count);
+	for(;;)
+	{
+		/* Compacting in place without branches, kept never passes i */
+		for(kept = 0, i = 0; i < count; ++i)
+		{
+			candidates[kept] = rest[i];
+			offsets[kept] = rest_offsets[i];
+			kept += (mask >> i) & 1UL;
+		}
+
+		if(1 >= kept)
+		{
+			break;
+		}
+
+		count = kept - 1;
+		rest = candidates + 1;
+		rest_offsets = offsets + 1;
+		heap->comparisons += count;
+		mask = heap->batch(candidates[0], rest, count);
+		if(0 == mask)
+		{
+			break;
+		}
+	}
+
+	return (0 == kept ? last : first + offsets[0]);
+}
+
+/******************************************************************************
+ * @brief          Restores heap order after elements were appended past 
+ *                 old_size, bottom up when they are at least as many as the
+ *                 elements before them, one sift up each otherwise.
+ * @param heap     Pointer to the heap.
+ * @param old_size Number of elements already in heap order.
+ * @note           Time Complexity: O(n) bottom up, O(m log n) otherwise.
+******************************************************************************/
+static void HeapRebuild(heap_t *heap, size_t old_size)
+{
+	size_t index = 0;
+
+	if(heap->size - old_size >= old_size)
+	{
+		for(index = HEAP_FIRST_LEAF(heap); 0 < index; --index)
+		{
+			HeapSiftDown(heap, index - 1);
+		}
+	}
+	else
+	{
+		for(index = old_size; index < heap->size; ++index)
+		{
+			HeapSiftUp(heap, index);
+		}
+	}
+}
+/*****************************************************************************/
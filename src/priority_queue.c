@@ -2,22 +2,194 @@
  * @writer:      Tal Aharon
  * @date:        30.03.2023
  * 
- * @description: Implementation of a Priority Queue based on a Sorted List. A 
- * Priority Queue is a data structure that allows efficient retrieval and removal 
- * of elements based on their priority. The priority is determined using a user-
- * defined comparison function.
+ * @description: Implementation of a Priority Queue based on a Sorted List or a
+ * Binary Heap. A Priority Queue is a data structure that allows efficient 
+ * retrieval and removal of elements based on their priority. The priority is 
+ * determined using a user-defined comparison function.
+ *
+ * Built with PRIORITY_QUEUE_SOJOURN defined, every element is wrapped in a
+ * record holding the time it was enqueued, and every dequeue adds the time the
+ * element waited to the sojourn histogram of the stats. Without it the wrapping
+ * macros below expand to the element itself and nothing is measured.
  * 
 ******************************************************************************/
-#include <assert.h>           /* assert       */
-#include <stdlib.h>           /* malloc, free */
+#ifdef PRIORITY_QUEUE_SOJOURN
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <assert.h>           /* assert        */
+#include <stdlib.h>           /* malloc, free  */
+#include <string.h>           /* memset        */
+#ifdef PRIORITY_QUEUE_SOJOURN
+#include <time.h>             /* clock_gettime */
+#endif
 
 #include "sorted_list.h"      /* Internal API */
+#include "heap.h"             /* Internal API */
+#include "veb.h"              /* Internal API */
+#include "bucket_queue.h"     /* Internal API */
+#include "radix_sort.h"       /* Internal API */
 #include "priority_queue.h"   /* Internal API */
 /*****************************************************************************/
+#ifdef PRIORITY_QUEUE_SOJOURN
+
+/* The coarse clock is read from the vDSO without a syscall, at tick resolution */
+#ifndef PRIORITY_QUEUE_SOJOURN_CLOCK
+#ifdef CLOCK_MONOTONIC_COARSE
+#define PRIORITY_QUEUE_SOJOURN_CLOCK CLOCK_MONOTONIC_COARSE
+#else
+#define PRIORITY_QUEUE_SOJOURN_CLOCK CLOCK_MONOTONIC
+#endif
+#endif
+
+#define PRIORITY_QUEUE_COMPARE(compare) PriorityQueueElementCmp
+#define PRIORITY_QUEUE_WRAP(queue, data) PriorityQueueWrap(queue, data)
+#define PRIORITY_QUEUE_WRAP_FAILED(element) (NULL == (element))
+#define PRIORITY_QUEUE_DATA(element) (((priority_queue_element_t *)(element)) -> data)
+#define PRIORITY_QUEUE_UNWRAP(queue, element) PriorityQueueUnwrap(queue, element, PriorityQueueNow())
+#define PRIORITY_QUEUE_RELEASE(element) PriorityQueueRelease(element)
+#define PRIORITY_QUEUE_RELEASE_ALL(queue) PriorityQueueReleaseAll(queue)
+
+typedef struct priority_queue_element
+{
+	void *data;
+	priority_queue_compare_func_t compare;
+	unsigned long enqueued_us;
+
+} priority_queue_element_t;
+
+/* CoDel state, the names follow RFC 8289. Times are microsecond stamps */
+typedef struct priority_queue_codel
+{
+	unsigned long target_us;
+	unsigned long interval_us;
+	unsigned long first_above_us;
+	unsigned long drop_next_us;
+	size_t count;
+	size_t last_count;
+	int above;
+	int dropping;
+	priority_queue_drop_func_t drop;
+	void *parameter;
+
+} priority_queue_codel_t;
+
+#else
+
+#define PRIORITY_QUEUE_COMPARE(compare) (compare)
+#define PRIORITY_QUEUE_WRAP(queue, data) (data)
+#define PRIORITY_QUEUE_WRAP_FAILED(element) (0)
+#define PRIORITY_QUEUE_DATA(element) (element)
+#define PRIORITY_QUEUE_UNWRAP(queue, element) (element)
+#define PRIORITY_QUEUE_RELEASE(element) (element)
+#define PRIORITY_QUEUE_RELEASE_ALL(queue) ((void)0)
+
+#endif /* PRIORITY_QUEUE_SOJOURN */
+
+#define PRIORITY_QUEUE_DARY_ARITY (4)
+
+/* Smaller batches of a keyed queue go one by one, the sort would cost more.
+   Measured on random keys, a populated vEB gains from the sort from about
+   4096 elements on and the bucket queue from about 512 */
+#ifndef PRIORITY_QUEUE_RADIX_MIN_BATCH
+#define PRIORITY_QUEUE_RADIX_MIN_BATCH (4096)
+#endif
+
+#ifdef PRIORITY_QUEUE_CHECK_COMPARE
+#define PRIORITY_QUEUE_CHECK(queue, element) PriorityQueueCheckSample(queue, element)
+#else
+#define PRIORITY_QUEUE_CHECK(queue, element) ((void)0)
+#endif
+
+typedef struct priority_queue_bound
+{
+	size_t capacity;
+	priority_queue_overflow_t overflow;
+	priority_queue_drop_func_t evict;
+	void *parameter;
+
+} priority_queue_bound_t;
+
+typedef struct priority_queue_watermark
+{
+	size_t high;
+	size_t low;
+	int above;
+	priority_queue_watermark_func_t notify;
+	void *parameter;
+
+} priority_queue_watermark_t;
+
 struct priority_queue
 {
+	priority_queue_engine_t engine;
 	sorted_list_t *sorted_list;
-} priority_queue;
+	heap_t *heap;
+	veb_t *veb;
+	bucket_queue_t *buckets;
+	priority_queue_compare_func_t compare;
+	priority_queue_key_func_t key;
+	size_t size;
+	priority_queue_bound_t bound;
+	priority_queue_watermark_t watermark;
+	priority_queue_stats_t stats;
+	priority_queue_selector_t *selector;
+	heap_handle_t selector_handle;
+#ifdef PRIORITY_QUEUE_SOJOURN
+	priority_queue_codel_t codel;
+#endif
+};
+
+/* Every added queue stays in the heap, the empty ones sort last */
+struct priority_queue_selector
+{
+	heap_t *heap;
+	priority_queue_compare_func_t compare;
+};
+
+typedef struct priority_queue_scan
+{
+	priority_queue_ismatch_func_t ismatch;
+	void *parameter;
+	size_t visited;
+
+} priority_queue_scan_t;
+
+static priority_queue_t *PriorityQueueAlloc(priority_queue_compare_func_t compare, priority_queue_engine_t engine);
+static size_t PriorityQueueComparisons(const priority_queue_t *queue);
+static void PriorityQueueRecord(priority_queue_histogram_t *histogram, size_t value);
+static int PriorityQueueScanMatch(void *data, void *scan);
+static int PriorityQueuePush(priority_queue_t *queue, void *element);
+static int PriorityQueuePushBatch(priority_queue_t *queue, void **data, size_t count);
+#ifndef PRIORITY_QUEUE_SOJOURN
+static int PriorityQueuePushKeyed(priority_queue_t *queue, void **data, size_t count);
+#endif
+static void *PriorityQueuePop(priority_queue_t *queue);
+static void *PriorityQueueTop(const priority_queue_t *queue);
+static void *PriorityQueueBottom(priority_queue_t *queue, size_t *index);
+static void PriorityQueuePopBottom(priority_queue_t *queue, size_t index);
+static int PriorityQueueAdmit(priority_queue_t *queue, void *data);
+static int PriorityQueueOutranks(const priority_queue_t *queue, void *data, void *new_data);
+static void PriorityQueueResize(priority_queue_t *queue, size_t size);
+static int PriorityQueueSign(int value);
+static void PriorityQueueReselect(priority_queue_t *queue);
+static int PriorityQueueSelectorCmp(void *queue, void *new_queue);
+#ifdef PRIORITY_QUEUE_CHECK_COMPARE
+static void PriorityQueueCheckSample(const priority_queue_t *queue, void *element);
+#endif
+#ifdef PRIORITY_QUEUE_SOJOURN
+static void *PriorityQueueWrap(priority_queue_t *queue, void *data);
+static void *PriorityQueueUnwrap(priority_queue_t *queue, void *element, unsigned long now);
+static void *PriorityQueueRelease(void *element);
+static void PriorityQueueReleaseAll(priority_queue_t *queue);
+static int PriorityQueueReleaseEach(void *element, void *parameter);
+static int PriorityQueueElementCmp(void *element, void *new_element);
+static unsigned long PriorityQueueNow(void);
+static priority_queue_status_t PriorityQueueCodelDequeue(priority_queue_t *queue, void **data);
+static int PriorityQueueCodelPop(priority_queue_t *queue, unsigned long now, void **data);
+static void PriorityQueueCodelDrop(priority_queue_t *queue);
+static unsigned long PriorityQueueCodelControlLaw(const priority_queue_codel_t *codel, unsigned long time);
+#endif
 
 /******************************************************************************
  * @brief Creates a new priority queue.This function creates a new priority queue 
@@ -30,15 +202,115 @@ struct priority_queue
 ******************************************************************************/
 priority_queue_t *PriorityQueueCreate(priority_queue_compare_func_t compare)
 {
-	priority_queue_t *priority_queue = (priority_queue_t *)
-	malloc(sizeof(priority_queue_t *));
+	return PriorityQueueCreateEngine(compare, PRIORITY_QUEUE_SORTED_LIST);
+}
+
+/******************************************************************************
+ * @brief Creates a new priority queue backed by the given engine. Behaves like 
+ * PriorityQueueCreate, which is equivalent to using PRIORITY_QUEUE_SORTED_LIST.
+ * 
+ * @param compare Comparison function for element priority.
+ * @param engine  Engine used to keep the queue ordered.
+ * @return        Pointer to the newly created priority queue, or NULL on failure.
+ * @note          complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+priority_queue_t *PriorityQueueCreateEngine(priority_queue_compare_func_t compare, priority_queue_engine_t engine)
+{
+	priority_queue_t *priority_queue = PriorityQueueAlloc(compare, engine);
+	if(NULL == priority_queue)
+	{
+		return NULL;
+	}
+
+	switch(engine)
+	{
+		case PRIORITY_QUEUE_BINARY_HEAP:
+			priority_queue -> heap = HeapCreate(PRIORITY_QUEUE_COMPARE(compare));
+			break;
+
+		case PRIORITY_QUEUE_DARY_HEAP:
+			priority_queue -> heap = HeapCreateArity(PRIORITY_QUEUE_COMPARE(compare), PRIORITY_QUEUE_DARY_ARITY);
+			break;
+
+		case PRIORITY_QUEUE_VEB:
+		case PRIORITY_QUEUE_BUCKETS:
+			/* Without a key function there is nothing to order by */
+			break;
+
+		default:
+			priority_queue -> engine = PRIORITY_QUEUE_SORTED_LIST;
+			priority_queue -> sorted_list = SortedListCreate(PRIORITY_QUEUE_COMPARE(compare));
+			break;
+	}
+
+	if(NULL == priority_queue -> sorted_list && NULL == priority_queue -> heap &&
+	   NULL == priority_queue -> veb && NULL == priority_queue -> buckets)
+	{
+		free(priority_queue);
+		priority_queue = NULL;
+		return NULL;
+	}
+
+	return priority_queue;
+}
+
+/******************************************************************************
+ * @brief Creates a priority queue ordered by integer keys, the smallest first,
+ * backed by a van Emde Boas tree.
+ * 
+ * @param key  Key function of the elements.
+ * @param bits Number of bits of the keys, 1 to 32.
+ * @return     Pointer to the newly created priority queue, or NULL on failure.
+ * @note       complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+priority_queue_t *PriorityQueueCreateKeyed(priority_queue_key_func_t key, unsigned int bits)
+{
+	priority_queue_t *priority_queue = NULL;
+	assert(key && "Key is not valid");
+	assert(0 < bits && bits <= VEB_MAX_BITS && "Bits are not valid");
+
+	priority_queue = PriorityQueueAlloc(NULL, PRIORITY_QUEUE_VEB);
 	if(NULL == priority_queue)
 	{
 		return NULL;
 	}
 
-	priority_queue -> sorted_list = SortedListCreate(compare);
-	if(NULL == priority_queue -> sorted_list)
+	priority_queue -> key = key;
+	priority_queue -> veb = VebCreate(bits);
+	if(NULL == priority_queue -> veb)
+	{
+		free(priority_queue);
+		priority_queue = NULL;
+		return NULL;
+	}
+
+	return priority_queue;
+}
+
+/******************************************************************************
+ * @brief Creates a priority queue ordered by a small number of integer levels,
+ * the smallest first, backed by a bucket queue.
+ * 
+ * @param key    Key function of the elements, returning their level.
+ * @param levels Number of levels, 1 to PRIORITY_QUEUE_MAX_LEVELS.
+ * @return       Pointer to the newly created priority queue, or NULL on failure.
+ * @note         complexity   Time: O(levels / word bits), Space: O(levels)
+******************************************************************************/
+priority_queue_t *PriorityQueueCreateBuckets(priority_queue_key_func_t key, unsigned long levels)
+{
+	priority_queue_t *priority_queue = NULL;
+	assert(key && "Key is not valid");
+	assert(0 < levels && levels <= PRIORITY_QUEUE_MAX_LEVELS && "Levels are not valid");
+
+	priority_queue = PriorityQueueAlloc(NULL, PRIORITY_QUEUE_BUCKETS);
+	if(NULL == priority_queue)
+	{
+		return NULL;
+	}
+
+	priority_queue -> key = key;
+	priority_queue -> buckets = BucketQueueCreate(levels);
+	if(NULL == priority_queue -> buckets)
 	{
 		free(priority_queue);
 		priority_queue = NULL;
@@ -59,7 +331,32 @@ priority_queue_t *PriorityQueueCreate(priority_queue_compare_func_t compare)
 void PriorityQueueDestroy(priority_queue_t *queue)
 {
 	assert(queue && "Queue is not valid");
-	SortedListDestroy(queue -> sorted_list);
+	if(NULL != queue -> selector)
+	{
+		PriorityQueueSelectorRemove(queue -> selector, queue);
+	}
+
+	PRIORITY_QUEUE_RELEASE_ALL(queue);
+	switch(queue -> engine)
+	{
+		case PRIORITY_QUEUE_BINARY_HEAP:
+		case PRIORITY_QUEUE_DARY_HEAP:
+			HeapDestroy(queue -> heap);
+			break;
+
+		case PRIORITY_QUEUE_VEB:
+			VebDestroy(queue -> veb);
+			break;
+
+		case PRIORITY_QUEUE_BUCKETS:
+			BucketQueueDestroy(queue -> buckets);
+			break;
+
+		default:
+			SortedListDestroy(queue -> sorted_list);
+			break;
+	}
+
 	free(queue);
 	queue = NULL;
 }
@@ -72,15 +369,131 @@ void PriorityQueueDestroy(priority_queue_t *queue)
  *
  * @param queue Pointer to the priority queue.
  * @param data  Pointer to the data element to enqueue.
- * @return      0 on success, or a non-zero value on failure.
- * @note        complexity   Time: O(1), Space: O(1)
+ * @return      PRIORITY_QUEUE_SUCCESS, PRIORITY_QUEUE_FULL if the queue is at 
+ *              capacity and could not make room, or PRIORITY_QUEUE_NO_MEMORY.
+ * @note        complexity   Time: O(n) sorted list, O(log n) heap, O(n) heap
+ *                           evicting, Space: O(1)
 ******************************************************************************/
 int PriorityQueueEnqueue(priority_queue_t *queue, void *data)
 {
-	sorted_list_iter_t insert = {0};
+	void *element = NULL;
+	assert(queue && "Queue is not valid");
+
+	if(PriorityQueueAdmit(queue, data))
+	{
+		return PRIORITY_QUEUE_FULL;
+	}
+
+	element = PRIORITY_QUEUE_WRAP(queue, data);
+	if(PRIORITY_QUEUE_WRAP_FAILED(element))
+	{
+		return PRIORITY_QUEUE_NO_MEMORY;
+	}
+
+	if(PriorityQueuePush(queue, element))
+	{
+		(void)PRIORITY_QUEUE_RELEASE(element);
+		return PRIORITY_QUEUE_NO_MEMORY;
+	}
+
+	++queue -> stats.enqueued;
+	return PRIORITY_QUEUE_SUCCESS;
+}
+
+/******************************************************************************
+ * @brief Adds an element to the priority queue and returns a handle to it. The 
+ * handle keeps referring to the element while the queue reorders itself.
+ *
+ * @param queue Pointer to the priority queue.
+ * @param data  Pointer to the data element to enqueue.
+ * @return      Handle to the enqueued element, or NULL on failure, if the queue
+ *              is full or if the engine does not support handles.
+ * @note        complexity   Time: O(log n), O(n) evicting, Space: O(1)
+******************************************************************************/
+priority_queue_handle_t PriorityQueueEnqueueHandle(priority_queue_t *queue, void *data)
+{
+	size_t comparisons = 0;
+	void *element = NULL;
+	heap_handle_t handle = NULL;
+	assert(queue && "Queue is not valid");
+	switch(queue -> engine)
+	{
+		case PRIORITY_QUEUE_BINARY_HEAP:
+		case PRIORITY_QUEUE_DARY_HEAP:
+			if(PriorityQueueAdmit(queue, data))
+			{
+				return NULL;
+			}
+
+			element = PRIORITY_QUEUE_WRAP(queue, data);
+			if(PRIORITY_QUEUE_WRAP_FAILED(element))
+			{
+				return NULL;
+			}
+
+			PRIORITY_QUEUE_CHECK(queue, element);
+			comparisons = HeapComparisons(queue -> heap);
+			handle = HeapPushHandle(queue -> heap, element);
+			PriorityQueueRecord(&queue -> stats.insert_comparisons, HeapComparisons(queue -> heap) - comparisons);
+			if(NULL == handle)
+			{
+				(void)PRIORITY_QUEUE_RELEASE(element);
+				return NULL;
+			}
+
+			++queue -> stats.enqueued;
+			PriorityQueueResize(queue, queue -> size + 1);
+			return (priority_queue_handle_t)handle;
+
+		default:
+			/* List nodes swap data on insert and remove and keyed items are
+			   found by key, neither can be a handle */
+			return NULL;
+	}
+}
+
+/******************************************************************************
+ * @brief Removes the element owning the handle from the queue.
+ *
+ * @param queue  Pointer to the priority queue.
+ * @param handle Valid handle returned by PriorityQueueEnqueueHandle.
+ * @return       Pointer to the data of the removed element.
+ * @note         complexity   Time: O(log n), Space: O(1)
+******************************************************************************/
+void *PriorityQueueEraseHandle(priority_queue_t *queue, priority_queue_handle_t handle)
+{
+	void *element = NULL;
+	assert(queue && "Queue is not valid");
+	assert(handle && "Handle is not valid");
+	assert(NULL != queue -> heap && "Engine has no handles");
+
+	element = HeapRemoveHandle(queue -> heap, (heap_handle_t)handle);
+	++queue -> stats.dequeued;
+	PriorityQueueResize(queue, queue -> size - 1);
+	return PRIORITY_QUEUE_RELEASE(element);
+}
+
+/******************************************************************************
+ * @brief Replaces the data of the element owning the handle and moves it to the 
+ * position matching its new priority. The handle stays valid.
+ *
+ * @param queue  Pointer to the priority queue.
+ * @param handle Valid handle returned by PriorityQueueEnqueueHandle.
+ * @param data   Pointer to the new data element.
+ * @note         complexity   Time: O(log n), Space: O(1)
+******************************************************************************/
+void PriorityQueueUpdateHandle(priority_queue_t *queue, priority_queue_handle_t handle, void *data)
+{
 	assert(queue && "Queue is not valid");
-	insert = SortedListInsert(queue -> sorted_list, data);
-	return (SortedListIsEqual(SortedListEnd(queue -> sorted_list), insert));
+	assert(handle && "Handle is not valid");
+	assert(NULL != queue -> heap && "Engine has no handles");
+#ifdef PRIORITY_QUEUE_SOJOURN
+	/* The record stays, so the element keeps its enqueue time */
+	PRIORITY_QUEUE_DATA(HeapHandleData(queue -> heap, (heap_handle_t)handle)) = data;
+	data = HeapHandleData(queue -> heap, (heap_handle_t)handle);
+#endif
+	HeapUpdateHandle(queue -> heap, (heap_handle_t)handle, data);
+	PriorityQueueReselect(queue);
 }
 
 /******************************************************************************
@@ -90,12 +503,15 @@ int PriorityQueueEnqueue(priority_queue_t *queue, void *data)
  *
  * @param queue Pointer to the priority queue.
  * @return      Pointer to the data of the dequeued element, or NULL if the queue is empty.
- * @note        complexity   Time: O(1), Space: O(1)
+ * @note        complexity   Time: O(1) sorted list, O(log n) heap, Space: O(1)
 ******************************************************************************/
 void *PriorityQueueDequeue(priority_queue_t *queue)
 {
+	void *data = NULL;
 	assert(queue && "Queue is not valid");
-	return SortedListPopFront(queue -> sorted_list);
+
+	(void)PriorityQueueDequeueInto(queue, &data);
+	return data;
 }
 
 /******************************************************************************
@@ -110,8 +526,11 @@ void *PriorityQueueDequeue(priority_queue_t *queue)
 ******************************************************************************/
 void *PriorityQueuePeek(const priority_queue_t *queue)
 {
+	void *data = NULL;
 	assert(queue && "Queue is not valid");
-	return SortedListGetData(SortedListBegin(queue -> sorted_list));
+
+	(void)PriorityQueuePeekInto(queue, &data);
+	return data;
 }
 
 /******************************************************************************
@@ -125,7 +544,21 @@ void *PriorityQueuePeek(const priority_queue_t *queue)
 int PriorityQueueIsEmpty(const priority_queue_t *queue)
 {
 	assert(queue && "Queue is not valid");
-	return SortedListIsEmpty(queue -> sorted_list);
+	switch(queue -> engine)
+	{
+		case PRIORITY_QUEUE_BINARY_HEAP:
+		case PRIORITY_QUEUE_DARY_HEAP:
+			return HeapIsEmpty(queue -> heap);
+
+		case PRIORITY_QUEUE_VEB:
+			return 0 == VebSize(queue -> veb);
+
+		case PRIORITY_QUEUE_BUCKETS:
+			return 0 == BucketQueueSize(queue -> buckets);
+
+		default:
+			return SortedListIsEmpty(queue -> sorted_list);
+	}
 }
 
 /******************************************************************************
@@ -134,12 +567,12 @@ int PriorityQueueIsEmpty(const priority_queue_t *queue)
  * 
  * @param queue Pointer to the priority queue.
  * @return      The number of elements in the queue.
- * @note        complexity   Time: O(n), Space: O(1)
+ * @note        complexity   Time: O(1), Space: O(1)
 ******************************************************************************/
 size_t PriorityQueueSize(const priority_queue_t *queue)
 {
 	assert(queue && "Queue is not valid");
-	return SortedListCount(queue -> sorted_list);
+	return queue -> size;
 }
 
 /******************************************************************************
@@ -159,32 +592,1615 @@ size_t PriorityQueueSize(const priority_queue_t *queue)
 void *PriorityQueueErase(priority_queue_t *queue, priority_queue_ismatch_func_t ismatch, void *parameter)
 {
 	void *data = NULL;
+	assert(queue && "Queue is not valid");
+
+	if(PRIORITY_QUEUE_SUCCESS != PriorityQueueEraseInto(queue, ismatch, parameter, &data))
+	{
+		return (void *)queue;
+	}
+
+	return data;
+}
+
+/******************************************************************************
+ * @brief Removes the highest-priority element, reporting an empty queue by 
+ * status.
+ *
+ * @param queue Pointer to the priority queue.
+ * @param data  Receives the data of the dequeued element.
+ * @return      PRIORITY_QUEUE_SUCCESS, or PRIORITY_QUEUE_EMPTY.
+ * @note        complexity   Time: O(1) sorted list, O(log n) heap, Space: O(1)
+******************************************************************************/
+priority_queue_status_t PriorityQueueDequeueInto(priority_queue_t *queue, void **data)
+{
+	assert(queue && "Queue is not valid");
+	assert(data && "Data is not valid");
+
+	/* Popping the end of an empty list is undefined */
+	if(0 == queue -> size)
+	{
+		return PRIORITY_QUEUE_EMPTY;
+	}
+
+#ifdef PRIORITY_QUEUE_SOJOURN
+	if(0 != queue -> codel.interval_us)
+	{
+		return PriorityQueueCodelDequeue(queue, data);
+	}
+#endif
+
+	*data = PRIORITY_QUEUE_UNWRAP(queue, PriorityQueuePop(queue));
+	++queue -> stats.dequeued;
+	return PRIORITY_QUEUE_SUCCESS;
+}
+
+/******************************************************************************
+ * @brief Removes the lowest-priority element, the one an evicting queue at 
+ * capacity gives up first.
+ *
+ * @param queue Pointer to the priority queue.
+ * @param data  Receives the data of the removed element.
+ * @return      PRIORITY_QUEUE_SUCCESS, or PRIORITY_QUEUE_EMPTY.
+ * @note        complexity   Time: O(1) sorted list and buckets, O(log log U) 
+ *                           vEB, O(n) heap, Space: O(1)
+******************************************************************************/
+priority_queue_status_t PriorityQueueDequeueLast(priority_queue_t *queue, void **data)
+{
+	size_t index = 0;
+	void *element = NULL;
+	assert(queue && "Queue is not valid");
+	assert(data && "Data is not valid");
+
+	if(0 == queue -> size)
+	{
+		return PRIORITY_QUEUE_EMPTY;
+	}
+
+	element = PriorityQueueBottom(queue, &index);
+	PriorityQueuePopBottom(queue, index);
+	++queue -> stats.dequeued;
+	*data = PRIORITY_QUEUE_UNWRAP(queue, element);
+	return PRIORITY_QUEUE_SUCCESS;
+}
+
+/******************************************************************************
+ * @brief Retrieves the highest-priority element without removing it.
+ *
+ * @param queue Pointer to the priority queue.
+ * @param data  Receives the data of the element.
+ * @return      PRIORITY_QUEUE_SUCCESS, or PRIORITY_QUEUE_EMPTY.
+ * @note        complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+priority_queue_status_t PriorityQueuePeekInto(const priority_queue_t *queue, void **data)
+{
+	assert(queue && "Queue is not valid");
+	assert(data && "Data is not valid");
+	if(0 == queue -> size)
+	{
+		return PRIORITY_QUEUE_EMPTY;
+	}
+
+	*data = PRIORITY_QUEUE_DATA(PriorityQueueTop(queue));
+	return PRIORITY_QUEUE_SUCCESS;
+}
+
+/******************************************************************************
+ * @brief Removes the first element the matching function accepts.
+ *
+ * @param queue     Pointer to the priority queue.
+ * @param ismatch   Matching function to determine if an element should be removed.
+ * @param parameter User-defined parameter to pass to the ismatch function.
+ * @param data      Receives the data of the removed element.
+ * @return          PRIORITY_QUEUE_SUCCESS, or PRIORITY_QUEUE_NOT_FOUND.
+ * @note            complexity   Time: O(n), Space: O(1)
+******************************************************************************/
+priority_queue_status_t PriorityQueueEraseInto(priority_queue_t *queue, priority_queue_ismatch_func_t ismatch, void *parameter, void **data)
+{
+	void *element = NULL;
+	size_t index = 0;
+	int missing = 0;
 	sorted_list_iter_t result = {0};
+	priority_queue_scan_t scan = {NULL, NULL, 0};
 	assert(queue && "Queue is not valid");
+	assert(data && "Data is not valid");
+
+	/* The match is wrapped to count the elements the search visits */
+	scan.ismatch = ismatch;
+	scan.parameter = parameter;
+	if(NULL != queue -> heap)
+	{
+		index = HeapFindIf(queue -> heap, PriorityQueueScanMatch, &scan);
+		PriorityQueueRecord(&queue -> stats.scan_length, scan.visited);
+		if(index == HeapSize(queue -> heap))
+		{
+			return PRIORITY_QUEUE_NOT_FOUND;
+		}
+
+		element = HeapRemoveAt(queue -> heap, index);
+		++queue -> stats.dequeued;
+		PriorityQueueResize(queue, queue -> size - 1);
+		*data = PRIORITY_QUEUE_RELEASE(element);
+		return PRIORITY_QUEUE_SUCCESS;
+	}
+
+	if(NULL != queue -> veb || NULL != queue -> buckets)
+	{
+		missing = NULL != queue -> veb ?
+		VebRemoveIf(queue -> veb, PriorityQueueScanMatch, &scan, &element) :
+		BucketQueueRemoveIf(queue -> buckets, PriorityQueueScanMatch, &scan, &element);
+		PriorityQueueRecord(&queue -> stats.scan_length, scan.visited);
+		if(missing)
+		{
+			return PRIORITY_QUEUE_NOT_FOUND;
+		}
+
+		++queue -> stats.dequeued;
+		PriorityQueueResize(queue, queue -> size - 1);
+		*data = PRIORITY_QUEUE_RELEASE(element);
+		return PRIORITY_QUEUE_SUCCESS;
+	}
 
 	result = SortedListFindIf(SortedListBegin(queue -> sorted_list),
-	SortedListEnd(queue -> sorted_list), ismatch, parameter);
+	SortedListEnd(queue -> sorted_list), PriorityQueueScanMatch, &scan);
+	PriorityQueueRecord(&queue -> stats.scan_length, scan.visited);
 	if(SortedListIsEqual(result, SortedListEnd(queue -> sorted_list)))
 	{
-		return (void *)queue;
+		return PRIORITY_QUEUE_NOT_FOUND;
 	}
 
-	data = SortedListGetData(result);
+	element = SortedListGetData(result);
 	SortedListRemove(result);
-	return data;
+	++queue -> stats.dequeued;
+	PriorityQueueResize(queue, queue -> size - 1);
+	*data = PRIORITY_QUEUE_RELEASE(element);
+	return PRIORITY_QUEUE_SUCCESS;
 }
 
 /******************************************************************************
- * @brief Clears all elements from the priority queue. This function removes 
- * all elements from the priority queue, leaving it empty.
+ * @brief Finds the first element of the smallest key not below a value.
+ *
+ * @param queue Pointer to a keyed priority queue.
+ * @param key   Value to search from.
+ * @param data  Receives the data of the element.
+ * @return      PRIORITY_QUEUE_SUCCESS, or PRIORITY_QUEUE_NOT_FOUND.
+ * @note        complexity   Time: O(log log U) vEB, O(1) buckets, Space: O(1)
+******************************************************************************/
+priority_queue_status_t PriorityQueueFindNext(const priority_queue_t *queue, unsigned long key, void **data)
+{
+	void *element = NULL;
+	assert(queue && "Queue is not valid");
+	assert(NULL != queue -> key && "Queue is not keyed");
+	assert(data && "Data is not valid");
+
+	if(NULL != queue -> veb ? VebFindNext(queue -> veb, key, &element) :
+	   BucketQueueFindNext(queue -> buckets, key, &element))
+	{
+		return PRIORITY_QUEUE_NOT_FOUND;
+	}
+
+	*data = PRIORITY_QUEUE_DATA(element);
+	return PRIORITY_QUEUE_SUCCESS;
+}
+
+/******************************************************************************
+ * @brief Finds the first element of the largest key not above a value.
+ *
+ * @param queue Pointer to a keyed priority queue.
+ * @param key   Value to search from.
+ * @param data  Receives the data of the element.
+ * @return      PRIORITY_QUEUE_SUCCESS, or PRIORITY_QUEUE_NOT_FOUND.
+ * @note        complexity   Time: O(log log U) vEB, O(1) buckets, Space: O(1)
+******************************************************************************/
+priority_queue_status_t PriorityQueueFindPrev(const priority_queue_t *queue, unsigned long key, void **data)
+{
+	void *element = NULL;
+	assert(queue && "Queue is not valid");
+	assert(NULL != queue -> key && "Queue is not keyed");
+	assert(data && "Data is not valid");
+
+	if(NULL != queue -> veb ? VebFindPrev(queue -> veb, key, &element) :
+	   BucketQueueFindPrev(queue -> buckets, key, &element))
+	{
+		return PRIORITY_QUEUE_NOT_FOUND;
+	}
+
+	*data = PRIORITY_QUEUE_DATA(element);
+	return PRIORITY_QUEUE_SUCCESS;
+}
+
+/******************************************************************************
+ * @brief Enqueues count elements, every one with its own status.
+ *
+ * @param queue    Pointer to the priority queue.
+ * @param data     Array of count data elements.
+ * @param count    Number of elements.
+ * @param statuses Receives the status of every element, may be NULL.
+ * @return         Number of elements enqueued.
+ * @note           complexity   Time: O(count) times the enqueue, O(n + count)
+ *                              heap, O(count) per key byte buckets, Space: 
+ *                              O(count) keyed engines, O(1) otherwise
+******************************************************************************/
+size_t PriorityQueueEnqueueBatch(priority_queue_t *queue, void **data, size_t count, priority_queue_status_t *statuses)
+{
+	size_t i = 0;
+	size_t enqueued = 0;
+	priority_queue_status_t status = PRIORITY_QUEUE_SUCCESS;
+	assert(queue && "Queue is not valid");
+	assert((data || 0 == count) && "Data is not valid");
+
+	if(0 == PriorityQueuePushBatch(queue, data, count))
+	{
+		queue -> stats.enqueued += count;
+		for(i = 0; NULL != statuses && i < count; ++i)
+		{
+			statuses[i] = PRIORITY_QUEUE_SUCCESS;
+		}
+
+		return count;
+	}
+
+	for(i = 0; i < count; ++i)
+	{
+		status = (priority_queue_status_t)PriorityQueueEnqueue(queue, data[i]);
+		enqueued += (PRIORITY_QUEUE_SUCCESS == status);
+		if(NULL != statuses)
+		{
+			statuses[i] = status;
+		}
+	}
+
+	return enqueued;
+}
+
+/******************************************************************************
+ * @brief Dequeues up to count elements, highest priority first.
  *
  * @param queue Pointer to the priority queue.
- * @note        complexity   Time: O(n), Space: O(1)
+ * @param data  Receives the data of the dequeued elements.
+ * @param count Maximal number of elements to dequeue.
+ * @return      Number of elements dequeued.
+ * @note        complexity   Time: O(count) sorted list, O(count log n) heap,
+ *                           Space: O(1)
 ******************************************************************************/
-void PriorityQueueClear(priority_queue_t *queue)
+size_t PriorityQueueDequeueBatch(priority_queue_t *queue, void **data, size_t count)
 {
+	size_t dequeued = 0;
 	assert(queue && "Queue is not valid");
-	for(; !SortedListIsEmpty(queue -> sorted_list); SortedListPopFront(queue -> sorted_list));
-	return;
+	assert((data || 0 == count) && "Data is not valid");
+
+	while(dequeued < count && PRIORITY_QUEUE_SUCCESS == PriorityQueueDequeueInto(queue, &data[dequeued]))
+	{
+		++dequeued;
+	}
+
+	return dequeued;
+}
+
+/******************************************************************************
+ * @brief Moves all elements of the source queue into the destination queue, 
+ * leaving the source empty. Queues of the same engine are merged in place, 
+ * otherwise elements are moved one by one, highest priority first.
+ *
+ * @param dest   Pointer to the priority queue receiving the elements.
+ * @param source Pointer to the priority queue giving the elements.
+ * @return       0 on success, PRIORITY_QUEUE_FULL if the elements would not fit
+ *               the capacity of dest, or PRIORITY_QUEUE_NO_MEMORY.
+ * @note         complexity   Time: O(n + m) two sorted lists, O(n + m) or 
+ *                            O(m log(n + m)) two heaps, Space: O(1)
+******************************************************************************/
+int PriorityQueueMerge(priority_queue_t *dest, priority_queue_t *source)
+{
+	int status = 0;
+	size_t size = 0;
+	void *element = NULL;
+	assert(dest && "Queue is not valid");
+	assert(source && "Queue is not valid");
+	assert(dest != source && "Queue can not merge into itself");
+
+	if(0 != dest -> bound.capacity && dest -> bound.capacity - dest -> size < source -> size)
+	{
+		return PRIORITY_QUEUE_FULL;
+	}
+
+	if(dest -> engine == source -> engine)
+	{
+		switch(dest -> engine)
+		{
+			case PRIORITY_QUEUE_BINARY_HEAP:
+			case PRIORITY_QUEUE_DARY_HEAP:
+				/* Source first, so a selector holding both never reads an emptied head */
+				status = HeapMerge(dest -> heap, source -> heap);
+				PriorityQueueResize(source, HeapSize(source -> heap));
+				PriorityQueueResize(dest, HeapSize(dest -> heap));
+				return 0 == status ? 0 : PRIORITY_QUEUE_NO_MEMORY;
+
+			case PRIORITY_QUEUE_VEB:
+			case PRIORITY_QUEUE_BUCKETS:
+				/* Keyed engines do not merge faster than one key at a time */
+				break;
+
+			default:
+				SortedListMerge(dest -> sorted_list, source -> sorted_list);
+				size = dest -> size + source -> size;
+				PriorityQueueResize(source, 0);
+				PriorityQueueResize(dest, size);
+				return 0;
+		}
+	}
+
+	/* Peek before dequeue so a failed enqueue loses nothing */
+	while(!PriorityQueueIsEmpty(source))
+	{
+		element = PriorityQueueTop(source);
+		if(PriorityQueuePush(dest, element))
+		{
+			return PRIORITY_QUEUE_NO_MEMORY;
+		}
+
+		PriorityQueuePop(source);
+	}
+
+	return 0;
+}
+
+/******************************************************************************
+ * @brief Clears all elements from the priority queue. This function removes 
+ * all elements from the priority queue, leaving it empty.
+ *
+ * @param queue Pointer to the priority queue.
+ * @note        complexity   Time: O(n), Space: O(1)
+******************************************************************************/
+void PriorityQueueClear(priority_queue_t *queue)
+{
+	assert(queue && "Queue is not valid");
+	PRIORITY_QUEUE_RELEASE_ALL(queue);
+	if(NULL != queue -> heap)
+	{
+		HeapClear(queue -> heap);
+	}
+	else if(NULL != queue -> veb)
+	{
+		VebClear(queue -> veb);
+	}
+	else if(NULL != queue -> buckets)
+	{
+		BucketQueueClear(queue -> buckets);
+	}
+	else
+	{
+		for(; !SortedListIsEmpty(queue -> sorted_list); SortedListPopFront(queue -> sorted_list));
+	}
+
+	PriorityQueueResize(queue, 0);
+}
+
+/******************************************************************************
+ * @brief Copies the operation cost histograms recorded by the queue.
+ *
+ * @param queue Pointer to the priority queue.
+ * @param stats Receives the histograms.
+ * @note        complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+void PriorityQueueStats(const priority_queue_t *queue, priority_queue_stats_t *stats)
+{
+	assert(queue && "Queue is not valid");
+	assert(stats && "Stats are not valid");
+	*stats = queue -> stats;
+}
+
+/******************************************************************************
+ * @brief Clears the operation cost histograms of the queue.
+ *
+ * @param queue Pointer to the priority queue.
+ * @note        complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+void PriorityQueueStatsReset(priority_queue_t *queue)
+{
+	assert(queue && "Queue is not valid");
+	memset(&queue -> stats, 0, sizeof(priority_queue_stats_t));
+}
+
+/******************************************************************************
+ * @brief Turns on CoDel active queue management at dequeue.
+ *
+ * @param queue       Pointer to the priority queue.
+ * @param target_us   Acceptable time in queue, in microseconds.
+ * @param interval_us Time above target before dropping starts, zero turns
+ *                    dropping off.
+ * @param drop        Function receiving the dropped elements, may be NULL.
+ * @param parameter   User-defined parameter passed to the drop function.
+ * @return            0 on success, or a non-zero value without sojourn times.
+ * @note              complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+int PriorityQueueSetCodel(priority_queue_t *queue, unsigned long target_us, unsigned long interval_us, priority_queue_drop_func_t drop, void *parameter)
+{
+	assert(queue && "Queue is not valid");
+#ifdef PRIORITY_QUEUE_SOJOURN
+	memset(&queue -> codel, 0, sizeof(priority_queue_codel_t));
+	queue -> codel.target_us = target_us;
+	queue -> codel.interval_us = interval_us;
+	queue -> codel.drop = drop;
+	queue -> codel.parameter = parameter;
+	return 0;
+#else
+	(void)queue;
+	(void)target_us;
+	(void)interval_us;
+	(void)drop;
+	(void)parameter;
+	return 1;
+#endif
+}
+
+/******************************************************************************
+ * @brief Bounds the number of elements the queue holds.
+ *
+ * @param queue     Pointer to the priority queue.
+ * @param capacity  Maximal number of elements, zero for no bound.
+ * @param overflow  What an enqueue into a full queue does.
+ * @param evict     Function receiving the evicted elements, may be NULL.
+ * @param parameter User-defined parameter passed to the evict function.
+ * @return          0 on success, or a non-zero value if the queue already holds
+ *                  more than capacity elements.
+ * @note            complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+int PriorityQueueSetCapacity(priority_queue_t *queue, size_t capacity, priority_queue_overflow_t overflow, priority_queue_drop_func_t evict, void *parameter)
+{
+	assert(queue && "Queue is not valid");
+	if(0 != capacity && capacity < queue -> size)
+	{
+		return 1;
+	}
+
+	queue -> bound.capacity = capacity;
+	queue -> bound.overflow = overflow;
+	queue -> bound.evict = evict;
+	queue -> bound.parameter = parameter;
+	return 0;
+}
+
+/******************************************************************************
+ * @brief Sets watermarks for backpressure.
+ *
+ * @param queue     Pointer to the priority queue.
+ * @param high      Size that reports the queue as high, zero turns the 
+ *                  watermarks off.
+ * @param low       Size that reports the queue as drained, lower than high.
+ * @param watermark Function told about the crossings.
+ * @param parameter User-defined parameter passed to the watermark function.
+ * @note            complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+void PriorityQueueSetWatermarks(priority_queue_t *queue, size_t high, size_t low, priority_queue_watermark_func_t watermark, void *parameter)
+{
+	assert(queue && "Queue is not valid");
+	assert((0 == high || (low < high && watermark)) && "Watermarks are not valid");
+
+	queue -> watermark.high = high;
+	queue -> watermark.low = low;
+	queue -> watermark.above = 0;
+	queue -> watermark.notify = watermark;
+	queue -> watermark.parameter = parameter;
+	PriorityQueueResize(queue, queue -> size);
+}
+
+/******************************************************************************
+ * @brief Reports the memory footprint of the queue.
+ *
+ * @param queue Pointer to the priority queue.
+ * @param usage Receives the bytes by category.
+ * @note        complexity   Time: O(n) for the sorted list, O(1) for the heap,
+ *                           Space: O(1)
+******************************************************************************/
+void PriorityQueueMemoryUsage(const priority_queue_t *queue, priority_queue_memory_t *usage)
+{
+	size_t bytes = 0;
+	size_t blocks = 0;
+	assert(queue && "Queue is not valid");
+	assert(usage && "Usage is not valid");
+
+	usage -> spare = 0;
+	switch(queue -> engine)
+	{
+		case PRIORITY_QUEUE_BINARY_HEAP:
+		case PRIORITY_QUEUE_DARY_HEAP:
+			bytes = HeapMemoryUsage(queue -> heap, &usage -> nodes, &usage -> spare, &blocks);
+			break;
+
+		case PRIORITY_QUEUE_VEB:
+			bytes = VebMemoryUsage(queue -> veb, &usage -> nodes, &usage -> spare, &blocks);
+			break;
+
+		case PRIORITY_QUEUE_BUCKETS:
+			bytes = BucketQueueMemoryUsage(queue -> buckets, &usage -> nodes, &usage -> spare, &blocks);
+			break;
+
+		default:
+			bytes = SortedListMemoryUsage(queue -> sorted_list, &usage -> nodes, &blocks);
+			break;
+	}
+
+#ifdef PRIORITY_QUEUE_SOJOURN
+	bytes += PriorityQueueSize(queue) * sizeof(priority_queue_element_t);
+	usage -> nodes += PriorityQueueSize(queue) * sizeof(priority_queue_element_t);
+	blocks += PriorityQueueSize(queue);
+#endif
+
+	usage -> index = sizeof(priority_queue_t) + bytes - usage -> nodes - usage -> spare;
+	usage -> overhead = (blocks + 1) * sizeof(size_t);
+}
+
+/******************************************************************************
+ * @brief Sets a batch compare function for the heap engines.
+ *
+ * @param queue Pointer to the priority queue.
+ * @param batch Batch compare function agreeing with the compare function, or
+ *              NULL to compare one pair at a time.
+ * @return      0 if the engine uses it, or a non-zero value otherwise.
+ * @note        complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+int PriorityQueueSetCompareBatch(priority_queue_t *queue, priority_queue_compare_batch_func_t batch)
+{
+	assert(queue && "Queue is not valid");
+#ifdef PRIORITY_QUEUE_SOJOURN
+	(void)queue;
+	(void)batch;
+	return 1;
+#else
+	if(NULL == queue -> heap)
+	{
+		return 1;
+	}
+
+	HeapSetCompareBatch(queue -> heap, batch);
+	return 0;
+#endif
+}
+
+/******************************************************************************
+ * @brief Creates a selector over the heads of queues.
+ *
+ * @param compare Comparison function applied to the heads of the queues.
+ * @return        Pointer to the selector, or NULL on failure.
+ * @note          complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+priority_queue_selector_t *PriorityQueueSelectorCreate(priority_queue_compare_func_t compare)
+{
+	priority_queue_selector_t *selector = (priority_queue_selector_t *)
+	malloc(sizeof(priority_queue_selector_t));
+	if(NULL == selector)
+	{
+		return NULL;
+	}
+
+	selector -> compare = compare;
+	selector -> heap = HeapCreate(PriorityQueueSelectorCmp);
+	if(NULL == selector -> heap)
+	{
+		free(selector);
+		selector = NULL;
+		return NULL;
+	}
+
+	return selector;
+}
+
+/******************************************************************************
+ * @brief Destroys a selector and releases the queues still added to it.
+ *
+ * @param selector Pointer to the selector.
+ * @note           complexity   Time: O(n), Space: O(1)
+******************************************************************************/
+void PriorityQueueSelectorDestroy(priority_queue_selector_t *selector)
+{
+	size_t i = 0;
+	priority_queue_t *queue = NULL;
+	assert(selector && "Selector is not valid");
+
+	for(i = 0; i < HeapSize(selector -> heap); ++i)
+	{
+		queue = (priority_queue_t *)HeapDataAt(selector -> heap, i);
+		queue -> selector = NULL;
+		queue -> selector_handle = NULL;
+	}
+
+	HeapDestroy(selector -> heap);
+	free(selector);
+	selector = NULL;
+}
+
+/******************************************************************************
+ * @brief Adds a queue to a selector.
+ *
+ * @param selector Pointer to the selector.
+ * @param queue    Queue that is not added to any selector.
+ * @return         PRIORITY_QUEUE_SUCCESS or PRIORITY_QUEUE_NO_MEMORY.
+ * @note           complexity   Time: O(log n), Space: O(1)
+******************************************************************************/
+priority_queue_status_t PriorityQueueSelectorAdd(priority_queue_selector_t *selector, priority_queue_t *queue)
+{
+	assert(selector && "Selector is not valid");
+	assert(queue && "Queue is not valid");
+	assert(NULL == queue -> selector && "Queue is already added to a selector");
+
+	/* The comparisons of the push read the selector of the new queue */
+	queue -> selector = selector;
+	queue -> selector_handle = HeapPushHandle(selector -> heap, queue);
+	if(NULL == queue -> selector_handle)
+	{
+		queue -> selector = NULL;
+		return PRIORITY_QUEUE_NO_MEMORY;
+	}
+
+	return PRIORITY_QUEUE_SUCCESS;
+}
+
+/******************************************************************************
+ * @brief Removes a queue from its selector.
+ *
+ * @param selector Pointer to the selector.
+ * @param queue    Queue added to the selector, any other is left alone.
+ * @note           complexity   Time: O(log n), Space: O(1)
+******************************************************************************/
+void PriorityQueueSelectorRemove(priority_queue_selector_t *selector, priority_queue_t *queue)
+{
+	assert(selector && "Selector is not valid");
+	assert(queue && "Queue is not valid");
+
+	/* A queue of another selector holds no handle of this heap */
+	if(selector != queue -> selector)
+	{
+		return;
+	}
+
+	HeapRemoveHandle(selector -> heap, queue -> selector_handle);
+	queue -> selector = NULL;
+	queue -> selector_handle = NULL;
+}
+
+/******************************************************************************
+ * @brief Returns the queue holding the best head.
+ *
+ * @param selector Pointer to the selector.
+ * @return         The queue, or NULL if every queue is empty or none is added.
+ * @note           complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+priority_queue_t *PriorityQueueSelectorPeek(const priority_queue_selector_t *selector)
+{
+	priority_queue_t *queue = NULL;
+	assert(selector && "Selector is not valid");
+
+	queue = (priority_queue_t *)HeapPeek(selector -> heap);
+	return (NULL != queue && 0 < queue -> size) ? queue : NULL;
+}
+
+/******************************************************************************
+ * @brief Compares keys stored in the data pointers as size_t, the larger key
+ * is dequeued first.
+ *
+ * @param data     Existing key, cast to a pointer.
+ * @param new_data New key, cast to a pointer.
+ * @return         1, -1 or 0 as described by priority_queue_compare_func_t.
+ * @note           complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+int PriorityQueueCompareSize(void *data, void *new_data)
+{
+	return ((size_t)new_data > (size_t)data) - ((size_t)new_data < (size_t)data);
+}
+
+/******************************************************************************
+ * @brief Compares signed keys stored in the data pointers as long, the larger
+ * key is dequeued first.
+ *
+ * @param data     Existing key, cast to a pointer.
+ * @param new_data New key, cast to a pointer.
+ * @return         1, -1 or 0 as described by priority_queue_compare_func_t.
+ * @note           complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+int PriorityQueueCompareLong(void *data, void *new_data)
+{
+	return ((long)new_data > (long)data) - ((long)new_data < (long)data);
+}
+
+/******************************************************************************
+ * @brief Compares the ints the data points to, the larger int is dequeued
+ * first.
+ *
+ * @param data     Pointer to the existing int.
+ * @param new_data Pointer to the new int.
+ * @return         1, -1 or 0 as described by priority_queue_compare_func_t.
+ * @note           complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+int PriorityQueueCompareInt(void *data, void *new_data)
+{
+	int key = *(int *)data;
+	int new_key = *(int *)new_data;
+
+	return (new_key > key) - (new_key < key);
+}
+
+/******************************************************************************
+ * @brief Compares the doubles the data points to, the larger double is
+ * dequeued first.
+ *
+ * @param data     Pointer to the existing double.
+ * @param new_data Pointer to the new double.
+ * @return         1, -1 or 0 as described by priority_queue_compare_func_t.
+ * @note           complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+int PriorityQueueCompareDouble(void *data, void *new_data)
+{
+	double key = *(double *)data;
+	double new_key = *(double *)new_data;
+
+	return (new_key > key) - (new_key < key);
+}
+
+/******************************************************************************
+ * @brief Counts where a compare function fails to be a consistent order over
+ * a sample of data. Each pair is checked for antisymmetry, each ordered triple
+ * a, b, c for transitivity: when a is not above b and b is not above c, a is
+ * not above c, and is strictly below it if either step was strict.
+ *
+ * @param compare Comparison function to check.
+ * @param data    Sample of data elements.
+ * @param count   Number of elements in the sample.
+ * @return        Number of violations found, 0 if none.
+ * @note          complexity   Time: O(count^3), Space: O(1)
+******************************************************************************/
+size_t PriorityQueueCheckCompare(priority_queue_compare_func_t compare, void **data, size_t count)
+{
+	size_t i = 0;
+	size_t j = 0;
+	size_t k = 0;
+	size_t violations = 0;
+	int ab = 0;
+	int bc = 0;
+	int ac = 0;
+	assert(compare && "Compare is not valid");
+	assert((data || 0 == count) && "Data is not valid");
+
+	for(i = 0; i < count; ++i)
+	{
+		for(j = 0; j < count; ++j)
+		{
+			ab = PriorityQueueSign(compare(data[i], data[j]));
+			violations += (ab != -PriorityQueueSign(compare(data[j], data[i])));
+			for(k = 0; k < count; ++k)
+			{
+				bc = PriorityQueueSign(compare(data[j], data[k]));
+				ac = PriorityQueueSign(compare(data[i], data[k]));
+				if(0 <= ab && 0 <= bc)
+				{
+					violations += (ac != (ab | bc));
+				}
+				else if(0 >= ab && 0 >= bc)
+				{
+					violations += (ac != -(-ab | -bc));
+				}
+			}
+		}
+	}
+
+	return violations;
+}
+
+/******************************************************************************
+ * @brief Allocates a queue and sets every field but the engine structure.
+ *
+ * @param compare Comparison function for element priority, NULL when keyed.
+ * @param engine  Engine the caller creates.
+ * @return        Pointer to the queue, or NULL on failure.
+******************************************************************************/
+static priority_queue_t *PriorityQueueAlloc(priority_queue_compare_func_t compare, priority_queue_engine_t engine)
+{
+	priority_queue_t *priority_queue = (priority_queue_t *)
+	malloc(sizeof(priority_queue_t));
+	if(NULL == priority_queue)
+	{
+		return NULL;
+	}
+
+	priority_queue -> engine = engine;
+	priority_queue -> sorted_list = NULL;
+	priority_queue -> heap = NULL;
+	priority_queue -> veb = NULL;
+	priority_queue -> buckets = NULL;
+	priority_queue -> compare = compare;
+	priority_queue -> key = NULL;
+	priority_queue -> size = 0;
+	priority_queue -> selector = NULL;
+	priority_queue -> selector_handle = NULL;
+	memset(&priority_queue -> bound, 0, sizeof(priority_queue_bound_t));
+	memset(&priority_queue -> watermark, 0, sizeof(priority_queue_watermark_t));
+	PriorityQueueStatsReset(priority_queue);
+#ifdef PRIORITY_QUEUE_SOJOURN
+	memset(&priority_queue -> codel, 0, sizeof(priority_queue_codel_t));
+#endif
+
+	return priority_queue;
+}
+
+/******************************************************************************
+ * @brief Reduces a compare result to its sign.
+ *
+ * @param value Result of a compare function.
+ * @return      1, -1 or 0.
+******************************************************************************/
+static int PriorityQueueSign(int value)
+{
+	return (0 < value) - (0 > value);
+}
+
+/******************************************************************************
+ * @brief Moves a queue to the place its head earns in its selector. A head
+ * that did not change costs the comparisons with its parent and children.
+ *
+ * @param queue Pointer to the priority queue.
+******************************************************************************/
+static void PriorityQueueReselect(priority_queue_t *queue)
+{
+	if(NULL != queue -> selector)
+	{
+		HeapUpdateHandle(queue -> selector -> heap, queue -> selector_handle, queue);
+	}
+}
+
+/******************************************************************************
+ * @brief Compares two queues of a selector by their heads, an empty queue 
+ * having the lowest priority of all.
+ *
+ * @param queue     Queue in the selector heap.
+ * @param new_queue Queue compared with it.
+ * @return          Result of the selector compare function on the heads.
+******************************************************************************/
+static int PriorityQueueSelectorCmp(void *queue, void *new_queue)
+{
+	priority_queue_t *existing = (priority_queue_t *)queue;
+	priority_queue_t *candidate = (priority_queue_t *)new_queue;
+
+	if(0 == candidate -> size)
+	{
+		return -(0 < existing -> size);
+	}
+
+	if(0 == existing -> size)
+	{
+		return 1;
+	}
+
+	return candidate -> selector -> compare(PRIORITY_QUEUE_DATA(PriorityQueueTop(existing)),
+	                                        PRIORITY_QUEUE_DATA(PriorityQueueTop(candidate)));
+}
+
+#ifdef PRIORITY_QUEUE_CHECK_COMPARE
+/******************************************************************************
+ * @brief Asserts the compare function is consistent over the data about to be
+ * inserted, the top element and one or two more queued elements. The calls
+ * are not counted in the stats.
+ *
+ * @param queue   Pointer to the priority queue.
+ * @param element Element about to be inserted, wrapped when sojourn times are
+ *                measured.
+******************************************************************************/
+static void PriorityQueueCheckSample(const priority_queue_t *queue, void *element)
+{
+	size_t count = 0;
+	size_t violations = 0;
+	void *sample[4];
+
+	/* Keys are integers, their order is consistent by construction */
+	if(NULL == queue -> compare)
+	{
+		return;
+	}
+
+	sample[count++] = PRIORITY_QUEUE_DATA(element);
+	if(0 < queue -> size)
+	{
+		switch(queue -> engine)
+		{
+			case PRIORITY_QUEUE_BINARY_HEAP:
+			case PRIORITY_QUEUE_DARY_HEAP:
+				sample[count++] = PRIORITY_QUEUE_DATA(HeapDataAt(queue -> heap, 0));
+				sample[count++] = PRIORITY_QUEUE_DATA(HeapDataAt(queue -> heap, queue -> size / 2));
+				sample[count++] = PRIORITY_QUEUE_DATA(HeapDataAt(queue -> heap, queue -> size - 1));
+				break;
+
+			default:
+				sample[count++] = PRIORITY_QUEUE_DATA(SortedListGetData(SortedListBegin(queue -> sorted_list)));
+				sample[count++] = PRIORITY_QUEUE_DATA(SortedListGetData(SortedListPrev(SortedListEnd(queue -> sorted_list))));
+				break;
+		}
+	}
+
+	violations = PriorityQueueCheckCompare(queue -> compare, sample, count);
+	assert(0 == violations && "Compare is not consistent");
+	(void)violations;
+}
+#endif /* PRIORITY_QUEUE_CHECK_COMPARE */
+
+/******************************************************************************
+ * @brief Returns the number of compare calls the engine has made so far.
+ *
+ * @param queue Pointer to the priority queue.
+ * @return      Number of compare calls.
+******************************************************************************/
+static size_t PriorityQueueComparisons(const priority_queue_t *queue)
+{
+	switch(queue -> engine)
+	{
+		case PRIORITY_QUEUE_BINARY_HEAP:
+		case PRIORITY_QUEUE_DARY_HEAP:
+			return HeapComparisons(queue -> heap);
+
+		case PRIORITY_QUEUE_VEB:
+		case PRIORITY_QUEUE_BUCKETS:
+			return 0;
+
+		default:
+			return SortedListComparisons(queue -> sorted_list);
+	}
+}
+
+/******************************************************************************
+ * @brief Adds one operation cost to a histogram.
+ *
+ * @param histogram Pointer to the histogram.
+ * @param value     Cost of the operation.
+******************************************************************************/
+static void PriorityQueueRecord(priority_queue_histogram_t *histogram, size_t value)
+{
+	size_t bucket = 0;
+	size_t rest = value;
+
+	for(; 0 < rest && bucket < PRIORITY_QUEUE_HISTOGRAM_BUCKETS - 1; rest >>= 1, ++bucket);
+
+	++histogram -> buckets[bucket];
+	++histogram -> samples;
+	histogram -> total += value;
+	histogram -> max = value > histogram -> max ? value : histogram -> max;
+}
+
+/******************************************************************************
+ * @brief Calls the user match function and counts the call.
+ *
+ * @param data Pointer to the data of the visited element.
+ * @param scan Pointer to the scan holding the user match and parameter.
+ * @return     Result of the user match function.
+******************************************************************************/
+static int PriorityQueueScanMatch(void *data, void *scan)
+{
+	priority_queue_scan_t *state = (priority_queue_scan_t *)scan;
+
+	++state -> visited;
+	return state -> ismatch(PRIORITY_QUEUE_DATA(data), state -> parameter);
+}
+
+/******************************************************************************
+ * @brief Inserts an element into the engine and records the comparisons.
+ *
+ * @param queue   Pointer to the priority queue.
+ * @param element Element to insert, wrapped when sojourn times are measured.
+ * @return        0 on success, or a non-zero value on failure.
+******************************************************************************/
+static int PriorityQueuePush(priority_queue_t *queue, void *element)
+{
+	int status = 0;
+	size_t comparisons = PriorityQueueComparisons(queue);
+	sorted_list_iter_t insert = {0};
+
+	PRIORITY_QUEUE_CHECK(queue, element);
+	switch(queue -> engine)
+	{
+		case PRIORITY_QUEUE_BINARY_HEAP:
+		case PRIORITY_QUEUE_DARY_HEAP:
+			status = HeapPush(queue -> heap, element);
+			break;
+
+		case PRIORITY_QUEUE_VEB:
+			status = VebInsert(queue -> veb, queue -> key(PRIORITY_QUEUE_DATA(element)), element);
+			break;
+
+		case PRIORITY_QUEUE_BUCKETS:
+			status = BucketQueueInsert(queue -> buckets, queue -> key(PRIORITY_QUEUE_DATA(element)), element);
+			break;
+
+		default:
+			insert = SortedListInsert(queue -> sorted_list, element);
+			status = SortedListIsEqual(SortedListEnd(queue -> sorted_list), insert);
+			break;
+	}
+
+	PriorityQueueRecord(&queue -> stats.insert_comparisons, PriorityQueueComparisons(queue) - comparisons);
+	if(0 == status)
+	{
+		PriorityQueueResize(queue, queue -> size + 1);
+	}
+
+	return status;
+}
+
+/******************************************************************************
+ * @brief Inserts a whole batch into a heap or keyed engine in one step, 
+ * recording an even share of the comparisons for every element.
+ *
+ * @param queue Pointer to the priority queue.
+ * @param data  Array of count data elements.
+ * @param count Number of elements.
+ * @return      0 if every element was inserted, or a non-zero value if none
+ *              was because the engine is a sorted list, the batch does not 
+ *              fit, the elements would need records or storage could not grow.
+******************************************************************************/
+static int PriorityQueuePushBatch(priority_queue_t *queue, void **data, size_t count)
+{
+#ifdef PRIORITY_QUEUE_SOJOURN
+	(void)queue;
+	(void)data;
+	(void)count;
+	return 1;
+#else
+	size_t i = 0;
+	size_t comparisons = 0;
+
+	if(NULL != queue -> sorted_list || 0 == count ||
+	   (0 != queue -> bound.capacity && queue -> bound.capacity - queue -> size < count))
+	{
+		return 1;
+	}
+
+	if(NULL != queue -> key)
+	{
+		return PriorityQueuePushKeyed(queue, data, count);
+	}
+
+	for(i = 0; i < count; ++i)
+	{
+		PRIORITY_QUEUE_CHECK(queue, data[i]);
+	}
+
+	comparisons = HeapComparisons(queue -> heap);
+	if(HeapPushBatch(queue -> heap, data, count))
+	{
+		return 1;
+	}
+
+	comparisons = HeapComparisons(queue -> heap) - comparisons;
+	for(i = 0; i < count; ++i)
+	{
+		PriorityQueueRecord(&queue -> stats.insert_comparisons, comparisons / count + (i < comparisons % count));
+	}
+
+	PriorityQueueResize(queue, queue -> size + count);
+	return 0;
+#endif
+}
+
+#ifndef PRIORITY_QUEUE_SOJOURN
+/******************************************************************************
+ * @brief Inserts a whole batch into a keyed engine in key order. The keys are 
+ * radix sorted first, so the bucket queue links every run of equal key at 
+ * once and the vEB walks its nodes in order instead of at random. The sort is
+ * stable, so elements of equal key still leave in the order of the batch.
+ *
+ * @param queue Pointer to a keyed priority queue.
+ * @param data  Array of count data elements, left in their order.
+ * @param count Number of elements.
+ * @return      0 if every element was inserted, or a non-zero value if none
+ *              was because the batch is small or storage could not grow.
+******************************************************************************/
+static int PriorityQueuePushKeyed(priority_queue_t *queue, void **data, size_t count)
+{
+	size_t i = 0;
+	int status = 0;
+	radix_sort_item_t *items = NULL;
+
+	if(PRIORITY_QUEUE_RADIX_MIN_BATCH > count)
+	{
+		return 1;
+	}
+
+	items = (radix_sort_item_t *)malloc(count * sizeof(radix_sort_item_t));
+	if(NULL == items)
+	{
+		return 1;
+	}
+
+	for(i = 0; i < count; ++i)
+	{
+		items[i].key = queue -> key(data[i]);
+		items[i].data = data[i];
+	}
+
+	status = RadixSort(items, count) ||
+	         (PRIORITY_QUEUE_VEB == queue -> engine ? VebInsertBatch(queue -> veb, items, count) :
+	                                                  BucketQueueInsertBatch(queue -> buckets, items, count));
+	free(items);
+	if(0 != status)
+	{
+		return 1;
+	}
+
+	for(i = 0; i < count; ++i)
+	{
+		PriorityQueueRecord(&queue -> stats.insert_comparisons, 0);
+	}
+
+	PriorityQueueResize(queue, queue -> size + count);
+	return 0;
+}
+#endif /* PRIORITY_QUEUE_SOJOURN */
+
+/******************************************************************************
+ * @brief Removes the top element of a non empty engine and records the
+ * comparisons.
+ *
+ * @param queue Pointer to the priority queue.
+ * @return      The removed element, still wrapped.
+******************************************************************************/
+static void *PriorityQueuePop(priority_queue_t *queue)
+{
+	void *element = NULL;
+	size_t comparisons = PriorityQueueComparisons(queue);
+
+	switch(queue -> engine)
+	{
+		case PRIORITY_QUEUE_BINARY_HEAP:
+		case PRIORITY_QUEUE_DARY_HEAP:
+			element = HeapPop(queue -> heap);
+			break;
+
+		case PRIORITY_QUEUE_VEB:
+			element = VebPopMin(queue -> veb);
+			break;
+
+		case PRIORITY_QUEUE_BUCKETS:
+			element = BucketQueuePopMin(queue -> buckets);
+			break;
+
+		default:
+			element = SortedListPopFront(queue -> sorted_list);
+			break;
+	}
+
+	PriorityQueueRecord(&queue -> stats.dequeue_comparisons, PriorityQueueComparisons(queue) - comparisons);
+	PriorityQueueResize(queue, queue -> size - 1);
+	return element;
+}
+
+/******************************************************************************
+ * @brief Returns the top element of a non empty engine.
+ *
+ * @param queue Pointer to the priority queue.
+ * @return      The top element, still wrapped.
+******************************************************************************/
+static void *PriorityQueueTop(const priority_queue_t *queue)
+{
+	switch(queue -> engine)
+	{
+		case PRIORITY_QUEUE_BINARY_HEAP:
+		case PRIORITY_QUEUE_DARY_HEAP:
+			return HeapPeek(queue -> heap);
+
+		case PRIORITY_QUEUE_VEB:
+			return VebPeekMin(queue -> veb);
+
+		case PRIORITY_QUEUE_BUCKETS:
+			return BucketQueuePeekMin(queue -> buckets);
+
+		default:
+			return SortedListGetData(SortedListBegin(queue -> sorted_list));
+	}
+}
+
+/******************************************************************************
+ * @brief Returns the element of lowest priority of a non empty engine, the one 
+ * an evicting queue gives up first: the last of the sorted list, the newest of
+ * the largest key of a keyed engine, and the lowest leaf of a heap, found by a
+ * scan.
+ *
+ * @param queue Pointer to the priority queue.
+ * @param index Receives the position of the element in a heap.
+ * @return      The element, still wrapped.
+******************************************************************************/
+static void *PriorityQueueBottom(priority_queue_t *queue, size_t *index)
+{
+	switch(queue -> engine)
+	{
+		case PRIORITY_QUEUE_BINARY_HEAP:
+		case PRIORITY_QUEUE_DARY_HEAP:
+			*index = HeapLowest(queue -> heap);
+			return HeapDataAt(queue -> heap, *index);
+
+		case PRIORITY_QUEUE_VEB:
+			return VebPeekMax(queue -> veb);
+
+		case PRIORITY_QUEUE_BUCKETS:
+			return BucketQueuePeekMax(queue -> buckets);
+
+		default:
+			return SortedListGetData(SortedListPrev(SortedListEnd(queue -> sorted_list)));
+	}
+}
+
+/******************************************************************************
+ * @brief Removes the element PriorityQueueBottom returned and records the new
+ * size.
+ *
+ * @param queue Pointer to the priority queue.
+ * @param index Position PriorityQueueBottom gave for a heap.
+******************************************************************************/
+static void PriorityQueuePopBottom(priority_queue_t *queue, size_t index)
+{
+	switch(queue -> engine)
+	{
+		case PRIORITY_QUEUE_BINARY_HEAP:
+		case PRIORITY_QUEUE_DARY_HEAP:
+			HeapRemoveAt(queue -> heap, index);
+			break;
+
+		case PRIORITY_QUEUE_VEB:
+			VebPopMax(queue -> veb);
+			break;
+
+		case PRIORITY_QUEUE_BUCKETS:
+			BucketQueuePopMax(queue -> buckets);
+			break;
+
+		default:
+			SortedListPopBack(queue -> sorted_list);
+			break;
+	}
+
+	PriorityQueueResize(queue, queue -> size - 1);
+}
+
+/******************************************************************************
+ * @brief Makes room for a new element in a bounded queue. Under the evict 
+ * policy the lowest element leaves if the new one outranks it; an element of 
+ * equal priority does not displace a queued one.
+ *
+ * @param queue Pointer to the priority queue.
+ * @param data  Pointer to the data about to be enqueued.
+ * @return      0 if there is room, or a non-zero value if the element is 
+ *              rejected.
+******************************************************************************/
+static int PriorityQueueAdmit(priority_queue_t *queue, void *data)
+{
+	size_t index = 0;
+	void *element = NULL;
+
+	if(0 == queue -> bound.capacity || queue -> size < queue -> bound.capacity)
+	{
+		return 0;
+	}
+
+	if(PRIORITY_QUEUE_EVICT_LOWEST == queue -> bound.overflow && 0 < queue -> size)
+	{
+		element = PriorityQueueBottom(queue, &index);
+		if(PriorityQueueOutranks(queue, PRIORITY_QUEUE_DATA(element), data))
+		{
+			PriorityQueuePopBottom(queue, index);
+			++queue -> stats.dequeued;
+			++queue -> stats.evicted;
+			element = PRIORITY_QUEUE_RELEASE(element);
+			if(NULL != queue -> bound.evict)
+			{
+				queue -> bound.evict(element, queue -> bound.parameter);
+			}
+
+			return 0;
+		}
+	}
+
+	++queue -> stats.rejected;
+	return 1;
+}
+
+/******************************************************************************
+ * @brief Tells whether new data has strictly higher priority than queued data,
+ * by the compare function, or by the keys of a keyed queue.
+ *
+ * @param queue    Pointer to the priority queue.
+ * @param data     Data of a queued element.
+ * @param new_data Data compared with it.
+ * @return         Non-zero if new_data is dequeued before data.
+******************************************************************************/
+static int PriorityQueueOutranks(const priority_queue_t *queue, void *data, void *new_data)
+{
+	if(NULL != queue -> key)
+	{
+		return queue -> key(new_data) < queue -> key(data);
+	}
+
+	return 0 < queue -> compare(data, new_data);
+}
+
+/******************************************************************************
+ * @brief Records the new number of elements and tells the watermark function 
+ * when it crosses a watermark.
+ *
+ * @param queue Pointer to the priority queue.
+ * @param size  Number of elements now in the queue.
+******************************************************************************/
+static void PriorityQueueResize(priority_queue_t *queue, size_t size)
+{
+	priority_queue_watermark_t *watermark = &queue -> watermark;
+
+	queue -> size = size;
+	PriorityQueueReselect(queue);
+	if(0 == watermark -> high)
+	{
+		return;
+	}
+
+	if(!watermark -> above && size >= watermark -> high)
+	{
+		watermark -> above = 1;
+		watermark -> notify(size, 1, watermark -> parameter);
+	}
+	else if(watermark -> above && size <= watermark -> low)
+	{
+		watermark -> above = 0;
+		watermark -> notify(size, 0, watermark -> parameter);
+	}
+}
+
+#ifdef PRIORITY_QUEUE_SOJOURN
+/******************************************************************************
+ * @brief Wraps data in a record stamped with the current time.
+ *
+ * @param queue Pointer to the priority queue.
+ * @param data  Pointer to the user data.
+ * @return      The record, or NULL if allocation fails.
+******************************************************************************/
+static void *PriorityQueueWrap(priority_queue_t *queue, void *data)
+{
+	priority_queue_element_t *element = (priority_queue_element_t *)malloc(sizeof(priority_queue_element_t));
+	if(NULL == element)
+	{
+		return NULL;
+	}
+
+	element -> data = data;
+	element -> compare = queue -> compare;
+	element -> enqueued_us = PriorityQueueNow();
+	return element;
+}
+
+/******************************************************************************
+ * @brief Records how long a dequeued element waited and frees its record.
+ *
+ * @param queue   Pointer to the priority queue.
+ * @param element Record of the dequeued element.
+ * @param now     Current time of the sojourn clock.
+ * @return        Pointer to the user data.
+******************************************************************************/
+static void *PriorityQueueUnwrap(priority_queue_t *queue, void *element, unsigned long now)
+{
+	/* Unsigned subtraction stays right across a wrap of the stamp */
+	PriorityQueueRecord(&queue -> stats.sojourn_us, now - ((priority_queue_element_t *)element) -> enqueued_us);
+	return PriorityQueueRelease(element);
+}
+
+/******************************************************************************
+ * @brief Frees a record without measuring it.
+ *
+ * @param element Record of an element leaving the queue.
+ * @return        Pointer to the user data.
+******************************************************************************/
+static void *PriorityQueueRelease(void *element)
+{
+	void *data = PRIORITY_QUEUE_DATA(element);
+
+	free(element);
+	return data;
+}
+
+/******************************************************************************
+ * @brief Frees the records of every element, the engine is cleared after.
+ *
+ * @param queue Pointer to the priority queue.
+******************************************************************************/
+static void PriorityQueueReleaseAll(priority_queue_t *queue)
+{
+	void *element = NULL;
+
+	switch(queue -> engine)
+	{
+		case PRIORITY_QUEUE_BINARY_HEAP:
+		case PRIORITY_QUEUE_DARY_HEAP:
+			HeapFindIf(queue -> heap, PriorityQueueReleaseEach, NULL);
+			break;
+
+		case PRIORITY_QUEUE_VEB:
+			VebRemoveIf(queue -> veb, PriorityQueueReleaseEach, NULL, &element);
+			break;
+
+		case PRIORITY_QUEUE_BUCKETS:
+			BucketQueueRemoveIf(queue -> buckets, PriorityQueueReleaseEach, NULL, &element);
+			break;
+
+		default:
+			SortedListFindIf(SortedListBegin(queue -> sorted_list),
+			SortedListEnd(queue -> sorted_list), PriorityQueueReleaseEach, NULL);
+			break;
+	}
+}
+
+/******************************************************************************
+ * @brief Frees one record as a search that never matches.
+ *
+ * @param element   Record to free.
+ * @param parameter Unused.
+ * @return          0, so that every element is visited.
+******************************************************************************/
+static int PriorityQueueReleaseEach(void *element, void *parameter)
+{
+	(void)parameter;
+	free(element);
+	return 0;
+}
+
+/******************************************************************************
+ * @brief Compares the data of two records with the compare function of the
+ * queue, which every record carries since the engines pass no context.
+ *
+ * @param element     Record in the queue.
+ * @param new_element Record being placed.
+ * @return            Result of the user compare function.
+******************************************************************************/
+static int PriorityQueueElementCmp(void *element, void *new_element)
+{
+	return ((priority_queue_element_t *)element) -> compare(PRIORITY_QUEUE_DATA(element),
+	                                                         PRIORITY_QUEUE_DATA(new_element));
+}
+
+/******************************************************************************
+ * @brief Reads the sojourn clock.
+ *
+ * @return Microseconds since an arbitrary point, wrapping around.
+******************************************************************************/
+static unsigned long PriorityQueueNow(void)
+{
+	struct timespec now;
+
+	clock_gettime(PRIORITY_QUEUE_SOJOURN_CLOCK, &now);
+	return (unsigned long)now.tv_sec * 1000000UL + (unsigned long)now.tv_nsec / 1000UL;
+}
+
+/******************************************************************************
+ * @brief Dequeues under CoDel, the dequeue of RFC 8289, with the drops taken 
+ * from the bottom of the queue: the head is always served, and what gives way
+ * is the element of lowest priority. While in the dropping state, one element 
+ * is dropped every time the next drop time has passed, and the next drop time
+ * gets closer with every drop. Entering the dropping state drops one element 
+ * and resumes the count of the last dropping state if it ended recently.
+ *
+ * @param queue Pointer to a non empty priority queue.
+ * @param data  Receives the data of the dequeued element.
+ * @return      PRIORITY_QUEUE_SUCCESS.
+ * @note        complexity   Time: O(log n) per drop, O(n) heap, Space: O(1)
+******************************************************************************/
+static priority_queue_status_t PriorityQueueCodelDequeue(priority_queue_t *queue, void **data)
+{
+	size_t delta = 0;
+	int ok_to_drop = 0;
+	unsigned long now = PriorityQueueNow();
+	priority_queue_codel_t *codel = &queue -> codel;
+
+	ok_to_drop = PriorityQueueCodelPop(queue, now, data);
+	if(codel -> dropping)
+	{
+		codel -> dropping = ok_to_drop;
+		while(codel -> dropping && 0 <= (long)(now - codel -> drop_next_us))
+		{
+			PriorityQueueCodelDrop(queue);
+			++codel -> count;
+			codel -> dropping = !PriorityQueueIsEmpty(queue);
+			if(codel -> dropping)
+			{
+				codel -> drop_next_us = PriorityQueueCodelControlLaw(codel, codel -> drop_next_us);
+			}
+		}
+	}
+	else if(ok_to_drop)
+	{
+		PriorityQueueCodelDrop(queue);
+
+		/* Dropping again soon after the last time resumes its rate */
+		codel -> dropping = 1;
+		delta = codel -> count - codel -> last_count;
+		codel -> count = 1;
+		if(1 < delta && (long)(now - codel -> drop_next_us) < (long)(16 * codel -> interval_us))
+		{
+			codel -> count = delta;
+		}
+
+		codel -> drop_next_us = PriorityQueueCodelControlLaw(codel, now);
+		codel -> last_count = codel -> count;
+	}
+
+	return PRIORITY_QUEUE_SUCCESS;
+}
+
+/******************************************************************************
+ * @brief Pops the top element and tracks how long the wait has been above
+ * target, the dodequeue of RFC 8289.
+ *
+ * @param queue Pointer to a non empty priority queue.
+ * @param now   Current time of the sojourn clock.
+ * @param data  Receives the data of the popped element.
+ * @return      Non-zero if the wait has been above target for an interval.
+******************************************************************************/
+static int PriorityQueueCodelPop(priority_queue_t *queue, unsigned long now, void **data)
+{
+	unsigned long sojourn = 0;
+	void *element = PriorityQueuePop(queue);
+	priority_queue_codel_t *codel = &queue -> codel;
+
+	++queue -> stats.dequeued;
+	sojourn = now - ((priority_queue_element_t *)element) -> enqueued_us;
+	*data = PriorityQueueUnwrap(queue, element, now);
+
+	/* A queue drained to nothing is not standing, whatever the wait */
+	if(sojourn < codel -> target_us || PriorityQueueIsEmpty(queue))
+	{
+		codel -> above = 0;
+		return 0;
+	}
+
+	if(!codel -> above)
+	{
+		codel -> above = 1;
+		codel -> first_above_us = now + codel -> interval_us;
+		return 0;
+	}
+
+	return 0 <= (long)(now - codel -> first_above_us);
+}
+
+/******************************************************************************
+ * @brief Removes the lowest-priority element, counts it as dropped and hands it
+ * to the drop function.
+ *
+ * @param queue Pointer to a non empty priority queue.
+******************************************************************************/
+static void PriorityQueueCodelDrop(priority_queue_t *queue)
+{
+	size_t index = 0;
+	void *data = PriorityQueueBottom(queue, &index);
+
+	PriorityQueuePopBottom(queue, index);
+	data = PRIORITY_QUEUE_RELEASE(data);
+	++queue -> stats.dequeued;
+	++queue -> stats.dropped;
+	if(NULL != queue -> codel.drop)
+	{
+		queue -> codel.drop(data, queue -> codel.parameter);
+	}
+}
+
+/******************************************************************************
+ * @brief Returns the time of the next drop, interval / sqrt(count) after the
+ * given time. The square root is found with Newton's method, so the library
+ * does not need libm.
+ *
+ * @param codel Pointer to the CoDel state.
+ * @param time  Time the step starts from.
+ * @return      Time of the next drop.
+******************************************************************************/
+static unsigned long PriorityQueueCodelControlLaw(const priority_queue_codel_t *codel, unsigned long time)
+{
+	int i = 0;
+	double count = (double)codel -> count;
+	double root = count;
+
+	for(i = 0; i < 64 && (root * root - count > count * 1e-9); ++i)
+	{
+		root = (root + count / root) / 2;
+	}
+
+	return time + (unsigned long)((double)codel -> interval_us / root);
 }
+#endif /* PRIORITY_QUEUE_SOJOURN */
 /*****************************************************************************/
\ No newline at end of file
@@ -0,0 +1,582 @@
+/******************************************************************************
+ * @writer:      Tal Aharon
+ * @date:        19.10.2026
+ *
+ * @description: Implementation of the metrics exporter for priority queues.
+ * Every source keeps two samples: the local one, written by the owning thread
+ * only and never locked, and the published one, copied from the local sample
+ * under the lock of the source. Rendering takes the registry lock, copies the
+ * published samples while holding each source lock for the copy only, sums the
+ * samples that share a name and formats the families from the copies.
+ *
+******************************************************************************/
+#define _POSIX_C_SOURCE 200112L
+
+#include <assert.h>                 /* assert                 */
+#include <stdio.h>                  /* sprintf                */
+#include <stdlib.h>                 /* malloc, free           */
+#include <string.h>                 /* strlen, strcmp, memcpy */
+#include <pthread.h>                /* pthread_mutex_*        */
+
+#include "priority_queue_metrics.h" /* Internal API           */
+/*****************************************************************************/
+#define PRIORITY_QUEUE_METRICS_BUCKETS (8)
+#define PRIORITY_QUEUE_METRICS_LINE_LENGTH (4 * PRIORITY_QUEUE_METRICS_NAME_LENGTH + 128)
+
+typedef struct priority_queue_metrics_sample
+{
+	char name[PRIORITY_QUEUE_METRICS_NAME_LENGTH + 1];
+	size_t depth;
+	size_t enqueued;
+	size_t dequeued;
+	size_t dropped;
+	size_t evicted;
+	size_t rejected;
+	size_t enqueue_comparisons;
+	size_t dequeue_comparisons;
+
+	/* Time in queue, per bucket and not cumulative, the last one is +Inf */
+	size_t sojourn_buckets[PRIORITY_QUEUE_METRICS_BUCKETS + 1];
+	size_t sojourn_count;
+	double sojourn_sum;
+
+} priority_queue_metrics_sample_t;
+
+struct priority_queue_metrics_source
+{
+	struct priority_queue_metrics_source *next;
+	const priority_queue_t *queue;
+	pthread_mutex_t lock;
+	priority_queue_metrics_sample_t local;
+	priority_queue_metrics_sample_t published;
+};
+
+struct priority_queue_metrics
+{
+	pthread_mutex_t lock;
+	priority_queue_metrics_source_t *sources;
+	size_t source_count;
+};
+
+typedef struct priority_queue_metrics_text
+{
+	char *buffer;
+	size_t size;
+	size_t length;
+
+} priority_queue_metrics_text_t;
+
+typedef size_t (*priority_queue_metrics_value_func_t) (const priority_queue_metrics_sample_t *sample);
+
+typedef struct priority_queue_metrics_family
+{
+	const char *name;
+	const char *type;
+	const char *help;
+	const char *labels;
+	priority_queue_metrics_value_func_t value;
+
+} priority_queue_metrics_family_t;
+
+static size_t PriorityQueueMetricsDepth(const priority_queue_metrics_sample_t *sample);
+static size_t PriorityQueueMetricsEnqueued(const priority_queue_metrics_sample_t *sample);
+static size_t PriorityQueueMetricsDequeued(const priority_queue_metrics_sample_t *sample);
+static size_t PriorityQueueMetricsDropped(const priority_queue_metrics_sample_t *sample);
+static size_t PriorityQueueMetricsEvicted(const priority_queue_metrics_sample_t *sample);
+static size_t PriorityQueueMetricsRejected(const priority_queue_metrics_sample_t *sample);
+static size_t PriorityQueueMetricsEnqueueComparisons(const priority_queue_metrics_sample_t *sample);
+static size_t PriorityQueueMetricsDequeueComparisons(const priority_queue_metrics_sample_t *sample);
+static size_t PriorityQueueMetricsCollect(priority_queue_metrics_t *metrics, priority_queue_metrics_sample_t *samples);
+static void PriorityQueueMetricsAdd(priority_queue_metrics_sample_t *sum, const priority_queue_metrics_sample_t *sample);
+#ifdef PRIORITY_QUEUE_SOJOURN
+static void PriorityQueueMetricsConvert(priority_queue_metrics_sample_t *sample, const priority_queue_histogram_t *sojourn_us);
+#endif
+static void PriorityQueueMetricsSojourn(priority_queue_metrics_text_t *text, const priority_queue_metrics_sample_t *samples, size_t count);
+static void PriorityQueueMetricsEscape(char *escaped, const char *name);
+static void PriorityQueueMetricsAppend(priority_queue_metrics_text_t *text, const char *line);
+
+/* Upper bounds of the time in queue buckets, in seconds */
+static const double sojourn_bounds[PRIORITY_QUEUE_METRICS_BUCKETS] =
+{
+	1e-6, 1e-5, 1e-4, 1e-3, 1e-2, 1e-1, 1, 10
+};
+
+static const char *const sojourn_labels[PRIORITY_QUEUE_METRICS_BUCKETS] =
+{
+	"1e-06", "1e-05", "0.0001", "0.001", "0.01", "0.1", "1", "10"
+};
+
+/* Families rendered from counters, the time in queue histogram follows them */
+static const priority_queue_metrics_family_t families[] =
+{
+	{"priority_queue_depth", "gauge", "Number of elements in the queue.", "", PriorityQueueMetricsDepth},
+	{"priority_queue_enqueued_total", "counter", "Elements enqueued.", "", PriorityQueueMetricsEnqueued},
+	{"priority_queue_dequeued_total", "counter", "Elements dequeued, erased, evicted or dropped.", "", PriorityQueueMetricsDequeued},
+	{"priority_queue_dropped_total", "counter", "Elements dropped by active queue management.", "", PriorityQueueMetricsDropped},
+	{"priority_queue_evicted_total", "counter", "Elements evicted to make room in a full queue.", "", PriorityQueueMetricsEvicted},
+	{"priority_queue_rejected_total", "counter", "Enqueues refused by a full queue.", "", PriorityQueueMetricsRejected},
+	{"priority_queue_comparisons_total", "counter", "Calls to the compare function.", ",operation=\"enqueue\"", PriorityQueueMetricsEnqueueComparisons},
+	{"priority_queue_comparisons_total", NULL, NULL, ",operation=\"dequeue\"", PriorityQueueMetricsDequeueComparisons}
+};
+
+/******************************************************************************
+ * @brief Creates an empty metrics registry.
+ *
+ * @return Pointer to the registry, or NULL on failure.
+ * @note   complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+priority_queue_metrics_t *PriorityQueueMetricsCreate(void)
+{
+	priority_queue_metrics_t *metrics = (priority_queue_metrics_t *)malloc(sizeof(priority_queue_metrics_t));
+	if(NULL == metrics)
+	{
+		return NULL;
+	}
+
+	if(0 != pthread_mutex_init(&metrics -> lock, NULL))
+	{
+		free(metrics);
+		return NULL;
+	}
+
+	metrics -> sources = NULL;
+	metrics -> source_count = 0;
+	return metrics;
+}
+
+/******************************************************************************
+ * @brief Destroys a registry together with every source still registered.
+ *
+ * @param metrics Pointer to the registry.
+ * @note          complexity   Time: O(n), Space: O(1)
+******************************************************************************/
+void PriorityQueueMetricsDestroy(priority_queue_metrics_t *metrics)
+{
+	priority_queue_metrics_source_t *source = NULL;
+	assert(metrics && "Metrics are not valid");
+
+	while(NULL != metrics -> sources)
+	{
+		source = metrics -> sources;
+		metrics -> sources = source -> next;
+		pthread_mutex_destroy(&source -> lock);
+		free(source);
+	}
+
+	pthread_mutex_destroy(&metrics -> lock);
+	free(metrics);
+}
+
+/******************************************************************************
+ * @brief Registers a queue under a name.
+ *
+ * @param metrics Pointer to the registry.
+ * @param queue   Queue the source publishes.
+ * @param name    Label value of the series.
+ * @return        Pointer to the source, or NULL on failure.
+ * @note          complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+priority_queue_metrics_source_t *PriorityQueueMetricsRegister(priority_queue_metrics_t *metrics, const priority_queue_t *queue, const char *name)
+{
+	priority_queue_metrics_source_t *source = NULL;
+	assert(metrics && "Metrics are not valid");
+	assert(queue && "Queue is not valid");
+	assert(name && PRIORITY_QUEUE_METRICS_NAME_LENGTH >= strlen(name) && "Name is not valid");
+
+	source = (priority_queue_metrics_source_t *)malloc(sizeof(priority_queue_metrics_source_t));
+	if(NULL == source)
+	{
+		return NULL;
+	}
+
+	if(0 != pthread_mutex_init(&source -> lock, NULL))
+	{
+		free(source);
+		return NULL;
+	}
+
+	memset(&source -> local, 0, sizeof(priority_queue_metrics_sample_t));
+	strcpy(source -> local.name, name);
+	source -> published = source -> local;
+	source -> queue = queue;
+
+	pthread_mutex_lock(&metrics -> lock);
+	source -> next = metrics -> sources;
+	metrics -> sources = source;
+	++metrics -> source_count;
+	pthread_mutex_unlock(&metrics -> lock);
+
+	return source;
+}
+
+/******************************************************************************
+ * @brief Removes a source from the registry and frees it.
+ *
+ * @param metrics Pointer to the registry.
+ * @param source  Source returned by PriorityQueueMetricsRegister.
+ * @note          complexity   Time: O(n), Space: O(1)
+******************************************************************************/
+void PriorityQueueMetricsUnregister(priority_queue_metrics_t *metrics, priority_queue_metrics_source_t *source)
+{
+	priority_queue_metrics_source_t **link = NULL;
+	assert(metrics && "Metrics are not valid");
+	assert(source && "Source is not valid");
+
+	pthread_mutex_lock(&metrics -> lock);
+	for(link = &metrics -> sources; NULL != *link && source != *link; link = &(*link) -> next);
+	assert(NULL != *link && "Source is not registered");
+
+	*link = source -> next;
+	--metrics -> source_count;
+	pthread_mutex_unlock(&metrics -> lock);
+
+	pthread_mutex_destroy(&source -> lock);
+	free(source);
+}
+
+/******************************************************************************
+ * @brief Records how long a dequeued element spent in the queue. A library 
+ * built with PRIORITY_QUEUE_SOJOURN measures it itself and ignores the call.
+ *
+ * @param source  Pointer to the source.
+ * @param seconds Time between the enqueue and the dequeue of the element.
+ * @note          complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+void PriorityQueueMetricsObserveSojourn(priority_queue_metrics_source_t *source, double seconds)
+{
+	size_t bucket = 0;
+	assert(source && "Source is not valid");
+#ifdef PRIORITY_QUEUE_SOJOURN
+	(void)source;
+	(void)seconds;
+	(void)bucket;
+#else
+	for(; bucket < PRIORITY_QUEUE_METRICS_BUCKETS && seconds > sojourn_bounds[bucket]; ++bucket);
+
+	++source -> local.sojourn_buckets[bucket];
+	++source -> local.sojourn_count;
+	source -> local.sojourn_sum += seconds;
+#endif
+}
+
+/******************************************************************************
+ * @brief Makes the current state of the queue visible to the renderer.
+ *
+ * @param source Pointer to the source.
+ * @note         complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+void PriorityQueueMetricsPublish(priority_queue_metrics_source_t *source)
+{
+	priority_queue_stats_t stats;
+	assert(source && "Source is not valid");
+
+	PriorityQueueStats(source -> queue, &stats);
+	source -> local.depth = PriorityQueueSize(source -> queue);
+	source -> local.enqueued = stats.enqueued;
+	source -> local.dequeued = stats.dequeued;
+	source -> local.dropped = stats.dropped;
+	source -> local.evicted = stats.evicted;
+	source -> local.rejected = stats.rejected;
+	source -> local.enqueue_comparisons = stats.insert_comparisons.total;
+	source -> local.dequeue_comparisons = stats.dequeue_comparisons.total;
+#ifdef PRIORITY_QUEUE_SOJOURN
+	PriorityQueueMetricsConvert(&source -> local, &stats.sojourn_us);
+#endif
+
+	pthread_mutex_lock(&source -> lock);
+	source -> published = source -> local;
+	pthread_mutex_unlock(&source -> lock);
+}
+
+/******************************************************************************
+ * @brief Renders what every source has published in the Prometheus text
+ *        exposition format.
+ *
+ * @param metrics Pointer to the registry.
+ * @param buffer  Receives the text.
+ * @param size    Size of the buffer in bytes.
+ * @return        Length of the full text without the terminator.
+ * @note          complexity   Time: O(n^2), Space: O(n)
+******************************************************************************/
+size_t PriorityQueueMetricsRender(priority_queue_metrics_t *metrics, char *buffer, size_t size)
+{
+	size_t i = 0;
+	size_t f = 0;
+	size_t count = 0;
+	char escaped[2 * PRIORITY_QUEUE_METRICS_NAME_LENGTH + 1];
+	char line[PRIORITY_QUEUE_METRICS_LINE_LENGTH];
+	priority_queue_metrics_sample_t *samples = NULL;
+	priority_queue_metrics_text_t text;
+	assert(metrics && "Metrics are not valid");
+	assert((buffer || 0 == size) && "Buffer is not valid");
+
+	text.buffer = buffer;
+	text.size = size;
+	text.length = 0;
+	if(0 < size)
+	{
+		buffer[0] = '\0';
+	}
+
+	pthread_mutex_lock(&metrics -> lock);
+	samples = (priority_queue_metrics_sample_t *)malloc((metrics -> source_count + 1) * sizeof(priority_queue_metrics_sample_t));
+	if(NULL == samples)
+	{
+		pthread_mutex_unlock(&metrics -> lock);
+		return 0;
+	}
+
+	count = PriorityQueueMetricsCollect(metrics, samples);
+	pthread_mutex_unlock(&metrics -> lock);
+
+	for(f = 0; f < sizeof(families) / sizeof(families[0]); ++f)
+	{
+		if(NULL != families[f].help)
+		{
+			sprintf(line, "# HELP %s %s\n# TYPE %s %s\n", families[f].name, families[f].help, families[f].name, families[f].type);
+			PriorityQueueMetricsAppend(&text, line);
+		}
+
+		for(i = 0; i < count; ++i)
+		{
+			PriorityQueueMetricsEscape(escaped, samples[i].name);
+			sprintf(line, "%s{queue=\"%s\"%s} %lu\n", families[f].name, escaped, families[f].labels, (unsigned long)families[f].value(&samples[i]));
+			PriorityQueueMetricsAppend(&text, line);
+		}
+	}
+
+	PriorityQueueMetricsSojourn(&text, samples, count);
+	free(samples);
+
+	return text.length;
+}
+
+/******************************************************************************
+ * @brief Copies the published samples and sums the ones sharing a name.
+ *        The registry lock is held by the caller.
+ *
+ * @param metrics Pointer to the registry.
+ * @param samples Receives one sample per distinct name.
+ * @return        Number of distinct names.
+******************************************************************************/
+static size_t PriorityQueueMetricsCollect(priority_queue_metrics_t *metrics, priority_queue_metrics_sample_t *samples)
+{
+	size_t i = 0;
+	size_t count = 0;
+	priority_queue_metrics_source_t *source = NULL;
+
+	for(source = metrics -> sources; NULL != source; source = source -> next)
+	{
+		pthread_mutex_lock(&source -> lock);
+		samples[count] = source -> published;
+		pthread_mutex_unlock(&source -> lock);
+
+		for(i = 0; i < count && 0 != strcmp(samples[i].name, samples[count].name); ++i);
+		if(i < count)
+		{
+			PriorityQueueMetricsAdd(&samples[i], &samples[count]);
+		}
+		else
+		{
+			++count;
+		}
+	}
+
+	return count;
+}
+
+/******************************************************************************
+ * @brief Adds the counters of a sample to a sum.
+ *
+ * @param sum    Sample receiving the sum.
+ * @param sample Sample to add.
+******************************************************************************/
+static void PriorityQueueMetricsAdd(priority_queue_metrics_sample_t *sum, const priority_queue_metrics_sample_t *sample)
+{
+	size_t i = 0;
+
+	sum -> depth += sample -> depth;
+	sum -> enqueued += sample -> enqueued;
+	sum -> dequeued += sample -> dequeued;
+	sum -> dropped += sample -> dropped;
+	sum -> evicted += sample -> evicted;
+	sum -> rejected += sample -> rejected;
+	sum -> enqueue_comparisons += sample -> enqueue_comparisons;
+	sum -> dequeue_comparisons += sample -> dequeue_comparisons;
+	for(i = 0; i <= PRIORITY_QUEUE_METRICS_BUCKETS; ++i)
+	{
+		sum -> sojourn_buckets[i] += sample -> sojourn_buckets[i];
+	}
+
+	sum -> sojourn_count += sample -> sojourn_count;
+	sum -> sojourn_sum += sample -> sojourn_sum;
+}
+
+#ifdef PRIORITY_QUEUE_SOJOURN
+/******************************************************************************
+ * @brief Fills the time in queue of a sample from the sojourn histogram the 
+ * queue recorded in microseconds. Every power of two bucket goes to the first
+ * bound in seconds at or above the longest time it can hold, so no time is 
+ * counted under a bound it exceeds; the last bucket has no end and goes to 
+ * +Inf.
+ *
+ * @param sample     Sample receiving the time in queue.
+ * @param sojourn_us Sojourn histogram of the queue.
+******************************************************************************/
+static void PriorityQueueMetricsConvert(priority_queue_metrics_sample_t *sample, const priority_queue_histogram_t *sojourn_us)
+{
+	size_t i = 0;
+	size_t bucket = 0;
+	double end = 1;
+
+	memset(sample -> sojourn_buckets, 0, sizeof(sample -> sojourn_buckets));
+	for(i = 0; i < PRIORITY_QUEUE_HISTOGRAM_BUCKETS; ++i, end *= 2)
+	{
+		/* Bucket i holds whole microseconds below 2^i */
+		bucket = PRIORITY_QUEUE_METRICS_BUCKETS;
+		if(i + 1 < PRIORITY_QUEUE_HISTOGRAM_BUCKETS)
+		{
+			for(bucket = 0; bucket < PRIORITY_QUEUE_METRICS_BUCKETS && (end - 1) / 1e6 > sojourn_bounds[bucket]; ++bucket);
+		}
+
+		sample -> sojourn_buckets[bucket] += sojourn_us -> buckets[i];
+	}
+
+	sample -> sojourn_count = sojourn_us -> samples;
+	sample -> sojourn_sum = (double)sojourn_us -> total / 1e6;
+}
+#endif /* PRIORITY_QUEUE_SOJOURN */
+
+/******************************************************************************
+ * @brief Renders the time in queue histogram family, with cumulative buckets.
+ *
+ * @param text    Text being rendered.
+ * @param samples Samples to render.
+ * @param count   Number of samples.
+******************************************************************************/
+static void PriorityQueueMetricsSojourn(priority_queue_metrics_text_t *text, const priority_queue_metrics_sample_t *samples, size_t count)
+{
+	size_t i = 0;
+	size_t bucket = 0;
+	size_t cumulative = 0;
+	char escaped[2 * PRIORITY_QUEUE_METRICS_NAME_LENGTH + 1];
+	char line[PRIORITY_QUEUE_METRICS_LINE_LENGTH];
+
+	PriorityQueueMetricsAppend(text, "# HELP priority_queue_time_in_queue_seconds Time elements spent in the queue.\n"
+	                                 "# TYPE priority_queue_time_in_queue_seconds histogram\n");
+	for(i = 0; i < count; ++i)
+	{
+		PriorityQueueMetricsEscape(escaped, samples[i].name);
+		for(bucket = 0, cumulative = 0; bucket < PRIORITY_QUEUE_METRICS_BUCKETS; ++bucket)
+		{
+			cumulative += samples[i].sojourn_buckets[bucket];
+			sprintf(line, "priority_queue_time_in_queue_seconds_bucket{queue=\"%s\",le=\"%s\"} %lu\n", escaped, sojourn_labels[bucket], (unsigned long)cumulative);
+			PriorityQueueMetricsAppend(text, line);
+		}
+
+		sprintf(line, "priority_queue_time_in_queue_seconds_bucket{queue=\"%s\",le=\"+Inf\"} %lu\n", escaped, (unsigned long)samples[i].sojourn_count);
+		PriorityQueueMetricsAppend(text, line);
+		sprintf(line, "priority_queue_time_in_queue_seconds_sum{queue=\"%s\"} %.9g\n", escaped, samples[i].sojourn_sum);
+		PriorityQueueMetricsAppend(text, line);
+		sprintf(line, "priority_queue_time_in_queue_seconds_count{queue=\"%s\"} %lu\n", escaped, (unsigned long)samples[i].sojourn_count);
+		PriorityQueueMetricsAppend(text, line);
+	}
+}
+
+/******************************************************************************
+ * @brief Escapes a label value: backslash, double quote and line feed.
+ *
+ * @param escaped Receives the escaped value, twice the name length at most.
+ * @param name    Label value.
+******************************************************************************/
+static void PriorityQueueMetricsEscape(char *escaped, const char *name)
+{
+	for(; '\0' != *name; ++name)
+	{
+		if('\\' == *name || '"' == *name)
+		{
+			*escaped++ = '\\';
+			*escaped++ = *name;
+		}
+		else if('\n' == *name)
+		{
+			*escaped++ = '\\';
+			*escaped++ = 'n';
+		}
+		else
+		{
+			*escaped++ = *name;
+		}
+	}
+
+	*escaped = '\0';
+}
+
+/******************************************************************************
+ * @brief Appends a line to the text, copying what still fits in the buffer.
+ *
+ * @param text Text being rendered.
+ * @param line Line to append.
+******************************************************************************/
+static void PriorityQueueMetricsAppend(priority_queue_metrics_text_t *text, const char *line)
+{
+	size_t length = strlen(line);
+	size_t room = 0;
+
+	if(text -> length + 1 < text -> size)
+	{
+		room = text -> size - text -> length - 1;
+		room = length < room ? length : room;
+		memcpy(text -> buffer + text -> length, line, room);
+		text -> buffer[text -> length + room] = '\0';
+	}
+
+	text -> length += length;
+}
+
+/******************************************************************************
+ * @brief Value getters of the counter families.
+ *
+ * @param sample Sample to read.
+ * @return       Value of the family.
+******************************************************************************/
+static size_t PriorityQueueMetricsDepth(const priority_queue_metrics_sample_t *sample)
+{
+	return sample -> depth;
+}
+
+static size_t PriorityQueueMetricsEnqueued(const priority_queue_metrics_sample_t *sample)
+{
+	return sample -> enqueued;
+}
+
+static size_t PriorityQueueMetricsDequeued(const priority_queue_metrics_sample_t *sample)
+{
+	return sample -> dequeued;
+}
+
+static size_t PriorityQueueMetricsDropped(const priority_queue_metrics_sample_t *sample)
+{
+	return sample -> dropped;
+}
+
+static size_t PriorityQueueMetricsEvicted(const priority_queue_metrics_sample_t *sample)
+{
+	return sample -> evicted;
+}
+
+static size_t PriorityQueueMetricsRejected(const priority_queue_metrics_sample_t *sample)
+{
+	return sample -> rejected;
+}
+
+static size_t PriorityQueueMetricsEnqueueComparisons(const priority_queue_metrics_sample_t *sample)
+{
+	return sample -> enqueue_comparisons;
+}
+
+static size_t PriorityQueueMetricsDequeueComparisons(const priority_queue_metrics_sample_t *sample)
+{
+	return sample -> dequeue_comparisons;
+}
+/*****************************************************************************/
@@ -0,0 +1,148 @@
+/******************************************************************************
+ * @writer:      Tal Aharon
+ * @date:        19.10.2026
+ *
+ * @description: Implementation of a least significant digit radix sort over
+ * byte digits. A byte keeps the table of counts of every digit at 16KB on 64
+ * bit words, within the L1 cache, and every pass scatters whole items into
+ * 256 streams, few enough for the write combining buffers and the TLB.
+ *
+ * One read of the keys counts all the digits at once. Counting stops at the
+ * highest non zero byte of a key and the zero bytes above it are added to the
+ * tables afterwards, so small keys do not serialize on a single counter. A
+ * digit every key shares would move nothing and its pass is skipped, so the
+ * levels of a bucket queue take at most two passes and the keys of a van Emde
+ * Boas tree at most four, whatever the width of unsigned long. The sort never
+ * starts a thread: the count and every pass are single streams of reads in
+ * the calling thread, and the order of a pass is what makes the sort stable.
+ *
+******************************************************************************/
+#include <assert.h>          /* assert         */
+#include <limits.h>          /* CHAR_BIT       */
+#include <stdlib.h>          /* malloc, free   */
+#include <string.h>          /* memcpy, memset */
+
+#include "radix_sort.h"      /* Internal API */
+/*****************************************************************************/
+#define RADIX_SORT_DIGIT_BITS (CHAR_BIT)
+#define RADIX_SORT_RADIX (1UL << RADIX_SORT_DIGIT_BITS)
+#define RADIX_SORT_DIGITS (sizeof(unsigned long))
+#define RADIX_SORT_DIGIT(key, digit) (((key) >> ((digit) * RADIX_SORT_DIGIT_BITS)) & (RADIX_SORT_RADIX - 1))
+
+/* The counts of every digit of the items */
+typedef struct radix_sort_histogram
+{
+	size_t counts[sizeof(unsigned long)][1UL << CHAR_BIT];
+
+} radix_sort_histogram_t;
+
+static void RadixSortCount(const radix_sort_item_t *items, size_t count, radix_sort_histogram_t *histogram);
+
+/******************************************************************************
+ * @brief       Sorts items by key in ascending order. Items of equal key keep
+ *              their relative order.
+ * @param items Array of count items.
+ * @param count Number of items.
+ * @return      0 on success, or a non-zero value if the scratch buffer could
+ *              not be allocated.
+ * @note        Time Complexity: O(n) per byte of the largest key.
+******************************************************************************/
+int RadixSort(radix_sort_item_t *items, size_t count)
+{
+	size_t i = 0;
+	size_t digit = 0;
+	size_t bucket = 0;
+	size_t offset = 0;
+	size_t sum = 0;
+	size_t *counts = NULL;
+	radix_sort_histogram_t *histogram = NULL;
+	radix_sort_item_t *from = items;
+	radix_sort_item_t *to = NULL;
+	radix_sort_item_t *swap = NULL;
+
+	assert((items || 0 == count) && "Items aren't valid.");
+
+	if(2 > count)
+	{
+		return (0);
+	}
+
+	histogram = (radix_sort_histogram_t *)malloc(sizeof(radix_sort_histogram_t));
+	to = (radix_sort_item_t *)malloc(count * sizeof(radix_sort_item_t));
+	if(NULL == histogram || NULL == to)
+	{
+		free(histogram);
+		free(to);
+		return (1);
+	}
+
+	RadixSortCount(items, count, histogram);
+	for(digit = 0; digit < RADIX_SORT_DIGITS; ++digit)
+	{
+		/* Keys that were not counted at this digit are zero there */
+		counts = histogram->counts[digit];
+		for(sum = 0, bucket = 1; bucket < RADIX_SORT_RADIX; ++bucket)
+		{
+			sum += counts[bucket];
+		}
+
+		counts[0] = count - sum;
+		if(count == counts[RADIX_SORT_DIGIT(from[0].key, digit)])
+		{
+			continue;
+		}
+
+		/* Counts become the offset of the first item of every bucket */
+		for(sum = 0, bucket = 0; bucket < RADIX_SORT_RADIX; ++bucket)
+		{
+			offset = counts[bucket];
+			counts[bucket] = sum;
+			sum += offset;
+		}
+
+		for(i = 0; i < count; ++i)
+		{
+			to[counts[RADIX_SORT_DIGIT(from[i].key, digit)]++] = from[i];
+		}
+
+		swap = from;
+		from = to;
+		to = swap;
+	}
+
+	/* After an odd number of passes the sorted batch is in the scratch buffer */
+	if(from != items)
+	{
+		memcpy(items, from, count * sizeof(radix_sort_item_t));
+		to = from;
+	}
+
+	free(histogram);
+	free(to);
+	return (0);
+}
+
+/******************************************************************************
+ * @brief           Counts the digits of the items, up to the highest non zero
+ *                  one of every key.
+ * @param items     Array of count items.
+ * @param count     Number of items.
+ * @param histogram Pointer to the histogram to fill.
+ * @note            Time Complexity: O(n) for n items.
+******************************************************************************/
+static void RadixSortCount(const radix_sort_item_t *items, size_t count, radix_sort_histogram_t *histogram)
+{
+	size_t i = 0;
+	size_t digit = 0;
+	unsigned long key = 0;
+
+	memset(histogram->counts, 0, sizeof(histogram->counts));
+	for(i = 0; i < count; ++i)
+	{
+		for(key = items[i].key, digit = 0; 0 != key; key >>= RADIX_SORT_DIGIT_BITS, ++digit)
+		{
+			++histogram->counts[digit][key & (RADIX_SORT_RADIX - 1)];
+		}
+	}
+}
+/*****************************************************************************/
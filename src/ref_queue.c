@@ -0,0 +1,229 @@
+/******************************************************************************
+ * @writer:      Tal Aharon
+ * @date:        19.10.2026
+ *
+ * @description: Implementation of the reference queue as a binary heap of
+ * (key, offset) entries held by value in a segmented array. Keys are compared
+ * inline, so no callback is involved, and no per element allocation is made.
+ *
+******************************************************************************/
+#include <assert.h>          /* assert       */
+#include <stdlib.h>          /* malloc, free */
+
+#include "segmented_array.h" /* Internal API */
+#include "ref_queue.h"       /* Internal API */
+/*****************************************************************************/
+struct ref_queue
+{
+	segmented_array_t *entries;
+	size_t size;
+};
+
+static ref_queue_ref_t *RefQueueEntry(const ref_queue_t *queue, size_t index);
+
+/******************************************************************************
+ * @brief  Creates a new, empty reference queue.
+ * @return Pointer to the created queue, or NULL if creation fails.
+ * @note   Time Complexity: O(1)
+******************************************************************************/
+ref_queue_t *RefQueueCreate(void)
+{
+	ref_queue_t *queue = (ref_queue_t *)malloc(sizeof(ref_queue_t));
+	if(NULL == queue)
+	{
+		return (NULL);
+	}
+
+	queue->entries = SegmentedArrayCreate(sizeof(ref_queue_ref_t));
+	if(NULL == queue->entries)
+	{
+		free(queue);
+		return (NULL);
+	}
+
+	queue->size = 0;
+	return (queue);
+}
+
+/******************************************************************************
+ * @brief       Destroys a reference queue. Payloads are not touched.
+ * @param queue Pointer to the queue to be destroyed.
+ * @note        Time Complexity: O(log n)
+******************************************************************************/
+void RefQueueDestroy(ref_queue_t *queue)
+{
+	assert(queue && "Queue isn't valid.");
+	SegmentedArrayDestroy(queue->entries);
+	free(queue);
+}
+
+/******************************************************************************
+ * @brief        Adds a reference to the queue.
+ * @param queue  Pointer to the queue.
+ * @param key    Priority of the reference, higher keys are dequeued first.
+ * @param offset Offset of the payload in the caller's buffer.
+ * @return       0 on success, or a non-zero value if storage could not grow.
+ * @note         Time Complexity: O(log n)
+******************************************************************************/
+int RefQueueEnqueue(ref_queue_t *queue, ref_queue_key_t key, ref_queue_offset_t offset)
+{
+	size_t hole = 0;
+	size_t parent = 0;
+	ref_queue_ref_t *parent_entry = NULL;
+	ref_queue_ref_t *entry = NULL;
+
+	assert(queue && "Queue isn't valid.");
+	if(SegmentedArrayReserve(queue->entries, queue->size + 1))
+	{
+		return (1);
+	}
+
+	hole = queue->size;
+	entry = RefQueueEntry(queue, hole);
+	++queue->size;
+
+	while(0 < hole)
+	{
+		parent = (hole - 1) / 2;
+		parent_entry = RefQueueEntry(queue, parent);
+		if(parent_entry->key >= key)
+		{
+			break;
+		}
+
+		*entry = *parent_entry;
+		entry = parent_entry;
+		hole = parent;
+	}
+
+	entry->key = key;
+	entry->offset = offset;
+	return (0);
+}
+
+/******************************************************************************
+ * @brief       Removes the reference with the highest key.
+ * @param queue Pointer to the queue.
+ * @param ref   Receives the removed reference. May be NULL.
+ * @return      0 on success, or a non-zero value if the queue is empty.
+ * @note        Time Complexity: O(log n)
+******************************************************************************/
+int RefQueueDequeue(ref_queue_t *queue, ref_queue_ref_t *ref)
+{
+	size_t hole = 0;
+	size_t child = 0;
+	ref_queue_ref_t last = {0, 0};
+	ref_queue_ref_t *entry = NULL;
+	ref_queue_ref_t *child_entry = NULL;
+	ref_queue_ref_t *right_entry = NULL;
+
+	assert(queue && "Queue isn't valid.");
+	if(0 == queue->size)
+	{
+		return (1);
+	}
+
+	entry = RefQueueEntry(queue, 0);
+	if(NULL != ref)
+	{
+		*ref = *entry;
+	}
+
+	--queue->size;
+	last = *RefQueueEntry(queue, queue->size);
+
+	while((child = 2 * hole + 1) < queue->size)
+	{
+		child_entry = RefQueueEntry(queue, child);
+		if(child + 1 < queue->size)
+		{
+			right_entry = RefQueueEntry(queue, child + 1);
+			if(right_entry->key > child_entry->key)
+			{
+				child_entry = right_entry;
+				++child;
+			}
+		}
+
+		if(child_entry->key <= last.key)
+		{
+			break;
+		}
+
+		*entry = *child_entry;
+		entry = child_entry;
+		hole = child;
+	}
+
+	*entry = last;
+	SegmentedArrayTrim(queue->entries, queue->size);
+	return (0);
+}
+
+/******************************************************************************
+ * @brief       Copies the reference with the highest key without removing it.
+ * @param queue Pointer to the queue.
+ * @param ref   Receives the reference.
+ * @return      0 on success, or a non-zero value if the queue is empty.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+int RefQueuePeek(const ref_queue_t *queue, ref_queue_ref_t *ref)
+{
+	assert(queue && "Queue isn't valid.");
+	assert(ref && "Reference isn't valid.");
+	if(0 == queue->size)
+	{
+		return (1);
+	}
+
+	*ref = *RefQueueEntry(queue, 0);
+	return (0);
+}
+
+/******************************************************************************
+ * @brief       Returns the number of references in the queue.
+ * @param queue Pointer to the queue.
+ * @return      Number of references in the queue.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+size_t RefQueueSize(const ref_queue_t *queue)
+{
+	assert(queue && "Queue isn't valid.");
+	return (queue->size);
+}
+
+/******************************************************************************
+ * @brief       Checks if the queue is empty.
+ * @param queue Pointer to the queue.
+ * @return      Non-zero value if empty, 0 if not empty.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+int RefQueueIsEmpty(const ref_queue_t *queue)
+{
+	assert(queue && "Queue isn't valid.");
+	return (0 == queue->size);
+}
+
+/******************************************************************************
+ * @brief       Removes all references from the queue.
+ * @param queue Pointer to the queue.
+ * @note        Time Complexity: O(log n)
+******************************************************************************/
+void RefQueueClear(ref_queue_t *queue)
+{
+	assert(queue && "Queue isn't valid.");
+	queue->size = 0;
+	SegmentedArrayTrim(queue->entries, 0);
+}
+
+/******************************************************************************
+ * @brief       Returns the address of the entry at the given heap index.
+ * @param queue Pointer to the queue.
+ * @param index Index smaller than the entries capacity.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+static ref_queue_ref_t *RefQueueEntry(const ref_queue_t *queue, size_t index)
+{
+	return ((ref_queue_ref_t *)SegmentedArrayAt(queue->entries, index));
+}
+/*****************************************************************************/
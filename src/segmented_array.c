@@ -0,0 +1,201 @@
+/******************************************************************************
+ * @writer:      Tal Aharon
+ * @date:        18.10.2026
+ *
+ * @description: Implementation of a segmented array. Chunk k holds
+ * (SEGMENTED_ARRAY_FIRST_CHUNK << k) elements, so element i lives in the chunk
+ * selected by the most significant bit of (i + SEGMENTED_ARRAY_FIRST_CHUNK) and
+ * at the offset given by the remaining bits. The chunk directory has a fixed
+ * size, which means neither the elements nor the directory ever move.
+ *
+******************************************************************************/
+#include <assert.h>           /* assert       */
+#include <stdlib.h>           /* malloc, free */
+#include <limits.h>           /* CHAR_BIT     */
+
+#include "segmented_array.h"  /* Internal API */
+/*****************************************************************************/
+#define SEGMENTED_ARRAY_FIRST_CHUNK_LOG (4)
+#define SEGMENTED_ARRAY_FIRST_CHUNK ((size_t)1 << SEGMENTED_ARRAY_FIRST_CHUNK_LOG)
+#define SEGMENTED_ARRAY_MAX_CHUNKS (sizeof(size_t) * CHAR_BIT - SEGMENTED_ARRAY_FIRST_CHUNK_LOG)
+
+struct segmented_array
+{
+	char *chunks[SEGMENTED_ARRAY_MAX_CHUNKS];
+	size_t chunk_count;
+	size_t capacity;
+	size_t element_size;
+};
+
+static size_t SegmentedArrayMsb(size_t value);
+static size_t SegmentedArrayCapacityOf(size_t chunk_count);
+
+/******************************************************************************
+ * @brief              Creates a new, empty segmented array.
+ * @param element_size Size in bytes of a single element.
+ * @return             Pointer to the created array, or NULL if creation fails.
+ * @note               Time Complexity: O(1)
+******************************************************************************/
+segmented_array_t *SegmentedArrayCreate(size_t element_size)
+{
+	segmented_array_t *array = NULL;
+
+	assert(0 < element_size && "Element size isn't valid.");
+	array = (segmented_array_t *)malloc(sizeof(segmented_array_t));
+	if(NULL == array)
+	{
+		return (NULL);
+	}
+
+	array->chunk_count = 0;
+	array->capacity = 0;
+	array->element_size = element_size;
+	return (array);
+}
+
+/******************************************************************************
+ * @brief       Destroys a segmented array and all of its chunks.
+ * @param array Pointer to the array to be destroyed.
+ * @note        Time Complexity: O(log n)
+******************************************************************************/
+void SegmentedArrayDestroy(segmented_array_t *array)
+{
+	assert(array && "Array isn't valid.");
+	while(0 < array->chunk_count)
+	{
+		--array->chunk_count;
+		free(array->chunks[array->chunk_count]);
+	}
+
+	free(array);
+}
+
+/******************************************************************************
+ * @brief       Returns the address of the element at the given index.
+ * @param array Pointer to the array.
+ * @param index Index smaller than SegmentedArrayCapacity(array).
+ * @return      Address of the element.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+void *SegmentedArrayAt(const segmented_array_t *array, size_t index)
+{
+	size_t position = index + SEGMENTED_ARRAY_FIRST_CHUNK;
+	size_t msb = SegmentedArrayMsb(position);
+
+	assert(array && "Array isn't valid.");
+	assert(index < array->capacity && "Index out of range.");
+
+	return (array->chunks[msb - SEGMENTED_ARRAY_FIRST_CHUNK_LOG] +
+	        (position ^ ((size_t)1 << msb)) * array->element_size);
+}
+
+/******************************************************************************
+ * @brief       Returns the number of elements the array can hold right now.
+ * @param array Pointer to the array.
+ * @return      Number of addressable elements.
+ * @note        Time Complexity: O(1)
+******************************************************************************/
+size_t SegmentedArrayCapacity(const segmented_array_t *array)
+{
+	assert(array && "Array isn't valid.");
+	return (array->capacity);
+}
+
+/******************************************************************************
+ * @brief       Makes sure that at least count elements are addressable.
+ * @param array Pointer to the array.
+ * @param count Number of elements that must be addressable.
+ * @return      0 on success, or a non-zero value if allocation fails.
+ * @note        Time Complexity: O(1) per added chunk.
+******************************************************************************/
+int SegmentedArrayReserve(segmented_array_t *array, size_t count)
+{
+	char *chunk = NULL;
+
+	assert(array && "Array isn't valid.");
+	while(array->capacity < count)
+	{
+		if(SEGMENTED_ARRAY_MAX_CHUNKS == array->chunk_count)
+		{
+			return (1);
+		}
+
+		chunk = (char *)malloc(array->element_size *
+		        (SEGMENTED_ARRAY_FIRST_CHUNK << array->chunk_count));
+		if(NULL == chunk)
+		{
+			return (1);
+		}
+
+		array->chunks[array->chunk_count] = chunk;
+		++array->chunk_count;
+		array->capacity = SegmentedArrayCapacityOf(array->chunk_count);
+	}
+
+	return (0);
+}
+
+/******************************************************************************
+ * @brief        Returns the bytes the array has requested from malloc, the
+ *               directory included.
+ * @param array  Pointer to the array.
+ * @param blocks Receives the number of malloc blocks the bytes are spread on.
+ * @return       Number of bytes.
+ * @note         Time Complexity: O(1)
+******************************************************************************/
+size_t SegmentedArrayMemoryUsage(const segmented_array_t *array, size_t *blocks)
+{
+	assert(array && "Array isn't valid.");
+	assert(blocks && "Blocks aren't valid.");
+	*blocks = 1 + array->chunk_count;
+	return (sizeof(segmented_array_t) + array->capacity * array->element_size);
+}
+
+/******************************************************************************
+ * @brief       Releases chunks that are no longer needed to hold count elements,
+ *              keeping one spare chunk above the used ones.
+ * @param array Pointer to the array.
+ * @param count Number of elements still in use.
+ * @note        Time Complexity: O(1) per released chunk.
+******************************************************************************/
+void SegmentedArrayTrim(segmented_array_t *array, size_t count)
+{
+	assert(array && "Array isn't valid.");
+	while(2 < array->chunk_count && count <= SegmentedArrayCapacityOf(array->chunk_count - 2))
+	{
+		--array->chunk_count;
+		free(array->chunks[array->chunk_count]);
+		array->capacity = SegmentedArrayCapacityOf(array->chunk_count);
+	}
+}
+
+/******************************************************************************
+ * @brief       Returns the index of the most significant set bit of value.
+ * @param value Non-zero value.
+ * @note        Time Complexity: O(1) with GCC builtins, O(log bits) otherwise.
+******************************************************************************/
+static size_t SegmentedArrayMsb(size_t value)
+{
+	#if defined(__GNUC__)
+	return (sizeof(unsigned long) * CHAR_BIT - 1 - __builtin_clzl((unsigned long)value));
+	#else
+	size_t msb = 0;
+	while(value >>= 1)
+	{
+		++msb;
+	}
+
+	return (msb);
+	#endif
+}
+
+/******************************************************************************
+ * @brief             Returns the number of elements held by the first chunks.
+ * @param chunk_count Number of chunks.
+ * @note              Time Complexity: O(1)
+******************************************************************************/
+static size_t SegmentedArrayCapacityOf(size_t chunk_count)
+{
+	return (SEGMENTED_ARRAY_FIRST_CHUNK * (((size_t)1 << chunk_count) - 1));
+}
+/*****************************************************************************/
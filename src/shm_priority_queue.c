@@ -0,0 +1,682 @@
+/******************************************************************************
+ * @writer:      Tal Aharon
+ * @date:        18.10.2026
+ *
+ * @description: Implementation of a priority queue inside a POSIX shared memory
+ * segment. The segment starts with a header holding the robust mutex, the heap
+ * size and a small journal of the operation in progress; the heap entries
+ * follow at a fixed offset from the start of the segment.
+ *
+ * Sifts move a hole instead of swapping entries, and the journal records the
+ * entry being placed, the position of the hole and the size the operation
+ * started from. At every point of a sift the entries outside the hole form a
+ * valid multiset, so a process that takes over the lock from a dead owner can
+ * resume the sift from the journaled hole and complete the operation.
+ *
+******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>             /* assert                    */
+#include <stdlib.h>             /* malloc, free              */
+#include <errno.h>              /* EOWNERDEAD, ETIMEDOUT     */
+#include <fcntl.h>              /* O_CREAT, O_EXCL, O_RDWR   */
+#include <pthread.h>            /* pthread_mutex_*, cond_*   */
+#include <time.h>               /* clock_gettime             */
+#include <sys/mman.h>           /* shm_open, mmap, munmap    */
+#include <sys/stat.h>           /* fstat                     */
+#include <unistd.h>             /* ftruncate, close          */
+
+#include "shm_priority_queue.h" /* Internal API              */
+/*****************************************************************************/
+#define SHM_PRIORITY_QUEUE_MAGIC (0x53514d51UL)
+#define SHM_PRIORITY_QUEUE_ALIGN ((size_t)64)
+
+#if defined(__GNUC__)
+#define SHM_PRIORITY_QUEUE_BARRIER() __asm__ __volatile__("" ::: "memory")
+#else
+#define SHM_PRIORITY_QUEUE_BARRIER()
+#endif
+
+enum shm_priority_queue_operation
+{
+	SHM_PRIORITY_QUEUE_IDLE = 0,
+	SHM_PRIORITY_QUEUE_PUSH,
+	SHM_PRIORITY_QUEUE_POP
+};
+
+typedef struct shm_priority_queue_header
+{
+	unsigned long magic;
+	size_t capacity;
+	size_t size;
+	size_t entries_offset;
+	pthread_mutex_t lock;
+	pthread_cond_t not_full;
+	size_t waiting;
+
+	/* Journal of the operation in progress */
+	int operation;
+	size_t operation_size;
+	size_t hole;
+	shm_priority_queue_entry_t pending;
+
+} shm_priority_queue_header_t;
+
+struct shm_priority_queue
+{
+	shm_priority_queue_header_t *header;
+	size_t length;
+};
+
+static shm_priority_queue_t *ShmPriorityQueueMap(int fd, size_t length);
+static size_t ShmPriorityQueueEntriesOffset(void);
+static shm_priority_queue_entry_t *ShmPriorityQueueEntries(shm_priority_queue_header_t *header);
+static int ShmPriorityQueueLock(shm_priority_queue_t *queue);
+static int ShmPriorityQueueWait(shm_priority_queue_t *queue, const struct timespec *deadline);
+static void ShmPriorityQueuePush(shm_priority_queue_header_t *header, ref_queue_key_t key, ref_queue_offset_t offset);
+static void ShmPriorityQueueUnlock(shm_priority_queue_t *queue);
+static void ShmPriorityQueueRecover(shm_priority_queue_header_t *header);
+static void ShmPriorityQueueSiftUp(shm_priority_queue_header_t *header);
+static void ShmPriorityQueueSiftDown(shm_priority_queue_header_t *header);
+
+/******************************************************************************
+ * @brief Creates a new shared memory segment holding an empty queue and maps
+ * it into the calling process. Fails if a segment with that name exists.
+ *
+ * @param name     Name of the segment, in shm_open format ("/name").
+ * @param capacity Maximal number of entries the queue can hold.
+ * @return         Pointer to the process-local queue object, or NULL on failure.
+ * @note           complexity   Time: O(1), Space: O(capacity)
+******************************************************************************/
+shm_priority_queue_t *ShmPriorityQueueCreate(const char *name, size_t capacity)
+{
+	int fd = -1;
+	size_t length = 0;
+	pthread_mutexattr_t attributes;
+	pthread_condattr_t condition_attributes;
+	shm_priority_queue_t *queue = NULL;
+	shm_priority_queue_header_t *header = NULL;
+
+	assert(name && "Name is not valid");
+	assert(0 < capacity && "Capacity is not valid");
+
+	length = ShmPriorityQueueEntriesOffset() + capacity * sizeof(shm_priority_queue_entry_t);
+	fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+	if(-1 == fd)
+	{
+		return NULL;
+	}
+
+	if(-1 == ftruncate(fd, (off_t)length) ||
+	   NULL == (queue = ShmPriorityQueueMap(fd, length)))
+	{
+		close(fd);
+		shm_unlink(name);
+		return NULL;
+	}
+
+	close(fd);
+	header = queue -> header;
+
+	if(0 != pthread_mutexattr_init(&attributes))
+	{
+		ShmPriorityQueueClose(queue);
+		shm_unlink(name);
+		return NULL;
+	}
+
+	if(0 != pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED) ||
+	   0 != pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST) ||
+	   0 != pthread_mutex_init(&header -> lock, &attributes))
+	{
+		pthread_mutexattr_destroy(&attributes);
+		ShmPriorityQueueClose(queue);
+		shm_unlink(name);
+		return NULL;
+	}
+
+	pthread_mutexattr_destroy(&attributes);
+	if(0 != pthread_condattr_init(&condition_attributes))
+	{
+		pthread_mutex_destroy(&header -> lock);
+		ShmPriorityQueueClose(queue);
+		shm_unlink(name);
+		return NULL;
+	}
+
+	/* Deadlines are monotonic, so a clock change never stretches a wait */
+	if(0 != pthread_condattr_setpshared(&condition_attributes, PTHREAD_PROCESS_SHARED) ||
+	   0 != pthread_condattr_setclock(&condition_attributes, CLOCK_MONOTONIC) ||
+	   0 != pthread_cond_init(&header -> not_full, &condition_attributes))
+	{
+		pthread_condattr_destroy(&condition_attributes);
+		pthread_mutex_destroy(&header -> lock);
+		ShmPriorityQueueClose(queue);
+		shm_unlink(name);
+		return NULL;
+	}
+
+	pthread_condattr_destroy(&condition_attributes);
+	header -> waiting = 0;
+	header -> capacity = capacity;
+	header -> size = 0;
+	header -> entries_offset = ShmPriorityQueueEntriesOffset();
+	header -> operation = SHM_PRIORITY_QUEUE_IDLE;
+	header -> operation_size = 0;
+	header -> hole = 0;
+
+	/* Openers refuse the segment until the magic is in place */
+	SHM_PRIORITY_QUEUE_BARRIER();
+	header -> magic = SHM_PRIORITY_QUEUE_MAGIC;
+	return queue;
+}
+
+/******************************************************************************
+ * @brief Maps an existing queue segment, created by any process, into the
+ * calling process.
+ *
+ * @param name Name of the segment, in shm_open format ("/name").
+ * @return     Pointer to the process-local queue object, or NULL on failure.
+ * @note       complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+shm_priority_queue_t *ShmPriorityQueueOpen(const char *name)
+{
+	int fd = -1;
+	struct stat status;
+	shm_priority_queue_t *queue = NULL;
+	shm_priority_queue_header_t *header = NULL;
+
+	assert(name && "Name is not valid");
+	fd = shm_open(name, O_RDWR, 0);
+	if(-1 == fd)
+	{
+		return NULL;
+	}
+
+	if(-1 == fstat(fd, &status) ||
+	   (size_t)status.st_size < ShmPriorityQueueEntriesOffset() ||
+	   NULL == (queue = ShmPriorityQueueMap(fd, (size_t)status.st_size)))
+	{
+		close(fd);
+		return NULL;
+	}
+
+	close(fd);
+	header = queue -> header;
+	if(SHM_PRIORITY_QUEUE_MAGIC != header -> magic ||
+	   queue -> length < header -> entries_offset +
+	   header -> capacity * sizeof(shm_priority_queue_entry_t))
+	{
+		ShmPriorityQueueClose(queue);
+		return NULL;
+	}
+
+	return queue;
+}
+
+/******************************************************************************
+ * @brief Unmaps the queue from the calling process.
+ *
+ * @param queue Pointer to the queue object.
+ * @note        complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+void ShmPriorityQueueClose(shm_priority_queue_t *queue)
+{
+	assert(queue && "Queue is not valid");
+	munmap((void *)queue -> header, queue -> length);
+	free(queue);
+	queue = NULL;
+}
+
+/******************************************************************************
+ * @brief Removes the segment name.
+ *
+ * @param name Name of the segment.
+ * @return     0 on success, or a non-zero value on failure.
+******************************************************************************/
+int ShmPriorityQueueUnlink(const char *name)
+{
+	assert(name && "Name is not valid");
+	return (0 != shm_unlink(name));
+}
+
+/******************************************************************************
+ * @brief Adds an entry to the queue.
+ *
+ * @param queue  Pointer to the queue object.
+ * @param key    Priority of the entry, higher keys are dequeued first.
+ * @param offset Offset of the payload in the shared memory holding it.
+ * @return       SHM_PRIORITY_QUEUE_SUCCESS, SHM_PRIORITY_QUEUE_FULL, or
+ *               SHM_PRIORITY_QUEUE_ERROR if the lock could not be taken.
+ * @note         complexity   Time: O(log n), Space: O(1)
+******************************************************************************/
+shm_priority_queue_status_t ShmPriorityQueueEnqueue(shm_priority_queue_t *queue, ref_queue_key_t key, ref_queue_offset_t offset)
+{
+	shm_priority_queue_header_t *header = NULL;
+
+	assert(queue && "Queue is not valid");
+	if(ShmPriorityQueueLock(queue))
+	{
+		return SHM_PRIORITY_QUEUE_ERROR;
+	}
+
+	header = queue -> header;
+	if(header -> size == header -> capacity)
+	{
+		ShmPriorityQueueUnlock(queue);
+		return SHM_PRIORITY_QUEUE_FULL;
+	}
+
+	ShmPriorityQueuePush(header, key, offset);
+	ShmPriorityQueueUnlock(queue);
+	return SHM_PRIORITY_QUEUE_SUCCESS;
+}
+
+/******************************************************************************
+ * @brief Adds an entry to the queue, waiting for room while the queue is full.
+ *
+ * @param queue      Pointer to the queue object.
+ * @param key        Priority of the entry, higher keys are dequeued first.
+ * @param offset     Offset of the payload in the shared memory holding it.
+ * @param timeout_us Longest time to wait for room, in microseconds.
+ * @return           SHM_PRIORITY_QUEUE_SUCCESS, SHM_PRIORITY_QUEUE_FULL, or
+ *                   SHM_PRIORITY_QUEUE_ERROR if the lock could not be taken.
+ * @note             complexity   Time: O(log n) besides the wait, Space: O(1)
+******************************************************************************/
+shm_priority_queue_status_t ShmPriorityQueueEnqueueTimed(shm_priority_queue_t *queue, ref_queue_key_t key, ref_queue_offset_t offset, unsigned long timeout_us)
+{
+	int status = 0;
+	struct timespec deadline;
+	shm_priority_queue_header_t *header = NULL;
+
+	assert(queue && "Queue is not valid");
+	if(0 != clock_gettime(CLOCK_MONOTONIC, &deadline))
+	{
+		return SHM_PRIORITY_QUEUE_ERROR;
+	}
+
+	deadline.tv_sec += (time_t)(timeout_us / 1000000UL);
+	deadline.tv_nsec += (long)(timeout_us % 1000000UL) * 1000L;
+	if(1000000000L <= deadline.tv_nsec)
+	{
+		++deadline.tv_sec;
+		deadline.tv_nsec -= 1000000000L;
+	}
+
+	if(ShmPriorityQueueLock(queue))
+	{
+		return SHM_PRIORITY_QUEUE_ERROR;
+	}
+
+	header = queue -> header;
+	while(header -> size == header -> capacity && 0 != timeout_us)
+	{
+		++header -> waiting;
+		status = ShmPriorityQueueWait(queue, &deadline);
+		--header -> waiting;
+		if(ETIMEDOUT == status)
+		{
+			break;
+		}
+
+		if(0 != status)
+		{
+			ShmPriorityQueueUnlock(queue);
+			return SHM_PRIORITY_QUEUE_ERROR;
+		}
+	}
+
+	if(header -> size == header -> capacity)
+	{
+		ShmPriorityQueueUnlock(queue);
+		return SHM_PRIORITY_QUEUE_FULL;
+	}
+
+	ShmPriorityQueuePush(header, key, offset);
+	ShmPriorityQueueUnlock(queue);
+	return SHM_PRIORITY_QUEUE_SUCCESS;
+}
+
+/******************************************************************************
+ * @brief Removes the entry with the highest key from the queue.
+ *
+ * @param queue Pointer to the queue object.
+ * @param entry Receives the removed entry. May be NULL.
+ * @return      SHM_PRIORITY_QUEUE_SUCCESS, SHM_PRIORITY_QUEUE_EMPTY, or
+ *              SHM_PRIORITY_QUEUE_ERROR if the lock could not be taken.
+ * @note        complexity   Time: O(log n), Space: O(1)
+******************************************************************************/
+shm_priority_queue_status_t ShmPriorityQueueDequeue(shm_priority_queue_t *queue, shm_priority_queue_entry_t *entry)
+{
+	shm_priority_queue_header_t *header = NULL;
+	shm_priority_queue_entry_t *entries = NULL;
+
+	assert(queue && "Queue is not valid");
+	if(ShmPriorityQueueLock(queue))
+	{
+		return SHM_PRIORITY_QUEUE_ERROR;
+	}
+
+	header = queue -> header;
+	if(0 == header -> size)
+	{
+		ShmPriorityQueueUnlock(queue);
+		return SHM_PRIORITY_QUEUE_EMPTY;
+	}
+
+	entries = ShmPriorityQueueEntries(header);
+	if(NULL != entry)
+	{
+		*entry = entries[0];
+	}
+
+	header -> pending = entries[header -> size - 1];
+	header -> operation_size = header -> size;
+	header -> hole = 0;
+	SHM_PRIORITY_QUEUE_BARRIER();
+	header -> operation = SHM_PRIORITY_QUEUE_POP;
+	SHM_PRIORITY_QUEUE_BARRIER();
+
+	--header -> size;
+	ShmPriorityQueueSiftDown(header);
+
+	SHM_PRIORITY_QUEUE_BARRIER();
+	header -> operation = SHM_PRIORITY_QUEUE_IDLE;
+
+	/* Without waiters the dequeue stays free of system calls */
+	if(0 != header -> waiting)
+	{
+		pthread_cond_signal(&header -> not_full);
+	}
+
+	ShmPriorityQueueUnlock(queue);
+	return SHM_PRIORITY_QUEUE_SUCCESS;
+}
+
+/******************************************************************************
+ * @brief Copies the entry with the highest key without removing it.
+ *
+ * @param queue Pointer to the queue object.
+ * @param entry Receives the entry.
+ * @return      SHM_PRIORITY_QUEUE_SUCCESS, SHM_PRIORITY_QUEUE_EMPTY, or
+ *              SHM_PRIORITY_QUEUE_ERROR if the lock could not be taken.
+ * @note        complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+shm_priority_queue_status_t ShmPriorityQueuePeek(shm_priority_queue_t *queue, shm_priority_queue_entry_t *entry)
+{
+	shm_priority_queue_status_t status = SHM_PRIORITY_QUEUE_SUCCESS;
+
+	assert(queue && "Queue is not valid");
+	assert(entry && "Entry is not valid");
+	if(ShmPriorityQueueLock(queue))
+	{
+		return SHM_PRIORITY_QUEUE_ERROR;
+	}
+
+	if(0 == queue -> header -> size)
+	{
+		status = SHM_PRIORITY_QUEUE_EMPTY;
+	}
+	else
+	{
+		*entry = ShmPriorityQueueEntries(queue -> header)[0];
+	}
+
+	ShmPriorityQueueUnlock(queue);
+	return status;
+}
+
+/******************************************************************************
+ * @brief Returns the number of entries in the queue.
+ *
+ * @param queue Pointer to the queue object.
+ * @return      Number of entries in the queue.
+ * @note        complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+size_t ShmPriorityQueueSize(const shm_priority_queue_t *queue)
+{
+	size_t size = 0;
+
+	assert(queue && "Queue is not valid");
+	if(ShmPriorityQueueLock((shm_priority_queue_t *)queue))
+	{
+		return 0;
+	}
+
+	size = queue -> header -> size;
+	ShmPriorityQueueUnlock((shm_priority_queue_t *)queue);
+	return size;
+}
+
+/******************************************************************************
+ * @brief Returns the number of entries the queue can hold.
+ *
+ * @param queue Pointer to the queue object.
+ * @return      Capacity of the queue.
+ * @note        complexity   Time: O(1), Space: O(1)
+******************************************************************************/
+size_t ShmPriorityQueueCapacity(const shm_priority_queue_t *queue)
+{
+	assert(queue && "Queue is not valid");
+	return queue -> header -> capacity;
+}
+
+/******************************************************************************
+ * @brief Maps a segment and wraps it in a process-local queue object.
+ *
+ * @param fd     Descriptor of the shared memory object.
+ * @param length Length of the segment in bytes.
+ * @return       Pointer to the queue object, or NULL on failure.
+******************************************************************************/
+static shm_priority_queue_t *ShmPriorityQueueMap(int fd, size_t length)
+{
+	void *segment = NULL;
+	shm_priority_queue_t *queue = (shm_priority_queue_t *)
+	malloc(sizeof(shm_priority_queue_t));
+	if(NULL == queue)
+	{
+		return NULL;
+	}
+
+	segment = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if(MAP_FAILED == segment)
+	{
+		free(queue);
+		return NULL;
+	}
+
+	queue -> header = (shm_priority_queue_header_t *)segment;
+	queue -> length = length;
+	return queue;
+}
+
+/******************************************************************************
+ * @brief Returns the offset of the entries from the start of the segment.
+******************************************************************************/
+static size_t ShmPriorityQueueEntriesOffset(void)
+{
+	return (sizeof(shm_priority_queue_header_t) + SHM_PRIORITY_QUEUE_ALIGN - 1) &
+	       ~(SHM_PRIORITY_QUEUE_ALIGN - 1);
+}
+
+/******************************************************************************
+ * @brief Resolves the entries of the segment in the calling process.
+ *
+ * @param header Header of the mapped segment.
+ * @return       Address of the first entry.
+******************************************************************************/
+static shm_priority_queue_entry_t *ShmPriorityQueueEntries(shm_priority_queue_header_t *header)
+{
+	return (shm_priority_queue_entry_t *)((char *)header + header -> entries_offset);
+}
+
+/******************************************************************************
+ * @brief Takes the queue lock, completing the operation of a dead owner first.
+ *
+ * @param queue Pointer to the queue object.
+ * @return      0 on success, or a non-zero value on failure.
+******************************************************************************/
+static int ShmPriorityQueueLock(shm_priority_queue_t *queue)
+{
+	int status = pthread_mutex_lock(&queue -> header -> lock);
+
+	if(EOWNERDEAD == status)
+	{
+		ShmPriorityQueueRecover(queue -> header);
+		status = pthread_mutex_consistent(&queue -> header -> lock);
+	}
+
+	return status;
+}
+
+/******************************************************************************
+ * @brief Waits for room until the deadline, taking the lock back like
+ * ShmPriorityQueueLock if its owner died in the meantime.
+ *
+ * @param queue    Pointer to the queue object, locked by the caller.
+ * @param deadline Monotonic time at which to give up.
+ * @return         0 once woken, ETIMEDOUT, or another non-zero value on
+ *                 failure. The lock is held again in the first two cases.
+******************************************************************************/
+static int ShmPriorityQueueWait(shm_priority_queue_t *queue, const struct timespec *deadline)
+{
+	int status = pthread_cond_timedwait(&queue -> header -> not_full, &queue -> header -> lock, deadline);
+
+	if(EOWNERDEAD == status)
+	{
+		ShmPriorityQueueRecover(queue -> header);
+		status = pthread_mutex_consistent(&queue -> header -> lock);
+	}
+
+	return status;
+}
+
+/******************************************************************************
+ * @brief Releases the queue lock.
+ *
+ * @param queue Pointer to the queue object.
+******************************************************************************/
+static void ShmPriorityQueueUnlock(shm_priority_queue_t *queue)
+{
+	pthread_mutex_unlock(&queue -> header -> lock);
+}
+
+/******************************************************************************
+ * @brief Places an entry into a queue that has room, journaling the operation.
+ *
+ * @param header Header of the mapped segment, locked by the caller.
+ * @param key    Priority of the entry.
+ * @param offset Offset of the payload.
+ * @note         complexity   Time: O(log n), Space: O(1)
+******************************************************************************/
+static void ShmPriorityQueuePush(shm_priority_queue_header_t *header, ref_queue_key_t key, ref_queue_offset_t offset)
+{
+	header -> pending.key = key;
+	header -> pending.offset = offset;
+	header -> operation_size = header -> size;
+	header -> hole = header -> size;
+	SHM_PRIORITY_QUEUE_BARRIER();
+	header -> operation = SHM_PRIORITY_QUEUE_PUSH;
+	SHM_PRIORITY_QUEUE_BARRIER();
+
+	++header -> size;
+	ShmPriorityQueueSiftUp(header);
+
+	SHM_PRIORITY_QUEUE_BARRIER();
+	header -> operation = SHM_PRIORITY_QUEUE_IDLE;
+}
+
+/******************************************************************************
+ * @brief Completes the operation that was in progress when the lock owner died.
+ * Resuming the sift from the journaled hole is idempotent, so recovery itself
+ * may be interrupted and replayed.
+ *
+ * @param header Header of the mapped segment.
+******************************************************************************/
+static void ShmPriorityQueueRecover(shm_priority_queue_header_t *header)
+{
+	switch(header -> operation)
+	{
+		case SHM_PRIORITY_QUEUE_PUSH:
+			header -> size = header -> operation_size + 1;
+			ShmPriorityQueueSiftUp(header);
+			break;
+
+		case SHM_PRIORITY_QUEUE_POP:
+			header -> size = header -> operation_size - 1;
+			ShmPriorityQueueSiftDown(header);
+			break;
+
+		default:
+			return;
+	}
+
+	SHM_PRIORITY_QUEUE_BARRIER();
+	header -> operation = SHM_PRIORITY_QUEUE_IDLE;
+}
+
+/******************************************************************************
+ * @brief Moves the journaled hole up until the pending entry fits into it.
+ *
+ * @param header Header of the mapped segment.
+ * @note         complexity   Time: O(log n), Space: O(1)
+******************************************************************************/
+static void ShmPriorityQueueSiftUp(shm_priority_queue_header_t *header)
+{
+	shm_priority_queue_entry_t *entries = ShmPriorityQueueEntries(header);
+	size_t hole = header -> hole;
+	size_t parent = 0;
+
+	while(0 < hole)
+	{
+		parent = (hole - 1) / 2;
+		if(entries[parent].key >= header -> pending.key)
+		{
+			break;
+		}
+
+		entries[hole] = entries[parent];
+		SHM_PRIORITY_QUEUE_BARRIER();
+		header -> hole = hole = parent;
+	}
+
+	entries[hole] = header -> pending;
+}
+
+/******************************************************************************
+ * @brief Moves the journaled hole down until the pending entry fits into it.
+ *
+ * @param header Header of the mapped segment.
+ * @note         complexity   Time: O(log n), Space: O(1)
+******************************************************************************/
+static void ShmPriorityQueueSiftDown(shm_priority_queue_header_t *header)
+{
+	shm_priority_queue_entry_t *entries = ShmPriorityQueueEntries(header);
+	size_t hole = header -> hole;
+	size_t child = 0;
+
+	if(0 == header -> size)
+	{
+		return;
+	}
+
+	while((child = 2 * hole + 1) < header -> size)
+	{
+		if(child + 1 < header -> size && entries[child + 1].key > entries[child].key)
+		{
+			++child;
+		}
+
+		if(entries[child].key <= header -> pending.key)
+		{
+			break;
+		}
+
+		entries[hole] = entries[child];
+		SHM_PRIORITY_QUEUE_BARRIER();
+		header -> hole = hole = child;
+	}
+
+	entries[hole] = header -> pending;
+}
+/*****************************************************************************/
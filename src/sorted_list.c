@@ -26,6 +26,7 @@ struct sorted_list
 {
 	dll_t *dll;
 	sorted_list_compare_func_t cmp;
+	size_t comparisons;
 };
 
 /******************************************************************************
@@ -50,6 +51,7 @@ sorted_list_t *SortedListCreate(sorted_list_compare_func_t compare)
 	}
 
 	sorted_list->cmp = compare;
+	sorted_list->comparisons = 0;
 	return (sorted_list);
 }
 
@@ -77,6 +79,37 @@ size_t SortedListCount(const sorted_list_t *sorted_list)
 	return DLLCount(sorted_list->dll);
 }
 
+/******************************************************************************
+ * @brief             Returns the number of comparisons the sorted list has made
+ *                    since its creation.
+ * @param sorted_list Pointer to the sorted list.
+ * @return            Number of calls to the compare function.
+ * @note              Time Complexity: O(1)
+******************************************************************************/
+size_t SortedListComparisons(const sorted_list_t *sorted_list)
+{
+	assert(sorted_list && "List isn't valid.");
+	return (sorted_list->comparisons);
+}
+
+/******************************************************************************
+ * @brief             Returns the bytes the sorted list has requested from malloc.
+ * @param sorted_list Pointer to the sorted list.
+ * @param nodes       Receives the bytes of the nodes holding data.
+ * @param blocks      Receives the number of malloc blocks the bytes are spread on.
+ * @return            Number of bytes, the list itself included.
+ * @note              Time Complexity: O(n)
+******************************************************************************/
+size_t SortedListMemoryUsage(const sorted_list_t *sorted_list, size_t *nodes, size_t *blocks)
+{
+	size_t bytes = 0;
+	assert(sorted_list && "List isn't valid.");
+
+	bytes = DLLMemoryUsage(sorted_list->dll, nodes, blocks);
+	++*blocks;
+	return (sizeof(sorted_list_t) + bytes);
+}
+
 /******************************************************************************
  * @brief             Returns an iterator pointing to the start of the sorted list.
  * @param sorted_list Pointer to the sorted list.
@@ -186,12 +219,21 @@ sorted_list_iter_t SortedListInsert(sorted_list_t *sorted_list, void *data)
 	assert(sorted_list && "List isn't valid.");
 	end = SortedListEnd(sorted_list);
 	start = SortedListBegin(sorted_list);
-	while(start.iterator != end.iterator && 0 > (sorted_list->cmp(SortedListGetData(start), data)))
+	for(; start.iterator != end.iterator; start = SortedListNext(start))
 	{
-		start = SortedListNext(start);
+		++sorted_list->comparisons;
+		if(0 <= sorted_list->cmp(SortedListGetData(start), data))
+		{
+			break;
+		}
 	}
 
 	start.iterator = DLLInsertBefore(start.iterator, data);
+	if(NULL == start.iterator)
+	{
+		return (end);
+	}
+
 	#ifndef NDEBUG
 	start.list = sorted_list;
 	#endif
@@ -274,9 +316,13 @@ void SortedListMerge(sorted_list_t *dest, sorted_list_t *source)
 
 	while(from != DLLEnd(source->dll))
 	{
-		while(runner != DLLEnd(dest->dll) && 0 >= (dest->cmp(DLLGetData(runner), DLLGetData(from))))
+		for(; runner != DLLEnd(dest->dll); runner = DLLNext(runner))
 		{
-			runner = DLLNext(runner);
+			++dest->comparisons;
+			if(0 < dest->cmp(DLLGetData(runner), DLLGetData(from)))
+			{
+				break;
+			}
 		}
 
 		if(runner == DLLEnd(dest->dll))
@@ -285,14 +331,21 @@ void SortedListMerge(sorted_list_t *dest, sorted_list_t *source)
 		}
 		else
 		{
-			while(to != DLLEnd(source->dll) && 0 > (dest->cmp(DLLGetData(to), DLLGetData(runner))))
+			for(; to != DLLEnd(source->dll); to = DLLNext(to))
 			{
-				to = DLLNext(to);
+				++dest->comparisons;
+				if(0 <= dest->cmp(DLLGetData(to), DLLGetData(runner)))
+				{
+					break;
+				}
 			}
 		}
 
 		DLLSplice(runner, from, to);
+
+		/* The spliced nodes, to included, now belong to dest */
 		from = DLLBegin(source->dll);
+		to = from;
 	}
 }
 
@@ -307,7 +360,7 @@ void SortedListMerge(sorted_list_t *dest, sorted_list_t *source)
  *
  * @note            Time Complexity: O(n)
 ******************************************************************************/
-sorted_list_iter_t SortedListFind(const sorted_list_t *list, const sorted_list_iter_t from, const sorted_list_iter_t to, void *parameter)
+sorted_list_iter_t SortedListFind(sorted_list_t *list, const sorted_list_iter_t from, const sorted_list_iter_t to, void *parameter)
 {
 	sorted_list_iter_t target = from;
 
@@ -319,9 +372,14 @@ sorted_list_iter_t SortedListFind(const sorted_list_t *list, const sorted_list_i
 	assert(from.list == to.list && "Iterators not belong to the same list.");
 	#endif
 
-	for(; target.iterator !=  to.iterator && 
-	0 < list->cmp(SortedListGetData(target), parameter);
-	target = SortedListNext(target));
+	for(; target.iterator !=  to.iterator; target = SortedListNext(target))
+	{
+		++list->comparisons;
+		if(0 >= list->cmp(SortedListGetData(target), parameter))
+		{
+			break;
+		}
+	}
 
 	return (target);
 }
@@ -0,0 +1,1365 @@
+/******************************************************************************
+ * @writer:      Tal Aharon
+ * @date:        19.10.2026
+ *
+ * @description: Implementation of a van Emde Boas tree over the distinct keys,
+ * with the data of every key in a FIFO bucket. A node of b bits splits a key
+ * into its high and low halves: the high half picks one of the clusters, nodes
+ * of the low bits, and the summary, a node of the high bits, holds the high
+ * halves of the clusters that are not empty. The smallest key of a node is
+ * kept in the node alone and never enters a cluster, so inserting into an
+ * empty cluster is O(1) and every operation recurses into one node per level.
+ * Nodes of up to VEB_LEAF_BITS bits are a single word of bits.
+ *
+ * A node is sparse until it holds VEB_SPARSE_KEYS keys: the keys above its
+ * minimum sit in a sorted array, searched by bisection and shifted by memmove
+ * on a change, both bounded by a constant, and the node has no summary and no
+ * clusters. Only a node that fills its array spreads into a dense one, with a
+ * table of 2^(bits/2) clusters, and a dense node that falls to a quarter of
+ * that gathers its keys back into an array. Random keys leave most nodes
+ * below the root sparse, so the index costs a few bytes per key instead of a
+ * table per key, and an insert or a removal touches the root table and one
+ * array rather than a chain of tables and nodes.
+ *
+ * Nodes and arrays are allocated the first time a key needs them and a
+ * cluster is freed as soon as it is empty, so apart from the table of the
+ * root memory follows the keys held, not the universe. A cluster exists
+ * exactly while the summary holds it, so clearing a node visits its clusters
+ * through the summary rather than its whole table, and the table itself comes
+ * zeroed from calloc, whose pages are only touched where clusters are. All
+ * allocations of an insert are made before the tree is changed, so a failed
+ * insert leaves it as it was.
+ *
+ * Buckets live in an open addressing hash table keyed by the key, with linear
+ * probing and backward shift deletion.
+ *
+******************************************************************************/
+#include <assert.h>          /* assert               */
+#include <limits.h>          /* CHAR_BIT, ULONG_MAX  */
+#include <stdlib.h>          /* malloc, calloc, free */
+#include <string.h>          /* memcpy, memmove      */
+
+#include "veb.h"             /* Internal API */
+/*****************************************************************************/
+#if ULONG_MAX > 0xFFFFFFFFUL
+#define VEB_LEAF_BITS (6)
+#else
+#define VEB_LEAF_BITS (5)
+#endif
+
+#define VEB_SPARSE_KEYS (128)
+#define VEB_SPARSE_MIN_CAPACITY (4)
+#define VEB_MIN_BUCKETS_LOG (4)
+#define VEB_HASH_BITS (32)
+#define VEB_HASH_MULTIPLIER (2654435769UL)
+
+#define VEB_LOW_BITS(bits) ((bits) / 2)
+#define VEB_HIGH_BITS(bits) ((bits) - (bits) / 2)
+#define VEB_HIGH(key, bits) ((key) >> VEB_LOW_BITS(bits))
+#define VEB_LOW(key, bits) ((key) & ((1UL << VEB_LOW_BITS(bits)) - 1))
+#define VEB_INDEX(high, low, bits) (((high) << VEB_LOW_BITS(bits)) | (low))
+
+typedef struct veb_node veb_node_t;
+
+/* A leaf only uses bits, an inner node is empty while min is above max and
+   sparse while it has no clusters, its keys above min then in keys */
+struct veb_node
+{
+	unsigned long min;
+	unsigned long max;
+	unsigned long bits;
+	size_t count;
+	size_t capacity;
+	unsigned long *keys;
+	veb_node_t *summary;
+	veb_node_t **clusters;
+};
+
+typedef struct veb_item
+{
+	void *data;
+	struct veb_item *prev;
+	struct veb_item *next;
+
+} veb_item_t;
+
+/* A slot of the hash table, free while head is NULL */
+typedef struct veb_bucket
+{
+	unsigned long key;
+	veb_item_t *head;
+	veb_item_t *tail;
+
+} veb_bucket_t;
+
+struct veb
+{
+	veb_node_t *root;
+	veb_bucket_t *buckets;
+	size_t capacity;
+	size_t keys;
+	size_t size;
+	size_t node_bytes;
+	size_t node_blocks;
+	unsigned int shift;
+	unsigned int bits;
+};
+
+static veb_node_t *VebNodeCreate(veb_t *veb);
+static void VebNodeClear(veb_t *veb, veb_node_t *node, unsigned int bits);
+static void VebNodeDestroy(veb_t *veb, veb_node_t *node, unsigned int bits);
+static int VebNodeIsEmpty(const veb_node_t *node, unsigned int bits);
+static unsigned long VebNodeMin(const veb_node_t *node, unsigned int bits);
+static unsigned long VebNodeMax(const veb_node_t *node, unsigned int bits);
+static int VebNodeReserve(veb_t *veb, veb_node_t *node, unsigned int bits, unsigned long key);
+static int VebNodeResize(veb_t *veb, veb_node_t *node, size_t capacity);
+static int VebNodeFill(veb_t *veb, veb_node_t *node, unsigned int bits, const unsigned long *keys, size_t count);
+static int VebNodeSpread(veb_t *veb, veb_node_t *node, unsigned int bits);
+static void VebNodeGather(veb_t *veb, veb_node_t *node, unsigned int bits);
+static size_t VebNodeRank(const veb_node_t *node, unsigned long key);
+static void VebNodeInsert(veb_node_t *node, unsigned int bits, unsigned long key);
+static void VebNodeDelete(veb_t *veb, veb_node_t *node, unsigned int bits, unsigned long key);
+static int VebNodeNext(const veb_node_t *node, unsigned int bits, unsigned long value, unsigned long *key);
+static int VebNodePrev(const veb_node_t *node, unsigned int bits, unsigned long value, unsigned long *key);
+static unsigned long VebLowestBit(unsigned long word);
+static unsigned long VebHighestBit(unsigned long word);
+static veb_bucket_t *VebBucketFind(const veb_t *veb, unsigned long key);
+static int VebBucketGrow(veb_t *veb);
+static void VebBucketErase(veb_t *veb, veb_bucket_t *bucket);
+static void *VebUnlink(veb_t *veb, veb_bucket_t *bucket, veb_item_t *item);
+
+/******************************************************************************
+ * @brief      Creates a new, empty tree.
+ * @param bits Number of bits of the keys, 1 to VEB_MAX_BITS.
+ * @return     Pointer to the created tree, or NULL if creation fails.
+ * @note       Time Complexity: O(1)
+******************************************************************************/
+veb_t *VebCreate(unsigned int bits)
+{
+	size_t i = 0;
+	veb_t *veb = NULL;
+
+	assert(0 < bits && bits <= VEB_MAX_BITS && "Bits aren't valid.");
+	veb = (veb_t *)malloc(sizeof(veb_t));
+	if(NULL == veb)
+	{
+		return (NULL);
+	}
+
+	veb->node_bytes = 0;
+	veb->node_blocks = 0;
+	veb->root = VebNodeCreate(veb);
+	if(NULL == veb->root)
+	{
+		free(veb);
+		return (NULL);
+	}
+
+	veb->capacity = (size_t)1 << VEB_MIN_BUCKETS_LOG;
+	veb->buckets = (veb_bucket_t *)malloc(veb->capacity * sizeof(veb_bucket_t));
+	if(NULL == veb->buckets)
+	{
+		free(veb->root);
+		free(veb);
+		return (NULL);
+	}
+
+	for(i = 0; i < veb->capacity; ++i)
+	{
+		veb->buckets[i].head = NULL;
+	}
+
+	veb->keys = 0;
+	veb->size = 0;
+	veb->shift = VEB_HASH_BITS - VEB_MIN_BUCKETS_LOG;
+	veb->bits = bits;
+	return (veb);
+}
+
+/******************************************************************************
+ * @brief     Destroys a tree, its buckets and its nodes.
+ * @param veb Pointer to the tree to be destroyed.
+ * @note      Time Complexity: O(n)
+******************************************************************************/
+void VebDestroy(veb_t *veb)
+{
+	assert(veb && "Veb isn't valid.");
+
+	VebClear(veb);
+	VebNodeDestroy(veb, veb->root, veb->bits);
+	free(veb->buckets);
+	free(veb);
+}
+
+/******************************************************************************
+ * @brief      Inserts data under a key, behind the data already under it.
+ * @param veb  Pointer to the tree.
+ * @param key  Key of the data, below 2^bits.
+ * @param data Pointer to the data to be inserted.
+ * @return     0 on success, or a non-zero value if an allocation failed.
+ * @note       Time Complexity: O(1) for a key already present, O(log log U)
+ *             for a new one.
+******************************************************************************/
+int VebInsert(veb_t *veb, unsigned long key, void *data)
+{
+	veb_item_t *item = NULL;
+	veb_bucket_t *bucket = NULL;
+
+	assert(veb && "Veb isn't valid.");
+	assert(0 == (key >> (veb->bits - 1) >> 1) && "Key is out of the universe.");
+
+	item = (veb_item_t *)malloc(sizeof(veb_item_t));
+	if(NULL == item)
+	{
+		return (1);
+	}
+
+	item->data = data;
+	item->next = NULL;
+	bucket = VebBucketFind(veb, key);
+	if(NULL == bucket->head)
+	{
+		/* Both can fail, the insert itself can not */
+		if((veb->capacity < 2 * (veb->keys + 1) && 0 < veb->shift && VebBucketGrow(veb)) ||
+		   VebNodeReserve(veb, veb->root, veb->bits, key))
+		{
+			free(item);
+			return (1);
+		}
+
+		VebNodeInsert(veb->root, veb->bits, key);
+		bucket = VebBucketFind(veb, key);
+		bucket->key = key;
+		bucket->tail = NULL;
+		++veb->keys;
+	}
+
+	item->prev = bucket->tail;
+	if(NULL == bucket->tail)
+	{
+		bucket->head = item;
+	}
+	else
+	{
+		bucket->tail->next = item;
+	}
+
+	bucket->tail = item;
+	++veb->size;
+	return (0);
+}
+
+/******************************************************************************
+ * @brief       Inserts a batch, every data behind the data already under its
+ *              key. A failed insert takes back the ones before it, newest
+ *              first, so every item taken back is the tail of its key.
+ * @param veb   Pointer to the tree.
+ * @param items Array of count items, every key below 2^bits.
+ * @param count Number of items.
+ * @return      0 on success, or a non-zero value if an allocation failed.
+ * @note        Time Complexity: O(count log log U)
+******************************************************************************/
+int VebInsertBatch(veb_t *veb, const radix_sort_item_t *items, size_t count)
+{
+	size_t i = 0;
+	veb_bucket_t *bucket = NULL;
+
+	assert(veb && "Veb isn't valid.");
+	assert((items || 0 == count) && "Items aren't valid.");
+
+	for(i = 0; i < count; ++i)
+	{
+		if(VebInsert(veb, items[i].key, items[i].data))
+		{
+			while(0 < i)
+			{
+				bucket = VebBucketFind(veb, items[--i].key);
+				(void)VebUnlink(veb, bucket, bucket->tail);
+			}
+
+			return (1);
+		}
+	}
+
+	return (0);
+}
+
+/******************************************************************************
+ * @brief     Returns the oldest data of the smallest key.
+ * @param veb Pointer to a non empty tree.
+ * @return    Pointer to the data.
+ * @note      Time Complexity: O(1)
+******************************************************************************/
+void *VebPeekMin(const veb_t *veb)
+{
+	assert(veb && "Veb isn't valid.");
+	assert(0 < veb->size && "Veb is empty.");
+
+	return (VebBucketFind(veb, VebNodeMin(veb->root, veb->bits))->head->data);
+}
+
+/******************************************************************************
+ * @brief     Returns the newest data of the largest key.
+ * @param veb Pointer to a non empty tree.
+ * @return    Pointer to the data.
+ * @note      Time Complexity: O(1)
+******************************************************************************/
+void *VebPeekMax(const veb_t *veb)
+{
+	assert(veb && "Veb isn't valid.");
+	assert(0 < veb->size && "Veb is empty.");
+
+	return (VebBucketFind(veb, VebNodeMax(veb->root, veb->bits))->tail->data);
+}
+
+/******************************************************************************
+ * @brief     Removes and returns the oldest data of the smallest key.
+ * @param veb Pointer to a non empty tree.
+ * @return    Pointer to the removed data.
+ * @note      Time Complexity: O(1) while the key has more data, O(log log U)
+ *            when it leaves.
+******************************************************************************/
+void *VebPopMin(veb_t *veb)
+{
+	veb_bucket_t *bucket = NULL;
+
+	assert(veb && "Veb isn't valid.");
+	assert(0 < veb->size && "Veb is empty.");
+
+	bucket = VebBucketFind(veb, VebNodeMin(veb->root, veb->bits));
+	return (VebUnlink(veb, bucket, bucket->head));
+}
+
+/******************************************************************************
+ * @brief     Removes and returns the newest data of the largest key.
+ * @param veb Pointer to a non empty tree.
+ * @return    Pointer to the removed data.
+ * @note      Time Complexity: O(1) while the key has more data, O(log log U)
+ *            when it leaves.
+******************************************************************************/
+void *VebPopMax(veb_t *veb)
+{
+	veb_bucket_t *bucket = NULL;
+
+	assert(veb && "Veb isn't valid.");
+	assert(0 < veb->size && "Veb is empty.");
+
+	bucket = VebBucketFind(veb, VebNodeMax(veb->root, veb->bits));
+	return (VebUnlink(veb, bucket, bucket->tail));
+}
+
+/******************************************************************************
+ * @brief       Finds the oldest data of the smallest key not below a value.
+ * @param veb   Pointer to the tree.
+ * @param value Value to start from, below 2^bits.
+ * @param data  Receives the data when found.
+ * @return      0 if found, or a non-zero value if every key is below value.
+ * @note        Time Complexity: O(log log U)
+******************************************************************************/
+int VebFindNext(const veb_t *veb, unsigned long value, void **data)
+{
+	unsigned long key = 0;
+
+	assert(veb && "Veb isn't valid.");
+	assert(data && "Data isn't valid.");
+	assert(0 == (value >> (veb->bits - 1) >> 1) && "Value is out of the universe.");
+
+	if(VebNodeNext(veb->root, veb->bits, value, &key))
+	{
+		return (1);
+	}
+
+	*data = VebBucketFind(veb, key)->head->data;
+	return (0);
+}
+
+/******************************************************************************
+ * @brief       Finds the oldest data of the largest key not above a value.
+ * @param veb   Pointer to the tree.
+ * @param value Value to start from, below 2^bits.
+ * @param data  Receives the data when found.
+ * @return      0 if found, or a non-zero value if every key is above value.
+ * @note        Time Complexity: O(log log U)
+******************************************************************************/
+int VebFindPrev(const veb_t *veb, unsigned long value, void **data)
+{
+	unsigned long key = 0;
+
+	assert(veb && "Veb isn't valid.");
+	assert(data && "Data isn't valid.");
+	assert(0 == (value >> (veb->bits - 1) >> 1) && "Value is out of the universe.");
+
+	if(VebNodePrev(veb->root, veb->bits, value, &key))
+	{
+		return (1);
+	}
+
+	*data = VebBucketFind(veb, key)->head->data;
+	return (0);
+}
+
+/******************************************************************************
+ * @brief           Removes the first data, in the order of removal from the
+ *                  minimum, that the matching function accepts.
+ * @param veb       Pointer to the tree.
+ * @param ismatch   Matching function.
+ * @param parameter Parameter passed to the matching function.
+ * @param data      Receives the removed data when found.
+ * @return          0 if data was removed, or a non-zero value if none matched.
+ * @note            Time Complexity: O(n + k log log U) for k distinct keys.
+******************************************************************************/
+int VebRemoveIf(veb_t *veb, veb_ismatch_func_t ismatch, void *parameter, void **data)
+{
+	unsigned long key = 0;
+	unsigned long max = 0;
+	veb_item_t *item = NULL;
+	veb_bucket_t *bucket = NULL;
+
+	assert(veb && "Veb isn't valid.");
+	assert(ismatch && "Match isn't valid.");
+	assert(data && "Data isn't valid.");
+
+	if(0 == veb->size)
+	{
+		return (1);
+	}
+
+	key = VebNodeMin(veb->root, veb->bits);
+	max = VebNodeMax(veb->root, veb->bits);
+	for(;;)
+	{
+		bucket = VebBucketFind(veb, key);
+		for(item = bucket->head; NULL != item; item = item->next)
+		{
+			if(ismatch(item->data, parameter))
+			{
+				*data = VebUnlink(veb, bucket, item);
+				return (0);
+			}
+		}
+
+		if(key == max)
+		{
+			return (1);
+		}
+
+		(void)VebNodeNext(veb->root, veb->bits, key + 1, &key);
+	}
+}
+
+/******************************************************************************
+ * @brief     Removes all data from the tree.
+ * @param veb Pointer to the tree.
+ * @note      Time Complexity: O(n)
+******************************************************************************/
+void VebClear(veb_t *veb)
+{
+	size_t i = 0;
+	veb_item_t *item = NULL;
+	veb_item_t *next = NULL;
+
+	assert(veb && "Veb isn't valid.");
+
+	for(i = 0; i < veb->capacity && 0 < veb->keys; ++i)
+	{
+		for(item = veb->buckets[i].head; NULL != item; item = next)
+		{
+			next = item->next;
+			free(item);
+		}
+
+		veb->keys -= (NULL != veb->buckets[i].head);
+		veb->buckets[i].head = NULL;
+	}
+
+	veb->size = 0;
+	VebNodeClear(veb, veb->root, veb->bits);
+}
+
+/******************************************************************************
+ * @brief     Returns the number of data elements in the tree.
+ * @param veb Pointer to the tree.
+ * @return    Number of data elements.
+ * @note      Time Complexity: O(1)
+******************************************************************************/
+size_t VebSize(const veb_t *veb)
+{
+	assert(veb && "Veb isn't valid.");
+	return (veb->size);
+}
+
+/******************************************************************************
+ * @brief        Returns the bytes the tree has requested from malloc.
+ * @param veb    Pointer to the tree.
+ * @param nodes  Receives the bytes of the items holding data.
+ * @param spare  Receives the bytes of the free hash table slots.
+ * @param blocks Receives the number of malloc blocks the bytes are spread on.
+ * @return       Number of bytes, the tree, its nodes and hash table included.
+ * @note         Time Complexity: O(1)
+******************************************************************************/
+size_t VebMemoryUsage(const veb_t *veb, size_t *nodes, size_t *spare, size_t *blocks)
+{
+	assert(veb && "Veb isn't valid.");
+	assert(nodes && spare && blocks && "Counters aren't valid.");
+
+	*nodes = veb->size * sizeof(veb_item_t);
+	*spare = (veb->capacity - veb->keys) * sizeof(veb_bucket_t);
+	*blocks = veb->size + veb->node_blocks + 2;
+	return (sizeof(veb_t) + veb->capacity * sizeof(veb_bucket_t) + veb->node_bytes + *nodes);
+}
+
+/******************************************************************************
+ * @brief     Allocates an empty node.
+ * @param veb Pointer to the tree, which accounts for the node.
+ * @return    Pointer to the node, or NULL if allocation fails.
+ * @note      Time Complexity: O(1)
+******************************************************************************/
+static veb_node_t *VebNodeCreate(veb_t *veb)
+{
+	veb_node_t *node = (veb_node_t *)malloc(sizeof(veb_node_t));
+	if(NULL == node)
+	{
+		return (NULL);
+	}
+
+	node->min = 1;
+	node->max = 0;
+	node->bits = 0;
+	node->count = 0;
+	node->capacity = 0;
+	node->keys = NULL;
+	node->summary = NULL;
+	node->clusters = NULL;
+	veb->node_bytes += sizeof(veb_node_t);
+	++veb->node_blocks;
+	return (node);
+}
+
+/******************************************************************************
+ * @brief      Empties a node, freeing its key array, summary, clusters and
+ *             cluster table. The node is left sparse.
+ * @param veb  Pointer to the tree, which accounts for the nodes.
+ * @param node Pointer to the node.
+ * @param bits Number of bits of the node.
+ * @note       Time Complexity: O(nodes below it log log U)
+******************************************************************************/
+static void VebNodeClear(veb_t *veb, veb_node_t *node, unsigned int bits)
+{
+	unsigned long high = 0;
+	unsigned long max = 0;
+	size_t count = (size_t)1 << VEB_HIGH_BITS(bits);
+
+	node->min = 1;
+	node->max = 0;
+	node->bits = 0;
+	node->count = 0;
+	if(bits <= VEB_LEAF_BITS)
+	{
+		return;
+	}
+
+	(void)VebNodeResize(veb, node, 0);
+
+	if(NULL != node->clusters)
+	{
+		if(!VebNodeIsEmpty(node->summary, VEB_HIGH_BITS(bits)))
+		{
+			high = VebNodeMin(node->summary, VEB_HIGH_BITS(bits));
+			max = VebNodeMax(node->summary, VEB_HIGH_BITS(bits));
+			for(;;)
+			{
+				VebNodeDestroy(veb, node->clusters[high], VEB_LOW_BITS(bits));
+				if(high == max)
+				{
+					break;
+				}
+
+				(void)VebNodeNext(node->summary, VEB_HIGH_BITS(bits), high + 1, &high);
+			}
+		}
+
+		free(node->clusters);
+		node->clusters = NULL;
+		veb->node_bytes -= count * sizeof(veb_node_t *);
+		--veb->node_blocks;
+	}
+
+	VebNodeDestroy(veb, node->summary, VEB_HIGH_BITS(bits));
+	node->summary = NULL;
+}
+
+/******************************************************************************
+ * @brief      Frees a node and everything below it.
+ * @param veb  Pointer to the tree, which accounts for the nodes.
+ * @param node Pointer to the node, may be NULL.
+ * @param bits Number of bits of the node.
+ * @note       Time Complexity: O(nodes below it log log U)
+******************************************************************************/
+static void VebNodeDestroy(veb_t *veb, veb_node_t *node, unsigned int bits)
+{
+	if(NULL == node)
+	{
+		return;
+	}
+
+	VebNodeClear(veb, node, bits);
+	free(node);
+	veb->node_bytes -= sizeof(veb_node_t);
+	--veb->node_blocks;
+}
+
+/******************************************************************************
+ * @brief      Checks if a node holds no key.
+ * @param node Pointer to the node, may be NULL.
+ * @param bits Number of bits of the node.
+ * @return     Non-zero value if empty, 0 if not empty.
+ * @note       Time Complexity: O(1)
+******************************************************************************/
+static int VebNodeIsEmpty(const veb_node_t *node, unsigned int bits)
+{
+	if(NULL == node)
+	{
+		return (1);
+	}
+
+	return (bits <= VEB_LEAF_BITS ? 0 == node->bits : node->min > node->max);
+}
+
+/******************************************************************************
+ * @brief      Returns the smallest key of a non empty node.
+ * @param node Pointer to the node.
+ * @param bits Number of bits of the node.
+ * @note       Time Complexity: O(1)
+******************************************************************************/
+static unsigned long VebNodeMin(const veb_node_t *node, unsigned int bits)
+{
+	return (bits <= VEB_LEAF_BITS ? VebLowestBit(node->bits) : node->min);
+}
+
+/******************************************************************************
+ * @brief      Returns the largest key of a non empty node.
+ * @param node Pointer to the node.
+ * @param bits Number of bits of the node.
+ * @note       Time Complexity: O(1)
+******************************************************************************/
+static unsigned long VebNodeMax(const veb_node_t *node, unsigned int bits)
+{
+	return (bits <= VEB_LEAF_BITS ? VebHighestBit(node->bits) : node->max);
+}
+
+/******************************************************************************
+ * @brief      Allocates the nodes, arrays and tables inserting a key will go
+ *             through, following the path VebNodeInsert takes without
+ *             changing a key. A full sparse node spreads on the way, which
+ *             changes how it holds its keys but not which keys it holds.
+ * @param veb  Pointer to the tree, which accounts for the nodes.
+ * @param node Pointer to the node.
+ * @param bits Number of bits of the node.
+ * @param key  Key about to be inserted, not in the node.
+ * @return     0 on success, or a non-zero value if an allocation failed. A
+ *             grown array or a spread node may stay, an empty cluster never
+ *             does.
+ * @note       Time Complexity: O(log log U)
+******************************************************************************/
+static int VebNodeReserve(veb_t *veb, veb_node_t *node, unsigned int bits, unsigned long key)
+{
+	int status = 0;
+	veb_node_t **cluster = NULL;
+
+	if(bits <= VEB_LEAF_BITS || VebNodeIsEmpty(node, bits))
+	{
+		return (0);
+	}
+
+	/* The array of a sparse node holds every key but the minimum */
+	if(NULL == node->clusters)
+	{
+		if(node->count < VEB_SPARSE_KEYS)
+		{
+			return (node->count <= node->capacity ? 0 :
+			        VebNodeResize(veb, node, 0 == node->capacity ? VEB_SPARSE_MIN_CAPACITY : 2 * node->capacity));
+		}
+
+		if(VebNodeSpread(veb, node, bits))
+		{
+			return (1);
+		}
+	}
+
+	/* A smaller key takes the place of the minimum, which moves down */
+	key = key < node->min ? node->min : key;
+	cluster = &node->clusters[VEB_HIGH(key, bits)];
+	if(NULL == *cluster)
+	{
+		*cluster = VebNodeCreate(veb);
+		if(NULL == *cluster)
+		{
+			return (1);
+		}
+
+		/* The summary does not hold the new cluster yet, so it must not stay */
+		status = VebNodeReserve(veb, node->summary, VEB_HIGH_BITS(bits), VEB_HIGH(key, bits));
+		if(0 != status)
+		{
+			VebNodeDestroy(veb, *cluster, VEB_LOW_BITS(bits));
+			*cluster = NULL;
+		}
+
+		return (status);
+	}
+
+	return (VebNodeReserve(veb, *cluster, VEB_LOW_BITS(bits), VEB_LOW(key, bits)));
+}
+
+/******************************************************************************
+ * @brief          Moves the keys above the minimum of a sparse node to a new
+ *                 array.
+ * @param veb      Pointer to the tree, which accounts for the arrays.
+ * @param node     Pointer to the node.
+ * @param capacity Number of keys of the new array, at least the number held,
+ *                 or 0 to free the array of a node holding at most one key.
+ * @return         0 on success, or a non-zero value if allocation fails, in
+ *                 which case the node keeps its array.
+ * @note           Time Complexity: O(VEB_SPARSE_KEYS)
+******************************************************************************/
+static int VebNodeResize(veb_t *veb, veb_node_t *node, size_t capacity)
+{
+	unsigned long *keys = NULL;
+
+	if(0 < capacity)
+	{
+		keys = (unsigned long *)malloc(capacity * sizeof(unsigned long));
+		if(NULL == keys)
+		{
+			return (1);
+		}
+
+		if(1 < node->count)
+		{
+			memcpy(keys, node->keys, (node->count - 1) * sizeof(unsigned long));
+		}
+
+		veb->node_bytes += capacity * sizeof(unsigned long);
+		++veb->node_blocks;
+	}
+
+	if(NULL != node->keys)
+	{
+		free(node->keys);
+		veb->node_bytes -= node->capacity * sizeof(unsigned long);
+		--veb->node_blocks;
+	}
+
+	node->keys = keys;
+	node->capacity = capacity;
+	return (0);
+}
+
+/******************************************************************************
+ * @brief       Gives an empty sparse node or leaf its keys.
+ * @param veb   Pointer to the tree, which accounts for the arrays.
+ * @param node  Pointer to the empty node.
+ * @param bits  Number of bits of the node.
+ * @param keys  Keys in ascending order, each below 2^bits.
+ * @param count Number of keys, 1 to VEB_SPARSE_KEYS - 1.
+ * @return      0 on success, or a non-zero value if allocation fails, in
+ *              which case the node stays empty.
+ * @note        Time Complexity: O(count)
+******************************************************************************/
+static int VebNodeFill(veb_t *veb, veb_node_t *node, unsigned int bits, const unsigned long *keys, size_t count)
+{
+	size_t i = 0;
+
+	if(bits <= VEB_LEAF_BITS)
+	{
+		for(i = 0; i < count; ++i)
+		{
+			node->bits |= 1UL << keys[i];
+		}
+
+		return (0);
+	}
+
+	if(1 < count && VebNodeResize(veb, node, count - 1))
+	{
+		return (1);
+	}
+
+	if(1 < count)
+	{
+		memcpy(node->keys, keys + 1, (count - 1) * sizeof(unsigned long));
+	}
+
+	node->min = keys[0];
+	node->max = keys[count - 1];
+	node->count = count;
+	return (0);
+}
+
+/******************************************************************************
+ * @brief      Turns a full sparse node into a dense one: the minimum stays and
+ *             the keys of its array move to sparse clusters, their high
+ *             halves to the summary.
+ * @param veb  Pointer to the tree, which accounts for the nodes.
+ * @param node Pointer to the sparse node holding VEB_SPARSE_KEYS keys.
+ * @param bits Number of bits of the node.
+ * @return     0 on success, or a non-zero value if an allocation failed, in
+ *             which case the node is unchanged.
+ * @note       Time Complexity: O(VEB_SPARSE_KEYS)
+******************************************************************************/
+static int VebNodeSpread(veb_t *veb, veb_node_t *node, unsigned int bits)
+{
+	int status = 0;
+	size_t i = 0;
+	size_t j = 0;
+	size_t highs = 0;
+	size_t count = (size_t)1 << VEB_HIGH_BITS(bits);
+	unsigned long high = 0;
+	unsigned long high_keys[VEB_SPARSE_KEYS];
+	unsigned long low_keys[VEB_SPARSE_KEYS];
+	veb_node_t *summary = NULL;
+	veb_node_t **clusters = (veb_node_t **)calloc(count, sizeof(veb_node_t *));
+	if(NULL == clusters)
+	{
+		return (1);
+	}
+
+	veb->node_bytes += count * sizeof(veb_node_t *);
+	++veb->node_blocks;
+	summary = VebNodeCreate(veb);
+	status = (NULL == summary);
+	for(i = 0; 0 == status && i + 1 < node->count; i = j)
+	{
+		high = VEB_HIGH(node->keys[i], bits);
+		for(j = i; j + 1 < node->count && high == VEB_HIGH(node->keys[j], bits); ++j)
+		{
+			low_keys[j - i] = VEB_LOW(node->keys[j], bits);
+		}
+
+		high_keys[highs++] = high;
+		clusters[high] = VebNodeCreate(veb);
+		status = (NULL == clusters[high] || VebNodeFill(veb, clusters[high], VEB_LOW_BITS(bits), low_keys, j - i));
+	}
+
+	status = (0 != status || VebNodeFill(veb, summary, VEB_HIGH_BITS(bits), high_keys, highs));
+	if(0 != status)
+	{
+		for(i = 0; i < highs; ++i)
+		{
+			VebNodeDestroy(veb, clusters[high_keys[i]], VEB_LOW_BITS(bits));
+		}
+
+		free(clusters);
+		veb->node_bytes -= count * sizeof(veb_node_t *);
+		--veb->node_blocks;
+		VebNodeDestroy(veb, summary, VEB_HIGH_BITS(bits));
+		return (1);
+	}
+
+	(void)VebNodeResize(veb, node, 0);
+	node->summary = summary;
+	node->clusters = clusters;
+	return (0);
+}
+
+/******************************************************************************
+ * @brief      Turns a dense node back into a sparse one, collecting its keys
+ *             in order. A node that can not allocate the array stays dense.
+ * @param veb  Pointer to the tree, which accounts for the nodes.
+ * @param node Pointer to the dense node, holding at most VEB_SPARSE_KEYS / 4
+ *             keys.
+ * @param bits Number of bits of the node.
+ * @note       Time Complexity: O(VEB_SPARSE_KEYS log log U)
+******************************************************************************/
+static void VebNodeGather(veb_t *veb, veb_node_t *node, unsigned int bits)
+{
+	size_t i = 0;
+	size_t count = node->count;
+	unsigned long min = node->min;
+	unsigned long max = node->max;
+	unsigned long *keys = NULL;
+
+	if(1 < count)
+	{
+		keys = (unsigned long *)malloc(VEB_SPARSE_KEYS / 4 * sizeof(unsigned long));
+		if(NULL == keys)
+		{
+			return;
+		}
+
+		for(i = 0; i + 1 < count; ++i)
+		{
+			(void)VebNodeNext(node, bits, (0 == i ? min : keys[i - 1]) + 1, &keys[i]);
+		}
+	}
+
+	VebNodeClear(veb, node, bits);
+	if(NULL != keys)
+	{
+		node->keys = keys;
+		node->capacity = VEB_SPARSE_KEYS / 4;
+		veb->node_bytes += node->capacity * sizeof(unsigned long);
+		++veb->node_blocks;
+	}
+
+	node->min = min;
+	node->max = max;
+	node->count = count;
+}
+
+/******************************************************************************
+ * @brief      Returns the number of keys in the array of a sparse node that
+ *             are below a key, the position the key has or would take.
+ * @param node Pointer to the sparse node, holding at least one key.
+ * @param key  Key to look up.
+ * @note       Time Complexity: O(log VEB_SPARSE_KEYS)
+******************************************************************************/
+static size_t VebNodeRank(const veb_node_t *node, unsigned long key)
+{
+	size_t low = 0;
+	size_t high = node->count - 1;
+	size_t middle = 0;
+
+	while(low < high)
+	{
+		middle = low + (high - low) / 2;
+		if(node->keys[middle] < key)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	return (low);
+}
+
+/******************************************************************************
+ * @brief      Inserts a key the node does not hold. VebNodeReserve has to have
+ *             succeeded for it first.
+ * @param node Pointer to the node.
+ * @param bits Number of bits of the node.
+ * @param key  Key to insert.
+ * @note       Time Complexity: O(log log U)
+******************************************************************************/
+static void VebNodeInsert(veb_node_t *node, unsigned int bits, unsigned long key)
+{
+	size_t rank = 0;
+	unsigned long min = 0;
+	veb_node_t *cluster = NULL;
+
+	if(bits <= VEB_LEAF_BITS)
+	{
+		node->bits |= 1UL << key;
+		return;
+	}
+
+	if(node->min > node->max)
+	{
+		node->min = key;
+		node->max = key;
+		node->count = 1;
+		return;
+	}
+
+	if(key < node->min)
+	{
+		min = node->min;
+		node->min = key;
+		key = min;
+	}
+
+	node->max = key > node->max ? key : node->max;
+	if(NULL == node->clusters)
+	{
+		rank = VebNodeRank(node, key);
+		memmove(node->keys + rank + 1, node->keys + rank, (node->count - 1 - rank) * sizeof(unsigned long));
+		node->keys[rank] = key;
+		++node->count;
+		return;
+	}
+
+	/* Only one of the two calls recurses, the other fills an empty node */
+	++node->count;
+	cluster = node->clusters[VEB_HIGH(key, bits)];
+	if(VebNodeIsEmpty(cluster, VEB_LOW_BITS(bits)))
+	{
+		VebNodeInsert(node->summary, VEB_HIGH_BITS(bits), VEB_HIGH(key, bits));
+	}
+
+	VebNodeInsert(cluster, VEB_LOW_BITS(bits), VEB_LOW(key, bits));
+}
+
+/******************************************************************************
+ * @brief      Removes a key the node holds, freeing a cluster it empties. A
+ *             sparse array left a quarter full shrinks and a dense node left
+ *             with a quarter of VEB_SPARSE_KEYS gathers, where memory allows.
+ * @param veb  Pointer to the tree, which accounts for the nodes.
+ * @param node Pointer to the node.
+ * @param bits Number of bits of the node.
+ * @param key  Key to remove.
+ * @note       Time Complexity: O(log log U)
+******************************************************************************/
+static void VebNodeDelete(veb_t *veb, veb_node_t *node, unsigned int bits, unsigned long key)
+{
+	size_t rank = 0;
+	unsigned long high = 0;
+	veb_node_t **cluster = NULL;
+
+	if(bits <= VEB_LEAF_BITS)
+	{
+		node->bits &= ~(1UL << key);
+		return;
+	}
+
+	if(node->min == node->max)
+	{
+		VebNodeClear(veb, node, bits);
+		return;
+	}
+
+	if(NULL == node->clusters)
+	{
+		/* The first key of the array becomes the minimum and leaves it */
+		key = key == node->min ? (node->min = node->keys[0]) : key;
+		rank = VebNodeRank(node, key);
+		memmove(node->keys + rank, node->keys + rank + 1, (node->count - 2 - rank) * sizeof(unsigned long));
+		--node->count;
+		node->max = 1 < node->count ? node->keys[node->count - 2] : node->min;
+		if(VEB_SPARSE_MIN_CAPACITY < node->capacity && 4 * (node->count - 1) <= node->capacity)
+		{
+			(void)VebNodeResize(veb, node, node->capacity / 2);
+		}
+
+		return;
+	}
+
+	/* The smallest key of the clusters becomes the minimum and leaves them */
+	--node->count;
+	if(key == node->min)
+	{
+		high = VebNodeMin(node->summary, VEB_HIGH_BITS(bits));
+		key = VEB_INDEX(high, VebNodeMin(node->clusters[high], VEB_LOW_BITS(bits)), bits);
+		node->min = key;
+	}
+
+	high = VEB_HIGH(key, bits);
+	cluster = &node->clusters[high];
+	VebNodeDelete(veb, *cluster, VEB_LOW_BITS(bits), VEB_LOW(key, bits));
+	if(VebNodeIsEmpty(*cluster, VEB_LOW_BITS(bits)))
+	{
+		VebNodeDestroy(veb, *cluster, VEB_LOW_BITS(bits));
+		*cluster = NULL;
+		VebNodeDelete(veb, node->summary, VEB_HIGH_BITS(bits), high);
+		if(key == node->max)
+		{
+			if(VebNodeIsEmpty(node->summary, VEB_HIGH_BITS(bits)))
+			{
+				node->max = node->min;
+			}
+			else
+			{
+				high = VebNodeMax(node->summary, VEB_HIGH_BITS(bits));
+				node->max = VEB_INDEX(high, VebNodeMax(node->clusters[high], VEB_LOW_BITS(bits)), bits);
+			}
+		}
+	}
+	else if(key == node->max)
+	{
+		node->max = VEB_INDEX(high, VebNodeMax(*cluster, VEB_LOW_BITS(bits)), bits);
+	}
+
+	if(node->count <= VEB_SPARSE_KEYS / 4)
+	{
+		VebNodeGather(veb, node, bits);
+	}
+}
+
+/******************************************************************************
+ * @brief       Finds the smallest key of a node not below a value.
+ * @param node  Pointer to the node.
+ * @param bits  Number of bits of the node.
+ * @param value Value to start from.
+ * @param key   Receives the key when found.
+ * @return      0 if found, or a non-zero value if every key is below value.
+ * @note        Time Complexity: O(log log U)
+******************************************************************************/
+static int VebNodeNext(const veb_node_t *node, unsigned int bits, unsigned long value, unsigned long *key)
+{
+	unsigned long high = 0;
+	unsigned long low = 0;
+	unsigned long word = 0;
+	const veb_node_t *cluster = NULL;
+
+	if(bits <= VEB_LEAF_BITS)
+	{
+		word = node->bits & (~0UL << value);
+		*key = 0 == word ? 0 : VebLowestBit(word);
+		return (0 == word);
+	}
+
+	if(VebNodeIsEmpty(node, bits) || value > node->max)
+	{
+		return (1);
+	}
+
+	if(value <= node->min)
+	{
+		*key = node->min;
+		return (0);
+	}
+
+	/* min < value <= max, so a sparse node has the answer in its array */
+	if(NULL == node->clusters)
+	{
+		*key = node->keys[VebNodeRank(node, value)];
+		return (0);
+	}
+
+	/* The answer is in this cluster or a later one */
+	high = VEB_HIGH(value, bits);
+	low = VEB_LOW(value, bits);
+	cluster = node->clusters[high];
+	if(!VebNodeIsEmpty(cluster, VEB_LOW_BITS(bits)) && low <= VebNodeMax(cluster, VEB_LOW_BITS(bits)))
+	{
+		(void)VebNodeNext(cluster, VEB_LOW_BITS(bits), low, &low);
+		*key = VEB_INDEX(high, low, bits);
+		return (0);
+	}
+
+	(void)VebNodeNext(node->summary, VEB_HIGH_BITS(bits), high + 1, &high);
+	*key = VEB_INDEX(high, VebNodeMin(node->clusters[high], VEB_LOW_BITS(bits)), bits);
+	return (0);
+}
+
+/******************************************************************************
+ * @brief       Finds the largest key of a node not above a value.
+ * @param node  Pointer to the node.
+ * @param bits  Number of bits of the node.
+ * @param value Value to start from.
+ * @param key   Receives the key when found.
+ * @return      0 if found, or a non-zero value if every key is above value.
+ * @note        Time Complexity: O(log log U)
+******************************************************************************/
+static int VebNodePrev(const veb_node_t *node, unsigned int bits, unsigned long value, unsigned long *key)
+{
+	size_t rank = 0;
+	unsigned long high = 0;
+	unsigned long low = 0;
+	unsigned long word = 0;
+	const veb_node_t *cluster = NULL;
+
+	if(bits <= VEB_LEAF_BITS)
+	{
+		word = node->bits & (~0UL >> (sizeof(unsigned long) * CHAR_BIT - 1 - value));
+		*key = 0 == word ? 0 : VebHighestBit(word);
+		return (0 == word);
+	}
+
+	if(VebNodeIsEmpty(node, bits) || value < node->min)
+	{
+		return (1);
+	}
+
+	if(value >= node->max)
+	{
+		*key = node->max;
+		return (0);
+	}
+
+	/* min <= value < max, the minimum answers when no key above it does */
+	if(NULL == node->clusters)
+	{
+		rank = VebNodeRank(node, value + 1);
+		*key = 0 == rank ? node->min : node->keys[rank - 1];
+		return (0);
+	}
+
+	high = VEB_HIGH(value, bits);
+	low = VEB_LOW(value, bits);
+	cluster = node->clusters[high];
+	if(!VebNodeIsEmpty(cluster, VEB_LOW_BITS(bits)) && low >= VebNodeMin(cluster, VEB_LOW_BITS(bits)))
+	{
+		(void)VebNodePrev(cluster, VEB_LOW_BITS(bits), low, &low);
+		*key = VEB_INDEX(high, low, bits);
+		return (0);
+	}
+
+	if(0 < high && 0 == VebNodePrev(node->summary, VEB_HIGH_BITS(bits), high - 1, &high))
+	{
+		*key = VEB_INDEX(high, VebNodeMax(node->clusters[high], VEB_LOW_BITS(bits)), bits);
+		return (0);
+	}
+
+	*key = node->min;
+	return (0);
+}
+
+/******************************************************************************
+ * @brief      Returns the index of the lowest set bit of a non zero word.
+ * @param word Word to scan.
+ * @note       Time Complexity: O(1) with GCC builtins, O(bits) otherwise.
+******************************************************************************/
+static unsigned long VebLowestBit(unsigned long word)
+{
+	#if defined(__GNUC__)
+	return ((unsigned long)__builtin_ctzl(word));
+	#else
+	unsigned long bit = 0;
+	for(; 0 == (word & 1UL); word >>= 1, ++bit);
+
+	return (bit);
+	#endif
+}
+
+/******************************************************************************
+ * @brief      Returns the index of the highest set bit of a non zero word.
+ * @param word Word to scan.
+ * @note       Time Complexity: O(1) with GCC builtins, O(bits) otherwise.
+******************************************************************************/
+static unsigned long VebHighestBit(unsigned long word)
+{
+	#if defined(__GNUC__)
+	return ((unsigned long)(sizeof(unsigned long) * CHAR_BIT - 1 - __builtin_clzl(word)));
+	#else
+	unsigned long bit = 0;
+	while(word >>= 1)
+	{
+		++bit;
+	}
+
+	return (bit);
+	#endif
+}
+
+/******************************************************************************
+ * @brief     Finds the slot of a key, or the free slot it would take.
+ * @param veb Pointer to the tree.
+ * @param key Key to look up.
+ * @note      Time Complexity: O(1) expected, the table is at most half full.
+******************************************************************************/
+static veb_bucket_t *VebBucketFind(const veb_t *veb, unsigned long key)
+{
+	size_t mask = veb->capacity - 1;
+	size_t index = (size_t)((key * VEB_HASH_MULTIPLIER) & 0xFFFFFFFFUL) >> veb->shift;
+
+	while(NULL != veb->buckets[index].head && key != veb->buckets[index].key)
+	{
+		index = (index + 1) & mask;
+	}
+
+	return (&veb->buckets[index]);
+}
+
+/******************************************************************************
+ * @brief     Doubles the hash table and moves every bucket into it.
+ * @param veb Pointer to the tree.
+ * @return    0 on success, or a non-zero value if allocation fails, in which
+ *            case the table is unchanged.
+ * @note      Time Complexity: O(capacity)
+******************************************************************************/
+static int VebBucketGrow(veb_t *veb)
+{
+	size_t i = 0;
+	size_t capacity = veb->capacity;
+	veb_bucket_t *old = veb->buckets;
+	veb_bucket_t *buckets = (veb_bucket_t *)malloc(2 * capacity * sizeof(veb_bucket_t));
+	if(NULL == buckets)
+	{
+		return (1);
+	}
+
+	for(i = 0; i < 2 * capacity; ++i)
+	{
+		buckets[i].head = NULL;
+	}
+
+	veb->buckets = buckets;
+	veb->capacity = 2 * capacity;
+	--veb->shift;
+	for(i = 0; i < capacity; ++i)
+	{
+		if(NULL != old[i].head)
+		{
+			*VebBucketFind(veb, old[i].key) = old[i];
+		}
+	}
+
+	free(old);
+	return (0);
+}
+
+/******************************************************************************
+ * @brief        Frees the slot of an emptied bucket, shifting back the buckets
+ *               probed past it so no search stops early.
+ * @param veb    Pointer to the tree.
+ * @param bucket Slot to free.
+ * @note         Time Complexity: O(1) expected.
+******************************************************************************/
+static void VebBucketErase(veb_t *veb, veb_bucket_t *bucket)
+{
+	size_t mask = veb->capacity - 1;
+	size_t hole = (size_t)(bucket - veb->buckets);
+	size_t index = hole;
+	size_t home = 0;
+
+	for(index = (index + 1) & mask; NULL != veb->buckets[index].head; index = (index + 1) & mask)
+	{
+		/* A bucket can fill the hole unless its home lies after the hole */
+		home = (size_t)((veb->buckets[index].key * VEB_HASH_MULTIPLIER) & 0xFFFFFFFFUL) >> veb->shift;
+		if(((index - home) & mask) >= ((index - hole) & mask))
+		{
+			veb->buckets[hole] = veb->buckets[index];
+			hole = index;
+		}
+	}
+
+	veb->buckets[hole].head = NULL;
+	--veb->keys;
+}
+
+/******************************************************************************
+ * @brief        Unlinks an item from its bucket and frees it. The key leaves
+ *               the tree with its last item.
+ * @param veb    Pointer to the tree.
+ * @param bucket Bucket of the item.
+ * @param item   Item to remove.
+ * @return       Pointer to the data of the item.
+ * @note         Time Complexity: O(1), O(log log U) when the key leaves.
+******************************************************************************/
+static void *VebUnlink(veb_t *veb, veb_bucket_t *bucket, veb_item_t *item)
+{
+	void *data = item->data;
+	unsigned long key = bucket->key;
+
+	if(NULL == item->prev)
+	{
+		bucket->head = item->next;
+	}
+	else
+	{
+		item->prev->next = item->next;
+	}
+
+	if(NULL == item->next)
+	{
+		bucket->tail = item->prev;
+	}
+	else
+	{
+		item->next->prev = item->prev;
+	}
+
+	free(item);
+	--veb->size;
+	if(NULL == bucket->head)
+	{
+		VebBucketErase(veb, bucket);
+		VebNodeDelete(veb, veb->root, veb->bits, key);
+	}
+
+	return (data);
+}
+/*****************************************************************************/
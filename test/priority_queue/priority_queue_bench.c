@@ -0,0 +1,788 @@
+/******************************************************************************
+ * @writer:      Tal Aharon
+ * @date:        19.10.2026
+ *
+ * @description: This file contains the benchmark suite for the Priority Queue
+ *               implementation. Every workload fills a queue with pseudo random
+ *               keys and drains it again, timing the enqueue and dequeue
+ *               phases separately. Results are reported in ns/op, written as
+ *               JSON and optionally compared against a baseline file.
+ *
+ *               On Linux every phase also counts cycles, instructions, cache
+ *               misses, branch misses and dTLB load misses of user space with
+ *               perf_event_open, reported per operation next to the IPC.
+ *               Counters the kernel or the CPU does not provide are reported
+ *               as n/a (null in JSON); only ns/op is compared to the baseline.
+ *
+ *               With --memory the timings are skipped; every engine is filled
+ *               with a million elements instead and its footprint is reported
+ *               in bytes per element, split into the PriorityQueueMemoryUsage
+ *               categories.
+ *
+ *               usage: priority_queue_bench [--output FILE] [--baseline FILE]
+ *                                           [--threshold PERCENT] | --memory
+ *
+******************************************************************************/
+#define _POSIX_C_SOURCE 199309L
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>   /* printf, fprintf, fopen  */
+#include <stdlib.h>  /* malloc, free, atof      */
+#include <string.h>  /* strcmp, strcpy          */
+#include <time.h>    /* clock_gettime           */
+
+#ifdef __linux__
+#include <linux/perf_event.h> /* perf_event_attr      */
+#include <sys/ioctl.h>        /* ioctl                */
+#include <sys/syscall.h>      /* SYS_perf_event_open  */
+#include <unistd.h>           /* syscall, read, close */
+#endif
+
+#include "priority_queue.h"
+#include "ref_queue.h"
+#include "shm_priority_queue.h"
+#include "priority_queue_typed.h"
+/*****************************************************************************/
+#define BENCH_WARMUPS (2)
+#define BENCH_REPETITIONS (5)
+#define BENCH_MAX_RESULTS (64)
+#define BENCH_NAME_LENGTH (64)
+#define BENCH_DEFAULT_THRESHOLD (20.0)
+#define BENCH_SHM_NAME "/priority_queue_bench"
+#define BENCH_COUNTERS (5)
+#define BENCH_MEMORY_COUNT (1048576)
+
+/* Time and hardware counters of one phase, counters are negative when unavailable */
+typedef struct bench_phase
+{
+	double ns;
+	double counters[BENCH_COUNTERS];
+
+} bench_phase_t;
+
+typedef void (*bench_func_t) (size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue);
+
+typedef struct bench_workload
+{
+	const char *name;
+	bench_func_t run;
+	size_t count;
+
+} bench_workload_t;
+
+typedef struct bench_result
+{
+	char name[BENCH_NAME_LENGTH];
+	double ns_per_op;
+	double counters_per_op[BENCH_COUNTERS];
+
+} bench_result_t;
+
+static void BenchSortedList(size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue);
+static void BenchBinaryHeap(size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue);
+static void BenchDaryHeap(size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue);
+static void BenchDaryHeapBatch(size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue);
+static void BenchVeb(size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue);
+static void BenchBuckets(size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue);
+static void BenchBinaryHeapBulk(size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue);
+static void BenchVebBulk(size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue);
+static void BenchBucketsBulk(size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue);
+static void BenchBulk(priority_queue_t *queue, size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue);
+static void BenchRefQueue(size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue);
+static void BenchTypedQueue(size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue);
+static void BenchShmQueue(size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue);
+static void BenchQueue(priority_queue_engine_t engine, priority_queue_compare_batch_func_t batch, size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue);
+static void BenchCountersOpen(void);
+static void BenchCountersClose(void);
+static void BenchPhaseStart(bench_phase_t *phase);
+static void BenchPhaseStop(bench_phase_t *phase);
+static void BenchResult(bench_result_t *result, const char *name, const char *phase, const bench_phase_t *best, size_t count);
+static void BenchPrint(const bench_result_t *result);
+static int BenchCmp(void *data, void *new_data);
+static unsigned long BenchKey(void *data);
+static unsigned long BenchLevel(void *data);
+static unsigned long BenchCmpBatch(void *data, void **new_data, size_t count);
+static size_t BenchRandom(void);
+static double BenchNow(void);
+static size_t BenchRun(bench_result_t *results);
+static int BenchWrite(const char *path, const bench_result_t *results, size_t count);
+static size_t BenchRead(const char *path, bench_result_t *results);
+static int BenchCompare(const bench_result_t *current, size_t count, const bench_result_t *baseline, size_t baseline_count, double threshold);
+static void BenchMemory(void);
+
+static const bench_workload_t workloads[] =
+{
+	{"sorted_list_4k", BenchSortedList, 4096},
+	{"binary_heap_1m", BenchBinaryHeap, 1048576},
+	{"dary_heap_1m", BenchDaryHeap, 1048576},
+	{"dary_heap_batch_1m", BenchDaryHeapBatch, 1048576},
+	{"veb_1m", BenchVeb, 1048576},
+	{"buckets_1m", BenchBuckets, 1048576},
+	{"binary_heap_bulk_1m", BenchBinaryHeapBulk, 1048576},
+	{"veb_bulk_1m", BenchVebBulk, 1048576},
+	{"buckets_bulk_1m", BenchBucketsBulk, 1048576},
+	{"ref_queue_1m", BenchRefQueue, 1048576},
+	{"typed_heap_1m", BenchTypedQueue, 1048576},
+	{"shm_queue_1m", BenchShmQueue, 1048576}
+};
+
+static const char *const counter_names[BENCH_COUNTERS] =
+{
+	"cycles", "instructions", "cache_misses", "branch_misses", "dtlb_misses"
+};
+
+static int counter_fds[BENCH_COUNTERS] = {-1, -1, -1, -1, -1};
+
+static size_t bench_seed = 2463534242UL;
+
+/* The binary heap workload on keys compared inline instead of by BenchCmp */
+#define BENCH_HIGHER(a, b) ((a) > (b))
+PRIORITY_QUEUE_TYPED_DECLARE(BenchTyped, size_t)
+PRIORITY_QUEUE_TYPED_DEFINE(BenchTyped, size_t, BENCH_HIGHER)
+/*****************************************************************************/
+int main(int argc, char *argv[])
+{
+	int i = 1;
+	size_t count = 0;
+	size_t baseline_count = 0;
+	double threshold = BENCH_DEFAULT_THRESHOLD;
+	const char *output = NULL;
+	const char *baseline = NULL;
+	bench_result_t results[BENCH_MAX_RESULTS];
+	bench_result_t baseline_results[BENCH_MAX_RESULTS];
+
+	for(; i < argc; ++i)
+	{
+		if(0 == strcmp(argv[i], "--output") && i + 1 < argc)
+		{
+			output = argv[++i];
+		}
+		else if(0 == strcmp(argv[i], "--baseline") && i + 1 < argc)
+		{
+			baseline = argv[++i];
+		}
+		else if(0 == strcmp(argv[i], "--threshold") && i + 1 < argc)
+		{
+			threshold = atof(argv[++i]);
+		}
+		else if(0 == strcmp(argv[i], "--memory"))
+		{
+			BenchMemory();
+			return (0);
+		}
+		else
+		{
+			fprintf(stderr, "usage: %s [--output FILE] [--baseline FILE] [--threshold PERCENT] | --memory\n", argv[0]);
+			return (2);
+		}
+	}
+
+	BenchCountersOpen();
+	count = BenchRun(results);
+	BenchCountersClose();
+	if(NULL != output && BenchWrite(output, results, count))
+	{
+		fprintf(stderr, "Can not write %s\n", output);
+		return (2);
+	}
+
+	if(NULL == baseline)
+	{
+		return (0);
+	}
+
+	baseline_count = BenchRead(baseline, baseline_results);
+	if(0 == baseline_count)
+	{
+		fprintf(stderr, "Can not read baseline %s\n", baseline);
+		return (2);
+	}
+
+	return (BenchCompare(results, count, baseline_results, baseline_count, threshold));
+}
+/*****************************************************************************/
+static size_t BenchRun(bench_result_t *results)
+{
+	size_t i = 0;
+	size_t count = 0;
+	int repetition = 0;
+	bench_phase_t enqueue;
+	bench_phase_t dequeue;
+	bench_phase_t best_enqueue;
+	bench_phase_t best_dequeue;
+
+	for(i = 0; i < sizeof(workloads) / sizeof(workloads[0]); ++i)
+	{
+		for(repetition = 0; repetition < BENCH_WARMUPS; ++repetition)
+		{
+			workloads[i].run(workloads[i].count, &enqueue, &dequeue);
+		}
+
+		/* The fastest repetition is the least disturbed one */
+		best_enqueue.ns = best_dequeue.ns = -1;
+		for(repetition = 0; repetition < BENCH_REPETITIONS; ++repetition)
+		{
+			workloads[i].run(workloads[i].count, &enqueue, &dequeue);
+			if(0 > best_enqueue.ns || enqueue.ns < best_enqueue.ns)
+			{
+				best_enqueue = enqueue;
+			}
+
+			if(0 > best_dequeue.ns || dequeue.ns < best_dequeue.ns)
+			{
+				best_dequeue = dequeue;
+			}
+		}
+
+		BenchResult(&results[count], workloads[i].name, "enqueue", &best_enqueue, workloads[i].count);
+		BenchPrint(&results[count++]);
+		BenchResult(&results[count], workloads[i].name, "dequeue", &best_dequeue, workloads[i].count);
+		BenchPrint(&results[count++]);
+	}
+
+	return (count);
+}
+/*****************************************************************************/
+static void BenchResult(bench_result_t *result, const char *name, const char *phase, const bench_phase_t *best, size_t count)
+{
+	int i = 0;
+
+	sprintf(result->name, "%s_%s", name, phase);
+	result->ns_per_op = best->ns / (double)count;
+	for(i = 0; i < BENCH_COUNTERS; ++i)
+	{
+		result->counters_per_op[i] = 0 > best->counters[i] ? -1 : best->counters[i] / (double)count;
+	}
+}
+/*****************************************************************************/
+static void BenchPrint(const bench_result_t *result)
+{
+	int i = 0;
+	int available = 0;
+	const double *counters = result->counters_per_op;
+
+	for(i = 0; i < BENCH_COUNTERS; ++i)
+	{
+		available |= 0 <= counters[i];
+	}
+
+	printf("%-32s %10.2f ns/op", result->name, result->ns_per_op);
+	for(i = 0; i < BENCH_COUNTERS && available; ++i)
+	{
+		if(0 > counters[i])
+		{
+			printf("  %s n/a", counter_names[i]);
+		}
+		else
+		{
+			printf("  %s %.2f", counter_names[i], counters[i]);
+		}
+	}
+
+	if(0 < counters[0] && 0 <= counters[1])
+	{
+		printf("  ipc %.2f", counters[1] / counters[0]);
+	}
+
+	printf("\n");
+}
+/*****************************************************************************/
+static void BenchMemory(void)
+{
+	size_t i = 0;
+	size_t e = 0;
+	double total = 0;
+	priority_queue_t *queue = NULL;
+	priority_queue_memory_t usage;
+	const char *const names[] = {"sorted_list", "binary_heap", "dary_heap", "veb", "buckets"};
+	const priority_queue_engine_t engines[] = {PRIORITY_QUEUE_SORTED_LIST, PRIORITY_QUEUE_BINARY_HEAP, PRIORITY_QUEUE_DARY_HEAP, PRIORITY_QUEUE_VEB, PRIORITY_QUEUE_BUCKETS};
+
+	for(e = 0; e < sizeof(engines) / sizeof(engines[0]); ++e)
+	{
+		switch(engines[e])
+		{
+			case PRIORITY_QUEUE_VEB:
+				queue = PriorityQueueCreateKeyed(BenchKey, 32);
+				break;
+
+			case PRIORITY_QUEUE_BUCKETS:
+				queue = PriorityQueueCreateBuckets(BenchLevel, PRIORITY_QUEUE_MAX_LEVELS);
+				break;
+
+			default:
+				queue = PriorityQueueCreateEngine(BenchCmp, engines[e]);
+				break;
+		}
+
+		if(NULL == queue)
+		{
+			fprintf(stderr, "Can not create %s\n", names[e]);
+			return;
+		}
+
+		/* Ascending keys go to the front of the list, the footprint is the same,
+		   the keyed engines hold the random keys of their own benchmarks */
+		for(i = 1; i <= BENCH_MEMORY_COUNT; ++i)
+		{
+			PriorityQueueEnqueue(queue, (void *)(PRIORITY_QUEUE_VEB == engines[e] || PRIORITY_QUEUE_BUCKETS == engines[e] ? BenchRandom() | 1 : i));
+		}
+
+		PriorityQueueMemoryUsage(queue, &usage);
+		total = (double)(usage.nodes + usage.index + usage.spare + usage.overhead);
+		printf("%-32s %10.2f B/elem  nodes %.2f  index %.2f  spare %.2f  overhead %.2f\n",
+		       names[e], total / BENCH_MEMORY_COUNT,
+		       (double)usage.nodes / BENCH_MEMORY_COUNT, (double)usage.index / BENCH_MEMORY_COUNT,
+		       (double)usage.spare / BENCH_MEMORY_COUNT, (double)usage.overhead / BENCH_MEMORY_COUNT);
+		PriorityQueueDestroy(queue);
+	}
+}
+/*****************************************************************************/
+static void BenchSortedList(size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue)
+{
+	BenchQueue(PRIORITY_QUEUE_SORTED_LIST, NULL, count, enqueue, dequeue);
+}
+/*****************************************************************************/
+static void BenchBinaryHeap(size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue)
+{
+	BenchQueue(PRIORITY_QUEUE_BINARY_HEAP, NULL, count, enqueue, dequeue);
+}
+/*****************************************************************************/
+static void BenchDaryHeap(size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue)
+{
+	BenchQueue(PRIORITY_QUEUE_DARY_HEAP, NULL, count, enqueue, dequeue);
+}
+/*****************************************************************************/
+static void BenchDaryHeapBatch(size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue)
+{
+	BenchQueue(PRIORITY_QUEUE_DARY_HEAP, BenchCmpBatch, count, enqueue, dequeue);
+}
+/*****************************************************************************/
+static void BenchVeb(size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue)
+{
+	size_t i = 0;
+	priority_queue_t *queue = PriorityQueueCreateKeyed(BenchKey, 32);
+
+	BenchPhaseStart(enqueue);
+	for(i = 0; i < count; ++i)
+	{
+		PriorityQueueEnqueue(queue, (void *)(BenchRandom() | 1));
+	}
+
+	BenchPhaseStop(enqueue);
+	BenchPhaseStart(dequeue);
+	for(i = 0; i < count; ++i)
+	{
+		PriorityQueueDequeue(queue);
+	}
+
+	BenchPhaseStop(dequeue);
+	PriorityQueueDestroy(queue);
+}
+/*****************************************************************************/
+static void BenchBuckets(size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue)
+{
+	size_t i = 0;
+	priority_queue_t *queue = PriorityQueueCreateBuckets(BenchLevel, PRIORITY_QUEUE_MAX_LEVELS);
+
+	BenchPhaseStart(enqueue);
+	for(i = 0; i < count; ++i)
+	{
+		PriorityQueueEnqueue(queue, (void *)(BenchRandom() | 1));
+	}
+
+	BenchPhaseStop(enqueue);
+	BenchPhaseStart(dequeue);
+	for(i = 0; i < count; ++i)
+	{
+		PriorityQueueDequeue(queue);
+	}
+
+	BenchPhaseStop(dequeue);
+	PriorityQueueDestroy(queue);
+}
+/*****************************************************************************/
+static void BenchBinaryHeapBulk(size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue)
+{
+	BenchBulk(PriorityQueueCreateEngine(BenchCmp, PRIORITY_QUEUE_BINARY_HEAP), count, enqueue, dequeue);
+}
+/*****************************************************************************/
+static void BenchVebBulk(size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue)
+{
+	BenchBulk(PriorityQueueCreateKeyed(BenchKey, 32), count, enqueue, dequeue);
+}
+/*****************************************************************************/
+static void BenchBucketsBulk(size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue)
+{
+	BenchBulk(PriorityQueueCreateBuckets(BenchLevel, PRIORITY_QUEUE_MAX_LEVELS), count, enqueue, dequeue);
+}
+/*****************************************************************************/
+static void BenchBulk(priority_queue_t *queue, size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue)
+{
+	size_t i = 0;
+	void **data = (void **)malloc(count * sizeof(void *));
+
+	if(NULL == queue || NULL == data)
+	{
+		memset(enqueue, 0, sizeof(bench_phase_t));
+		memset(dequeue, 0, sizeof(bench_phase_t));
+		free(data);
+		if(NULL != queue)
+		{
+			PriorityQueueDestroy(queue);
+		}
+
+		return;
+	}
+
+	for(i = 0; i < count; ++i)
+	{
+		data[i] = (void *)(BenchRandom() | 1);
+	}
+
+	BenchPhaseStart(enqueue);
+	PriorityQueueEnqueueBatch(queue, data, count, NULL);
+	BenchPhaseStop(enqueue);
+	BenchPhaseStart(dequeue);
+	PriorityQueueDequeueBatch(queue, data, count);
+	BenchPhaseStop(dequeue);
+	free(data);
+	PriorityQueueDestroy(queue);
+}
+/*****************************************************************************/
+static void BenchQueue(priority_queue_engine_t engine, priority_queue_compare_batch_func_t batch, size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue)
+{
+	size_t i = 0;
+	priority_queue_t *queue = PriorityQueueCreateEngine(BenchCmp, engine);
+
+	if(NULL != batch)
+	{
+		PriorityQueueSetCompareBatch(queue, batch);
+	}
+
+	BenchPhaseStart(enqueue);
+	for(i = 0; i < count; ++i)
+	{
+		PriorityQueueEnqueue(queue, (void *)(BenchRandom() | 1));
+	}
+
+	BenchPhaseStop(enqueue);
+	BenchPhaseStart(dequeue);
+	for(i = 0; i < count; ++i)
+	{
+		PriorityQueueDequeue(queue);
+	}
+
+	BenchPhaseStop(dequeue);
+	PriorityQueueDestroy(queue);
+}
+/*****************************************************************************/
+static void BenchRefQueue(size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue)
+{
+	size_t i = 0;
+	ref_queue_ref_t ref = {0, 0};
+	ref_queue_t *queue = RefQueueCreate();
+
+	BenchPhaseStart(enqueue);
+	for(i = 0; i < count; ++i)
+	{
+		RefQueueEnqueue(queue, (ref_queue_key_t)BenchRandom(), (ref_queue_offset_t)i);
+	}
+
+	BenchPhaseStop(enqueue);
+	BenchPhaseStart(dequeue);
+	for(i = 0; i < count; ++i)
+	{
+		RefQueueDequeue(queue, &ref);
+	}
+
+	BenchPhaseStop(dequeue);
+	RefQueueDestroy(queue);
+}
+/*****************************************************************************/
+static void BenchTypedQueue(size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue)
+{
+	size_t i = 0;
+	size_t key = 0;
+	BenchTyped_t *queue = BenchTypedCreate();
+
+	BenchPhaseStart(enqueue);
+	for(i = 0; i < count; ++i)
+	{
+		BenchTypedEnqueue(queue, BenchRandom() | 1);
+	}
+
+	BenchPhaseStop(enqueue);
+	BenchPhaseStart(dequeue);
+	for(i = 0; i < count; ++i)
+	{
+		BenchTypedDequeue(queue, &key);
+	}
+
+	BenchPhaseStop(dequeue);
+	BenchTypedDestroy(queue);
+}
+/*****************************************************************************/
+static void BenchShmQueue(size_t count, bench_phase_t *enqueue, bench_phase_t *dequeue)
+{
+	size_t i = 0;
+	shm_priority_queue_entry_t entry = {0, 0};
+	shm_priority_queue_t *queue = NULL;
+
+	ShmPriorityQueueUnlink(BENCH_SHM_NAME);
+	queue = ShmPriorityQueueCreate(BENCH_SHM_NAME, count);
+	if(NULL == queue)
+	{
+		memset(enqueue, 0, sizeof(bench_phase_t));
+		memset(dequeue, 0, sizeof(bench_phase_t));
+		return;
+	}
+
+	BenchPhaseStart(enqueue);
+	for(i = 0; i < count; ++i)
+	{
+		ShmPriorityQueueEnqueue(queue, (ref_queue_key_t)BenchRandom(), (ref_queue_offset_t)i);
+	}
+
+	BenchPhaseStop(enqueue);
+	BenchPhaseStart(dequeue);
+	for(i = 0; i < count; ++i)
+	{
+		ShmPriorityQueueDequeue(queue, &entry);
+	}
+
+	BenchPhaseStop(dequeue);
+	ShmPriorityQueueClose(queue);
+	ShmPriorityQueueUnlink(BENCH_SHM_NAME);
+}
+/*****************************************************************************/
+static void BenchCountersOpen(void)
+{
+#ifdef __linux__
+	int i = 0;
+	struct perf_event_attr attr;
+	static const unsigned int types[BENCH_COUNTERS] =
+	{
+		PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+		PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE
+	};
+	static const unsigned long configs[BENCH_COUNTERS] =
+	{
+		PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+		PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES,
+		PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+		(PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+	};
+
+	/* Separate events, so one the PMU lacks doesn't disable the others */
+	for(i = 0; i < BENCH_COUNTERS; ++i)
+	{
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = types[i];
+		attr.config = configs[i];
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		counter_fds[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+	}
+
+	if(0 > counter_fds[0])
+	{
+		fprintf(stderr, "Hardware counters unavailable, reporting ns/op only\n");
+	}
+#endif
+}
+/*****************************************************************************/
+static void BenchCountersClose(void)
+{
+#ifdef __linux__
+	int i = 0;
+
+	for(i = 0; i < BENCH_COUNTERS; ++i)
+	{
+		if(0 <= counter_fds[i])
+		{
+			close(counter_fds[i]);
+			counter_fds[i] = -1;
+		}
+	}
+#endif
+}
+/*****************************************************************************/
+static void BenchPhaseStart(bench_phase_t *phase)
+{
+#ifdef __linux__
+	int i = 0;
+
+	for(i = 0; i < BENCH_COUNTERS; ++i)
+	{
+		if(0 <= counter_fds[i])
+		{
+			ioctl(counter_fds[i], PERF_EVENT_IOC_RESET, 0);
+			ioctl(counter_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+#endif
+	phase->ns = BenchNow();
+}
+/*****************************************************************************/
+static void BenchPhaseStop(bench_phase_t *phase)
+{
+	int i = 0;
+#ifdef __linux__
+	__u64 values[3] = {0, 0, 0};
+#endif
+
+	phase->ns = BenchNow() - phase->ns;
+	for(i = 0; i < BENCH_COUNTERS; ++i)
+	{
+		phase->counters[i] = -1;
+#ifdef __linux__
+		if(0 > counter_fds[i])
+		{
+			continue;
+		}
+
+		ioctl(counter_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+		if(sizeof(values) == read(counter_fds[i], values, sizeof(values)) && 0 < values[2])
+		{
+			/* Scale up when the kernel had to multiplex the counters */
+			phase->counters[i] = (double)values[0] * ((double)values[1] / (double)values[2]);
+		}
+#endif
+	}
+}
+/*****************************************************************************/
+static int BenchCmp(void *data, void *new_data)
+{
+	return ((size_t)new_data > (size_t)data) - ((size_t)new_data < (size_t)data);
+}
+/*****************************************************************************/
+static unsigned long BenchKey(void *data)
+{
+	return ((unsigned long)(size_t)data & 0xFFFFFFFFUL);
+}
+/*****************************************************************************/
+static unsigned long BenchLevel(void *data)
+{
+	return ((unsigned long)(size_t)data % PRIORITY_QUEUE_MAX_LEVELS);
+}
+/*****************************************************************************/
+static unsigned long BenchCmpBatch(void *data, void **new_data, size_t count)
+{
+	size_t i = 0;
+	unsigned long mask = 0;
+
+	/* A fixed trip count of independent compares the compiler can vectorize */
+	for(i = 0; i < count; ++i)
+	{
+		mask |= (unsigned long)((size_t)new_data[i] > (size_t)data) << i;
+	}
+
+	return mask;
+}
+/*****************************************************************************/
+static size_t BenchRandom(void)
+{
+	/* xorshift, deterministic so every run sees the same keys */
+	bench_seed ^= bench_seed << 13;
+	bench_seed ^= bench_seed >> 7;
+	bench_seed ^= bench_seed << 17;
+	return (bench_seed >> 1);
+}
+/*****************************************************************************/
+static double BenchNow(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((double)now.tv_sec * 1e9 + (double)now.tv_nsec);
+}
+/*****************************************************************************/
+static int BenchWrite(const char *path, const bench_result_t *results, size_t count)
+{
+	size_t i = 0;
+	int j = 0;
+	FILE *file = fopen(path, "w");
+	if(NULL == file)
+	{
+		return (1);
+	}
+
+	fprintf(file, "{\n\t\"unit\": \"ns/op\",\n\t\"benchmarks\": [\n");
+	for(i = 0; i < count; ++i)
+	{
+		fprintf(file, "\t\t{\"name\": \"%s\", \"ns_per_op\": %.3f", results[i].name, results[i].ns_per_op);
+		for(j = 0; j < BENCH_COUNTERS; ++j)
+		{
+			if(0 > results[i].counters_per_op[j])
+			{
+				fprintf(file, ", \"%s_per_op\": null", counter_names[j]);
+			}
+			else
+			{
+				fprintf(file, ", \"%s_per_op\": %.3f", counter_names[j], results[i].counters_per_op[j]);
+			}
+		}
+
+		fprintf(file, "}%s\n", (i + 1 < count) ? "," : "");
+	}
+
+	fprintf(file, "\t]\n}\n");
+	return (0 != fclose(file));
+}
+/*****************************************************************************/
+static size_t BenchRead(const char *path, bench_result_t *results)
+{
+	size_t count = 0;
+	char line[512] = {0};
+	FILE *file = fopen(path, "r");
+	if(NULL == file)
+	{
+		return (0);
+	}
+
+	/* One benchmark per line, as written by BenchWrite; counters aren't compared */
+	while(count < BENCH_MAX_RESULTS && NULL != fgets(line, sizeof(line), file))
+	{
+		if(2 == sscanf(line, " {\"name\": \"%63[^\"]\", \"ns_per_op\": %lf",
+		               results[count].name, &results[count].ns_per_op))
+		{
+			++count;
+		}
+	}
+
+	fclose(file);
+	return (count);
+}
+/*****************************************************************************/
+static int BenchCompare(const bench_result_t *current, size_t count, const bench_result_t *baseline, size_t baseline_count, double threshold)
+{
+	size_t i = 0;
+	size_t j = 0;
+	int status = 0;
+	double change = 0;
+
+	printf("\n%-32s %12s %12s %9s\n", "benchmark", "baseline", "current", "change");
+	for(i = 0; i < count; ++i)
+	{
+		for(j = 0; j < baseline_count && 0 != strcmp(current[i].name, baseline[j].name); ++j);
+		if(j == baseline_count || 0 >= baseline[j].ns_per_op)
+		{
+			printf("%-32s %12s %12.2f %9s\n", current[i].name, "-", current[i].ns_per_op, "new");
+			continue;
+		}
+
+		change = (current[i].ns_per_op / baseline[j].ns_per_op - 1.0) * 100.0;
+		printf("%-32s %12.2f %12.2f %+8.1f%%%s\n", current[i].name, baseline[j].ns_per_op,
+		current[i].ns_per_op, change, (change > threshold) ? "  REGRESSION" : "");
+		if(change > threshold)
+		{
+			status = 1;
+		}
+	}
+
+	printf("\n%s (threshold %.1f%%)\n", status ? "Performance regression detected" : "No performance regression", threshold);
+	return (status);
+}
+/*****************************************************************************/
@@ -0,0 +1,409 @@
+/******************************************************************************
+ * @writer:      Tal Aharon
+ * @date:        19.10.2026
+ *
+ * @description: This file contains the differential fuzz harness for the
+ *               Priority Queue implementation. The input bytes are decoded into
+ *               a sequence of Enqueue, EnqueueBatch, Dequeue, DequeueLast, Peek,
+ *               Erase, Clear and Merge operations, applied in lockstep to a
+ *               queue of every engine and to a plain array used as the
+ *               reference model. Every result,
+ *               size and emptiness report must be identical, otherwise the
+ *               harness aborts so the fuzzer records the input.
+ *
+ *               Elements are small integers stored in the data pointers, so
+ *               elements of equal priority are indistinguishable and engines
+ *               may break ties differently without being reported.
+ *
+ *               Built with PRIORITY_QUEUE_FUZZ_LIBFUZZER defined, the file only
+ *               provides LLVMFuzzerTestOneInput. Otherwise it has a main that
+ *               runs every file named on the command line, standard input when
+ *               there is none (AFL), or pseudo random inputs:
+ *
+ *               usage: priority_queue_fuzz [FILE...] | [--random COUNT [SEED]]
+ *
+******************************************************************************/
+#include <stdio.h>   /* fprintf, fopen, fread */
+#include <stdlib.h>  /* abort, atol           */
+#include <string.h>  /* strcmp                */
+
+#include "priority_queue.h"
+/*****************************************************************************/
+#define FUZZ_MAX_ELEMENTS (4096)
+#define FUZZ_MAX_MERGE (16)
+/* Batches reach past the size keyed engines start sorting at */
+#define FUZZ_MAX_BATCH (128)
+#define FUZZ_MAX_INPUT (8192)
+#define FUZZ_VALUES (32)
+/* Wide enough for three levels of clusters, small enough for cheap tables */
+#define FUZZ_KEY_BITS (20)
+#define FUZZ_KEY_STEP (0x7FFFUL)
+/* Just over 64 words of levels, three bitmaps deep on 64 bit words */
+#define FUZZ_LEVELS (4160UL)
+#define FUZZ_LEVEL_STEP (126UL)
+
+typedef enum fuzz_operation
+{
+	FUZZ_ENQUEUE = 0,
+	FUZZ_DEQUEUE,
+	FUZZ_PEEK,
+	FUZZ_ERASE,
+	FUZZ_CLEAR,
+	FUZZ_MERGE,
+	FUZZ_DEQUEUE_LAST,
+	FUZZ_ENQUEUE_BATCH,
+	FUZZ_OPERATIONS
+
+} fuzz_operation_t;
+
+typedef struct fuzz_model
+{
+	size_t values[FUZZ_MAX_ELEMENTS];
+	size_t size;
+
+} fuzz_model_t;
+
+int LLVMFuzzerTestOneInput(const unsigned char *data, size_t size);
+static priority_queue_t *FuzzCreate(priority_queue_engine_t engine);
+static int FuzzCmp(void *data, void *new_data);
+static unsigned long FuzzKey(void *data);
+static unsigned long FuzzLevel(void *data);
+static int FuzzMatch(void *data, void *parameter);
+static void FuzzCheck(int condition, const char *message, priority_queue_engine_t engine);
+static size_t FuzzModelTop(const fuzz_model_t *model);
+static size_t FuzzModelBottom(const fuzz_model_t *model);
+static size_t FuzzModelRemove(fuzz_model_t *model, size_t value);
+
+static const priority_queue_engine_t engines[] =
+{
+	PRIORITY_QUEUE_SORTED_LIST,
+	PRIORITY_QUEUE_BINARY_HEAP,
+	PRIORITY_QUEUE_DARY_HEAP,
+	PRIORITY_QUEUE_VEB,
+	PRIORITY_QUEUE_BUCKETS
+};
+
+#define FUZZ_ENGINES (sizeof(engines) / sizeof(engines[0]))
+
+static fuzz_model_t model;
+/*****************************************************************************/
+int LLVMFuzzerTestOneInput(const unsigned char *data, size_t size)
+{
+	size_t i = 0;
+	size_t e = 0;
+	size_t value = 0;
+	size_t count = 0;
+	size_t merged[FUZZ_MAX_MERGE];
+	void *batch[FUZZ_MAX_BATCH];
+	void *result = NULL;
+	priority_queue_t *queues[FUZZ_ENGINES];
+	priority_queue_t *source = NULL;
+
+	model.size = 0;
+	for(e = 0; e < FUZZ_ENGINES; ++e)
+	{
+		queues[e] = FuzzCreate(engines[e]);
+		FuzzCheck(NULL != queues[e], "create failed", engines[e]);
+	}
+
+	while(i < size)
+	{
+		switch(data[i++] % FUZZ_OPERATIONS)
+		{
+			case FUZZ_ENQUEUE:
+				value = (i < size ? data[i++] : 0) % FUZZ_VALUES + 1;
+				if(FUZZ_MAX_ELEMENTS == model.size)
+				{
+					break;
+				}
+
+				model.values[model.size++] = value;
+				for(e = 0; e < FUZZ_ENGINES; ++e)
+				{
+					FuzzCheck(0 == PriorityQueueEnqueue(queues[e], (void *)value), "enqueue failed", engines[e]);
+				}
+				break;
+
+			case FUZZ_DEQUEUE:
+				value = FuzzModelTop(&model);
+				FuzzModelRemove(&model, value);
+				for(e = 0; e < FUZZ_ENGINES; ++e)
+				{
+					result = PriorityQueueDequeue(queues[e]);
+					FuzzCheck(value == (size_t)result, "dequeue mismatch", engines[e]);
+				}
+				break;
+
+			case FUZZ_PEEK:
+				value = FuzzModelTop(&model);
+				for(e = 0; e < FUZZ_ENGINES; ++e)
+				{
+					result = PriorityQueuePeek(queues[e]);
+					FuzzCheck(value == (size_t)result, "peek mismatch", engines[e]);
+				}
+				break;
+
+			case FUZZ_ERASE:
+				value = (i < size ? data[i++] : 0) % FUZZ_VALUES + 1;
+				count = FuzzModelRemove(&model, value);
+				for(e = 0; e < FUZZ_ENGINES; ++e)
+				{
+					result = PriorityQueueErase(queues[e], FuzzMatch, (void *)value);
+					FuzzCheck((count ? (void *)value : (void *)queues[e]) == result, "erase mismatch", engines[e]);
+				}
+				break;
+
+			case FUZZ_CLEAR:
+				model.size = 0;
+				for(e = 0; e < FUZZ_ENGINES; ++e)
+				{
+					PriorityQueueClear(queues[e]);
+				}
+				break;
+
+			case FUZZ_MERGE:
+				count = (i < size ? data[i++] : 0) % FUZZ_MAX_MERGE;
+				for(value = 0; value < count; ++value)
+				{
+					merged[value] = (i < size ? data[i++] : 0) % FUZZ_VALUES + 1;
+				}
+
+				if(FUZZ_MAX_ELEMENTS - model.size < count)
+				{
+					break;
+				}
+
+				for(value = 0; value < count; ++value)
+				{
+					model.values[model.size++] = merged[value];
+				}
+
+				/* Odd counts merge from the next engine, so mixed merges run as well */
+				for(e = 0; e < FUZZ_ENGINES; ++e)
+				{
+					source = FuzzCreate(engines[(e + (count & 1)) % FUZZ_ENGINES]);
+					FuzzCheck(NULL != source, "create failed", engines[e]);
+					for(value = 0; value < count; ++value)
+					{
+						FuzzCheck(0 == PriorityQueueEnqueue(source, (void *)merged[value]), "enqueue failed", engines[e]);
+					}
+
+					FuzzCheck(0 == PriorityQueueMerge(queues[e], source), "merge failed", engines[e]);
+					FuzzCheck(PriorityQueueIsEmpty(source), "merge left source elements", engines[e]);
+					PriorityQueueDestroy(source);
+				}
+				break;
+
+			case FUZZ_DEQUEUE_LAST:
+				value = FuzzModelBottom(&model);
+				count = FuzzModelRemove(&model, value);
+				for(e = 0; e < FUZZ_ENGINES; ++e)
+				{
+					result = NULL;
+					FuzzCheck((count ? PRIORITY_QUEUE_SUCCESS : PRIORITY_QUEUE_EMPTY) ==
+					          PriorityQueueDequeueLast(queues[e], &result), "dequeue last status mismatch", engines[e]);
+					FuzzCheck(value == (size_t)result, "dequeue last mismatch", engines[e]);
+				}
+				break;
+
+			case FUZZ_ENQUEUE_BATCH:
+				count = (i < size ? data[i++] : 0) % FUZZ_MAX_BATCH;
+				for(value = 0; value < count; ++value)
+				{
+					batch[value] = (void *)(size_t)((i < size ? data[i++] : 0) % FUZZ_VALUES + 1);
+				}
+
+				if(FUZZ_MAX_ELEMENTS - model.size < count)
+				{
+					break;
+				}
+
+				for(value = 0; value < count; ++value)
+				{
+					model.values[model.size++] = (size_t)batch[value];
+				}
+
+				for(e = 0; e < FUZZ_ENGINES; ++e)
+				{
+					FuzzCheck(count == PriorityQueueEnqueueBatch(queues[e], batch, count, NULL), "enqueue batch failed", engines[e]);
+				}
+				break;
+
+			default:
+				break;
+		}
+
+		for(e = 0; e < FUZZ_ENGINES; ++e)
+		{
+			FuzzCheck(model.size == PriorityQueueSize(queues[e]), "size mismatch", engines[e]);
+			FuzzCheck((0 == model.size) == PriorityQueueIsEmpty(queues[e]), "is empty mismatch", engines[e]);
+		}
+	}
+
+	/* Draining checks the full order of whatever is left */
+	while(0 < model.size)
+	{
+		value = FuzzModelTop(&model);
+		FuzzModelRemove(&model, value);
+		for(e = 0; e < FUZZ_ENGINES; ++e)
+		{
+			FuzzCheck(value == (size_t)PriorityQueueDequeue(queues[e]), "drain mismatch", engines[e]);
+		}
+	}
+
+	for(e = 0; e < FUZZ_ENGINES; ++e)
+	{
+		PriorityQueueDestroy(queues[e]);
+	}
+
+	return (0);
+}
+/*****************************************************************************/
+#ifndef PRIORITY_QUEUE_FUZZ_LIBFUZZER
+static size_t FuzzRead(FILE *file, unsigned char *buffer)
+{
+	return (fread(buffer, 1, FUZZ_MAX_INPUT, file));
+}
+/*****************************************************************************/
+int main(int argc, char *argv[])
+{
+	int i = 1;
+	long run = 0;
+	long runs = 0;
+	size_t size = 0;
+	unsigned long seed = 2463534242UL;
+	FILE *file = NULL;
+	static unsigned char buffer[FUZZ_MAX_INPUT];
+
+	if(1 == argc)
+	{
+		size = FuzzRead(stdin, buffer);
+		return (LLVMFuzzerTestOneInput(buffer, size));
+	}
+
+	if(0 == strcmp(argv[1], "--random"))
+	{
+		runs = 2 < argc ? atol(argv[2]) : 1000;
+		seed = 3 < argc ? (unsigned long)atol(argv[3]) : seed;
+		for(run = 0; run < runs; ++run)
+		{
+			size = (seed >> 3) % FUZZ_MAX_INPUT;
+			for(i = 0; (size_t)i < size; ++i)
+			{
+				/* Linear congruential generator, the low byte of the high bits */
+				seed = seed * 1103515245UL + 12345UL;
+				buffer[i] = (unsigned char)(seed >> 16);
+			}
+
+			LLVMFuzzerTestOneInput(buffer, size);
+		}
+
+		printf("%ld random inputs: Passed.\n", runs);
+		return (0);
+	}
+
+	for(; i < argc; ++i)
+	{
+		file = fopen(argv[i], "rb");
+		if(NULL == file)
+		{
+			fprintf(stderr, "Can not open %s\n", argv[i]);
+			return (2);
+		}
+
+		size = FuzzRead(file, buffer);
+		fclose(file);
+		LLVMFuzzerTestOneInput(buffer, size);
+	}
+
+	return (0);
+}
+#endif /* PRIORITY_QUEUE_FUZZ_LIBFUZZER */
+/*****************************************************************************/
+static priority_queue_t *FuzzCreate(priority_queue_engine_t engine)
+{
+	if(PRIORITY_QUEUE_VEB == engine)
+	{
+		return (PriorityQueueCreateKeyed(FuzzKey, FUZZ_KEY_BITS));
+	}
+
+	if(PRIORITY_QUEUE_BUCKETS == engine)
+	{
+		return (PriorityQueueCreateBuckets(FuzzLevel, FUZZ_LEVELS));
+	}
+
+	return (PriorityQueueCreateEngine(FuzzCmp, engine));
+}
+/*****************************************************************************/
+static int FuzzCmp(void *data, void *new_data)
+{
+	return ((size_t)new_data > (size_t)data) - ((size_t)new_data < (size_t)data);
+}
+/*****************************************************************************/
+static unsigned long FuzzKey(void *data)
+{
+	/* The largest value gets the smallest key, spread over the whole universe */
+	return ((FUZZ_VALUES + 1 - (unsigned long)(size_t)data) * FUZZ_KEY_STEP);
+}
+/*****************************************************************************/
+static unsigned long FuzzLevel(void *data)
+{
+	return ((FUZZ_VALUES + 1 - (unsigned long)(size_t)data) * FUZZ_LEVEL_STEP);
+}
+/*****************************************************************************/
+static int FuzzMatch(void *data, void *parameter)
+{
+	return (data == parameter);
+}
+/*****************************************************************************/
+static void FuzzCheck(int condition, const char *message, priority_queue_engine_t engine)
+{
+	if(!condition)
+	{
+		fprintf(stderr, "priority_queue_fuzz: %s (engine %d)\n", message, (int)engine);
+		abort();
+	}
+}
+/*****************************************************************************/
+static size_t FuzzModelTop(const fuzz_model_t *model)
+{
+	size_t i = 0;
+	size_t top = 0;
+
+	for(i = 0; i < model->size; ++i)
+	{
+		top = model->values[i] > top ? model->values[i] : top;
+	}
+
+	return (top);
+}
+/*****************************************************************************/
+static size_t FuzzModelBottom(const fuzz_model_t *model)
+{
+	size_t i = 0;
+	size_t bottom = 0;
+
+	for(i = 0; i < model->size; ++i)
+	{
+		bottom = 0 == i || model->values[i] < bottom ? model->values[i] : bottom;
+	}
+
+	return (bottom);
+}
+/*****************************************************************************/
+static size_t FuzzModelRemove(fuzz_model_t *model, size_t value)
+{
+	size_t i = 0;
+
+	for(i = 0; i < model->size; ++i)
+	{
+		if(value == model->values[i])
+		{
+			model->values[i] = model->values[--model->size];
+			return (1);
+		}
+	}
+
+	return (0);
+}
+/*****************************************************************************/
@@ -0,0 +1,472 @@
+/******************************************************************************
+ * @writer:      Tal Aharon
+ * @date:        19.10.2026
+ *
+ * @description: This file contains the concurrent stress harness for the
+ *               shared memory Priority Queue. Every round, several threads
+ *               start together and run random enqueues and dequeues on one
+ *               queue, recording when each operation was invoked and when it
+ *               returned. The recorded history is then checked for
+ *               linearizability against a sequential priority queue, and the
+ *               queue is drained to check that no entry was lost or duplicated.
+ *
+ *               The checker searches for a sequential order consistent with
+ *               real time (an operation that returned before another one was
+ *               invoked must come first) in which every dequeue returns the
+ *               highest key present. With --relaxation K a dequeue may return
+ *               any of the K + 1 highest keys, for relaxed queues. The state of
+ *               the sequential queue only depends on the set of operations
+ *               already placed, so failed sets are remembered and never
+ *               searched twice.
+ *
+ *               All threads share one mapping of the segment: separate mappings
+ *               would put the same memory at different addresses, which hides
+ *               every access from ThreadSanitizer.
+ *
+ *               usage: priority_queue_stress [--rounds N] [--threads N]
+ *                                            [--ops N] [--relaxation K]
+ *
+******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>   /* printf, fprintf      */
+#include <stdlib.h>  /* malloc, free, atol   */
+#include <string.h>  /* strcmp, memset       */
+#include <pthread.h> /* pthread_*            */
+#include <time.h>    /* clock_gettime        */
+
+#include "shm_priority_queue.h"
+/*****************************************************************************/
+#define STRESS_SHM_NAME "/priority_queue_stress"
+#define STRESS_MAX_OPS (256)
+#define STRESS_WORD_BITS (8 * sizeof(unsigned long))
+#define STRESS_WORDS (STRESS_MAX_OPS / (8 * sizeof(unsigned long)))
+#define STRESS_MEMO_SIZE (1UL << 16)
+#define STRESS_EMPTY (-1L)
+
+typedef enum stress_type
+{
+	STRESS_ENQUEUE = 0,
+	STRESS_DEQUEUE
+
+} stress_type_t;
+
+typedef struct stress_operation
+{
+	double invoke;
+	double response;
+	stress_type_t type;
+	long key;
+
+} stress_operation_t;
+
+typedef struct stress_thread
+{
+	size_t id;
+	size_t ops;
+	size_t threads;
+	unsigned long seed;
+	shm_priority_queue_t *queue;
+	pthread_barrier_t *start;
+	stress_operation_t *history;
+
+} stress_thread_t;
+
+typedef struct stress_checker
+{
+	const stress_operation_t *history;
+	size_t count;
+	size_t relaxation;
+	size_t placed_count;
+	unsigned long placed[STRESS_WORDS];
+	unsigned char *present;
+	size_t keys;
+	unsigned long (*memo)[STRESS_WORDS];
+	unsigned char *memo_used;
+	size_t states;
+
+} stress_checker_t;
+
+static void *StressThread(void *arg);
+static int StressRound(size_t round, size_t threads, size_t ops, size_t relaxation);
+static int StressVerify(size_t round, shm_priority_queue_t *queue, stress_operation_t *history,
+                        size_t count, size_t relaxation, unsigned char *seen);
+static int StressCheck(stress_checker_t *checker);
+static int StressApply(stress_checker_t *checker, const stress_operation_t *operation);
+static void StressUndo(stress_checker_t *checker, const stress_operation_t *operation);
+static int StressMemoInsert(stress_checker_t *checker);
+static int StressInvokeCmp(const void *first, const void *second);
+static double StressNow(void);
+
+static unsigned long (*stress_memo)[STRESS_WORDS];
+static unsigned char *stress_memo_used;
+/*****************************************************************************/
+int main(int argc, char *argv[])
+{
+	int i = 1;
+	size_t round = 0;
+	size_t rounds = 200;
+	size_t threads = 4;
+	size_t ops = 48;
+	size_t relaxation = 0;
+	int status = 0;
+
+	for(; i + 1 < argc; i += 2)
+	{
+		if(0 == strcmp(argv[i], "--rounds"))
+		{
+			rounds = (size_t)atol(argv[i + 1]);
+		}
+		else if(0 == strcmp(argv[i], "--threads"))
+		{
+			threads = (size_t)atol(argv[i + 1]);
+		}
+		else if(0 == strcmp(argv[i], "--ops"))
+		{
+			ops = (size_t)atol(argv[i + 1]);
+		}
+		else if(0 == strcmp(argv[i], "--relaxation"))
+		{
+			relaxation = (size_t)atol(argv[i + 1]);
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	if(i != argc || 0 == threads || 0 == ops || STRESS_MAX_OPS < threads * ops)
+	{
+		fprintf(stderr, "usage: %s [--rounds N] [--threads N] [--ops N] [--relaxation K]\n"
+		                "       threads * ops must not exceed %d\n", argv[0], STRESS_MAX_OPS);
+		return (2);
+	}
+
+	stress_memo = (unsigned long (*)[STRESS_WORDS])malloc(STRESS_MEMO_SIZE * sizeof(*stress_memo));
+	stress_memo_used = (unsigned char *)malloc(STRESS_MEMO_SIZE);
+	if(NULL == stress_memo || NULL == stress_memo_used)
+	{
+		fprintf(stderr, "Out of memory\n");
+		return (2);
+	}
+
+	for(round = 0; round < rounds && 0 == status; ++round)
+	{
+		status = StressRound(round, threads, ops, relaxation);
+	}
+
+	free(stress_memo_used);
+	free(stress_memo);
+	if(0 == status)
+	{
+		printf("%lu rounds of %lu threads x %lu ops: Passed.\n",
+		       (unsigned long)rounds, (unsigned long)threads, (unsigned long)ops);
+	}
+
+	return (status);
+}
+/*****************************************************************************/
+static int StressRound(size_t round, size_t threads, size_t ops, size_t relaxation)
+{
+	size_t i = 0;
+	size_t count = threads * ops;
+	int status = 2;
+	shm_priority_queue_t *queue = NULL;
+	pthread_barrier_t start;
+	pthread_t *ids = (pthread_t *)malloc(threads * sizeof(pthread_t));
+	stress_thread_t *args = (stress_thread_t *)malloc(threads * sizeof(stress_thread_t));
+	stress_operation_t *history = (stress_operation_t *)malloc(count * sizeof(stress_operation_t));
+	unsigned char *seen = (unsigned char *)calloc(count, 1);
+
+	ShmPriorityQueueUnlink(STRESS_SHM_NAME);
+	if(NULL != ids && NULL != args && NULL != history && NULL != seen)
+	{
+		queue = ShmPriorityQueueCreate(STRESS_SHM_NAME, count);
+	}
+
+	if(NULL != queue)
+	{
+		pthread_barrier_init(&start, NULL, (unsigned int)threads);
+		for(i = 0; i < threads; ++i)
+		{
+			args[i].id = i;
+			args[i].ops = ops;
+			args[i].threads = threads;
+			args[i].seed = 2463534242UL + 7919UL * (round * threads + i);
+			args[i].queue = queue;
+			args[i].start = &start;
+			args[i].history = history + i * ops;
+			pthread_create(&ids[i], NULL, StressThread, &args[i]);
+		}
+
+		for(i = 0; i < threads; ++i)
+		{
+			pthread_join(ids[i], NULL);
+		}
+
+		pthread_barrier_destroy(&start);
+		status = StressVerify(round, queue, history, count, relaxation, seen);
+		ShmPriorityQueueClose(queue);
+		ShmPriorityQueueUnlink(STRESS_SHM_NAME);
+	}
+	else
+	{
+		fprintf(stderr, "Can not create %s\n", STRESS_SHM_NAME);
+	}
+
+	free(seen);
+	free(history);
+	free(args);
+	free(ids);
+	return (status);
+}
+/*****************************************************************************/
+static int StressVerify(size_t round, shm_priority_queue_t *queue, stress_operation_t *history,
+                        size_t count, size_t relaxation, unsigned char *seen)
+{
+	size_t i = 0;
+	int status = 0;
+	shm_priority_queue_entry_t entry = {0, 0};
+	stress_checker_t checker;
+
+	/* Every key may leave the queue once, by a dequeue or by the drain */
+	for(i = 0; i < count && 0 == status; ++i)
+	{
+		if(STRESS_DEQUEUE == history[i].type && STRESS_EMPTY != history[i].key)
+		{
+			status = seen[history[i].key]++ ? 1 : 0;
+		}
+	}
+
+	while(0 == status && SHM_PRIORITY_QUEUE_SUCCESS == ShmPriorityQueueDequeue(queue, &entry))
+	{
+		status = seen[entry.key]++ ? 1 : 0;
+	}
+
+	for(i = 0; i < count && 0 == status; ++i)
+	{
+		if(STRESS_ENQUEUE == history[i].type)
+		{
+			status = seen[history[i].key] ? 0 : 1;
+		}
+	}
+
+	if(0 != status)
+	{
+		fprintf(stderr, "Round %lu: an entry was lost or duplicated\n", (unsigned long)round);
+		return (status);
+	}
+
+	qsort(history, count, sizeof(stress_operation_t), StressInvokeCmp);
+	memset(&checker, 0, sizeof(checker));
+	memset(stress_memo_used, 0, STRESS_MEMO_SIZE);
+	memset(seen, 0, count);
+	checker.history = history;
+	checker.count = count;
+	checker.relaxation = relaxation;
+	checker.present = seen;
+	checker.keys = count;
+	checker.memo = stress_memo;
+	checker.memo_used = stress_memo_used;
+
+	if(StressCheck(&checker))
+	{
+		return (0);
+	}
+
+	fprintf(stderr, "Round %lu: history is not linearizable\n", (unsigned long)round);
+	for(i = 0; i < count; ++i)
+	{
+		fprintf(stderr, "  [%.0f, %.0f] %s %ld\n", history[i].invoke - history[0].invoke,
+		        history[i].response - history[0].invoke,
+		        STRESS_ENQUEUE == history[i].type ? "enqueue" : "dequeue", history[i].key);
+	}
+
+	return (1);
+}
+/*****************************************************************************/
+static void *StressThread(void *arg)
+{
+	size_t i = 0;
+	size_t enqueued = 0;
+	stress_thread_t *thread = (stress_thread_t *)arg;
+	stress_operation_t *operation = NULL;
+	shm_priority_queue_entry_t entry = {0, 0};
+
+	pthread_barrier_wait(thread->start);
+	for(i = 0; i < thread->ops; ++i)
+	{
+		operation = &thread->history[i];
+		thread->seed = thread->seed * 1103515245UL + 12345UL;
+
+		/* Keys are unique, threads interleave over the whole key range */
+		if(0 == enqueued || 6 > (thread->seed >> 16) % 10)
+		{
+			operation->type = STRESS_ENQUEUE;
+			operation->key = (long)(enqueued++ * thread->threads + thread->id);
+			operation->invoke = StressNow();
+			ShmPriorityQueueEnqueue(thread->queue, operation->key, (ref_queue_offset_t)thread->id);
+			operation->response = StressNow();
+		}
+		else
+		{
+			operation->type = STRESS_DEQUEUE;
+			operation->invoke = StressNow();
+			operation->key = SHM_PRIORITY_QUEUE_SUCCESS == ShmPriorityQueueDequeue(thread->queue, &entry) ?
+			                 (long)entry.key : STRESS_EMPTY;
+			operation->response = StressNow();
+		}
+	}
+
+	return (NULL);
+}
+/*****************************************************************************/
+static int StressCheck(stress_checker_t *checker)
+{
+	size_t i = 0;
+	double deadline = 0;
+	const stress_operation_t *operation = NULL;
+
+	if(checker->placed_count == checker->count)
+	{
+		return (1);
+	}
+
+	if(!StressMemoInsert(checker))
+	{
+		return (0);
+	}
+
+	/* Only operations invoked before the earliest pending response may go next */
+	deadline = -1;
+	for(i = 0; i < checker->count; ++i)
+	{
+		if(!(checker->placed[i / STRESS_WORD_BITS] & (1UL << (i % STRESS_WORD_BITS))) &&
+		   (0 > deadline || checker->history[i].response < deadline))
+		{
+			deadline = checker->history[i].response;
+		}
+	}
+
+	for(i = 0; i < checker->count && checker->history[i].invoke <= deadline; ++i)
+	{
+		operation = &checker->history[i];
+		if(checker->placed[i / STRESS_WORD_BITS] & (1UL << (i % STRESS_WORD_BITS)) ||
+		   !StressApply(checker, operation))
+		{
+			continue;
+		}
+
+		checker->placed[i / STRESS_WORD_BITS] |= 1UL << (i % STRESS_WORD_BITS);
+		++checker->placed_count;
+		if(StressCheck(checker))
+		{
+			return (1);
+		}
+
+		--checker->placed_count;
+		checker->placed[i / STRESS_WORD_BITS] &= ~(1UL << (i % STRESS_WORD_BITS));
+		StressUndo(checker, operation);
+	}
+
+	return (0);
+}
+/*****************************************************************************/
+static int StressApply(stress_checker_t *checker, const stress_operation_t *operation)
+{
+	size_t key = 0;
+	size_t higher = 0;
+
+	if(STRESS_ENQUEUE == operation->type)
+	{
+		checker->present[operation->key] = 1;
+		return (1);
+	}
+
+	if(STRESS_EMPTY == operation->key)
+	{
+		for(key = 0; key < checker->keys; ++key)
+		{
+			if(checker->present[key])
+			{
+				return (0);
+			}
+		}
+
+		return (1);
+	}
+
+	if(!checker->present[operation->key])
+	{
+		return (0);
+	}
+
+	for(key = (size_t)operation->key + 1; key < checker->keys; ++key)
+	{
+		higher += checker->present[key];
+	}
+
+	if(higher > checker->relaxation)
+	{
+		return (0);
+	}
+
+	checker->present[operation->key] = 0;
+	return (1);
+}
+/*****************************************************************************/
+static void StressUndo(stress_checker_t *checker, const stress_operation_t *operation)
+{
+	if(STRESS_EMPTY != operation->key)
+	{
+		checker->present[operation->key] = STRESS_DEQUEUE == operation->type;
+	}
+}
+/*****************************************************************************/
+static int StressMemoInsert(stress_checker_t *checker)
+{
+	size_t i = 0;
+	size_t probes = 0;
+	unsigned long hash = 0;
+
+	for(i = 0; i < STRESS_WORDS; ++i)
+	{
+		hash = (hash ^ checker->placed[i]) * 16777619UL;
+	}
+
+	for(hash %= STRESS_MEMO_SIZE; probes < STRESS_MEMO_SIZE; ++probes, hash = (hash + 1) % STRESS_MEMO_SIZE)
+	{
+		if(!checker->memo_used[hash])
+		{
+			checker->memo_used[hash] = 1;
+			memcpy(checker->memo[hash], checker->placed, sizeof(checker->placed));
+			++checker->states;
+			return (1);
+		}
+
+		if(0 == memcmp(checker->memo[hash], checker->placed, sizeof(checker->placed)))
+		{
+			return (0);
+		}
+	}
+
+	/* A full table only loses the pruning, never correctness */
+	return (1);
+}
+/*****************************************************************************/
+static int StressInvokeCmp(const void *first, const void *second)
+{
+	double a = ((const stress_operation_t *)first)->invoke;
+	double b = ((const stress_operation_t *)second)->invoke;
+
+	return ((a > b) - (a < b));
+}
+/*****************************************************************************/
+static double StressNow(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((double)now.tv_sec * 1e9 + (double)now.tv_nsec);
+}
+/*****************************************************************************/
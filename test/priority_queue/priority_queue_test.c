@@ -9,8 +9,15 @@
 #include <stdio.h>   /* printf, puts */
 #include <assert.h>  /*   assert     */
 #include <stdlib.h>  /*   system     */
+#include <string.h>  /*   strstr     */
+#include <time.h>    /*   clock      */
+#include <limits.h>  /* INT_MAX, LONG_MAX */
 
 #include "priority_queue.h"
+#include "shm_priority_queue.h"
+#include "ref_queue.h"
+#include "priority_queue_metrics.h"
+#include "priority_queue_typed.h"
 /*****************************************************************************/
 void PriorityQueueCreateTest(void);
 void PriorityQueueEnqueueTest(void);
@@ -20,6 +27,56 @@ void PriorityQueueIsEmptyTest(void);
 void PriorityQueueSizeTest(void);
 void PriorityQueueEraseTest(void);
 void PriorityQueueClearTest(void);
+void PriorityQueueHeapEngineTest(void);
+void PriorityQueueHandleTest(void);
+void PriorityQueueMergeTest(void);
+void PriorityQueueStatsTest(void);
+void PriorityQueueMemoryUsageTest(void);
+void PriorityQueueMetricsTest(void);
+void PriorityQueueSojournTest(void);
+void PriorityQueueCodelTest(void);
+void PriorityQueueCapacityTest(void);
+void PriorityQueueOomTest(void);
+void PriorityQueueStatusTest(void);
+void PriorityQueueTypedTest(void);
+void PriorityQueueCompareTest(void);
+void PriorityQueueSelectorTest(void);
+void PriorityQueueCompareBatchTest(void);
+void PriorityQueueVebTest(void);
+void PriorityQueueBucketsTest(void);
+void PriorityQueueKeyedBatchTest(void);
+void ShmPriorityQueueTest(void);
+void RefQueueTest(void);
+/*****************************************************************************/
+#ifdef PRIORITY_QUEUE_TEST_OOM
+/* Linked with --wrap=malloc and --wrap=calloc, the allocation the countdown
+   reaches fails */
+void *__real_malloc(size_t size);
+void *__wrap_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__wrap_calloc(size_t count, size_t size);
+static long oom_countdown = -1;
+
+void *__wrap_malloc(size_t size)
+{
+	if(0 == oom_countdown--)
+	{
+		return NULL;
+	}
+
+	return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size)
+{
+	if(0 == oom_countdown--)
+	{
+		return NULL;
+	}
+
+	return __real_calloc(count, size);
+}
+#endif
 /*****************************************************************************/
 int main(void)
 {
@@ -38,7 +95,47 @@ int main(void)
 	PriorityQueueEraseTest();
 	printf("\nPriorityQueueEraseTest(): Passed.");
 	PriorityQueueClearTest();
-	printf("\nPriorityQueueClearTest(): Passed.\n\n");
+	printf("\nPriorityQueueClearTest(): Passed.");
+	PriorityQueueHeapEngineTest();
+	printf("\nPriorityQueueHeapEngineTest(): Passed.");
+	PriorityQueueHandleTest();
+	printf("\nPriorityQueueHandleTest(): Passed.");
+	PriorityQueueMergeTest();
+	printf("\nPriorityQueueMergeTest(): Passed.");
+	PriorityQueueStatsTest();
+	printf("\nPriorityQueueStatsTest(): Passed.");
+	PriorityQueueMemoryUsageTest();
+	printf("\nPriorityQueueMemoryUsageTest(): Passed.");
+	PriorityQueueMetricsTest();
+	printf("\nPriorityQueueMetricsTest(): Passed.");
+	PriorityQueueSojournTest();
+	printf("\nPriorityQueueSojournTest(): Passed.");
+	PriorityQueueCodelTest();
+	printf("\nPriorityQueueCodelTest(): Passed.");
+	PriorityQueueCapacityTest();
+	printf("\nPriorityQueueCapacityTest(): Passed.");
+	PriorityQueueOomTest();
+	printf("\nPriorityQueueOomTest(): Passed.");
+	PriorityQueueStatusTest();
+	printf("\nPriorityQueueStatusTest(): Passed.");
+	PriorityQueueTypedTest();
+	printf("\nPriorityQueueTypedTest(): Passed.");
+	PriorityQueueCompareTest();
+	printf("\nPriorityQueueCompareTest(): Passed.");
+	PriorityQueueSelectorTest();
+	printf("\nPriorityQueueSelectorTest(): Passed.");
+	PriorityQueueCompareBatchTest();
+	printf("\nPriorityQueueCompareBatchTest(): Passed.");
+	PriorityQueueVebTest();
+	printf("\nPriorityQueueVebTest(): Passed.");
+	PriorityQueueBucketsTest();
+	printf("\nPriorityQueueBucketsTest(): Passed.");
+	PriorityQueueKeyedBatchTest();
+	printf("\nPriorityQueueKeyedBatchTest(): Passed.");
+	ShmPriorityQueueTest();
+	printf("\nShmPriorityQueueTest(): Passed.");
+	RefQueueTest();
+	printf("\nRefQueueTest(): Passed.\n\n");
 	return (0);
 }
 /*****************************************************************************/
@@ -49,9 +146,99 @@ int Match(void *data, void *parameter)
 /*****************************************************************************/
 int Cmp(void *data, void *parameter)
 {
-	return ((size_t)parameter - (size_t)data);
+	return PriorityQueueCompareSize(data, parameter);
+}
+/*****************************************************************************/
+int Subtract(void *data, void *parameter)
+{
+	/* The overflowing comparator PriorityQueueCheckCompare exists to catch */
+	return (int)((size_t)parameter - (size_t)data);
+}
+/*****************************************************************************/
+/* Number of calls of CmpBatch, to tell the heap really uses it */
+static size_t compare_batch_calls = 0;
+
+unsigned long CmpBatch(void *data, void **new_data, size_t count)
+{
+	size_t i = 0;
+	unsigned long mask = 0;
+
+	++compare_batch_calls;
+	for(i = 0; i < count; ++i)
+	{
+		mask |= (unsigned long)((size_t)new_data[i] > (size_t)data) << i;
+	}
+
+	return mask;
+}
+/*****************************************************************************/
+void CountDrop(void *data, void *parameter)
+{
+	assert(NULL != data);
+	(void)data;
+	++*(size_t *)parameter;
+}
+/*****************************************************************************/
+void Watermark(size_t size, int high, void *parameter)
+{
+	assert(0 < size || !high);
+	(void)size;
+	++((size_t *)parameter)[high];
+}
+/*****************************************************************************/
+void Spin(double seconds)
+{
+	clock_t start = clock();
+	while((double)(clock() - start) < seconds * CLOCKS_PER_SEC);
+}
+/*****************************************************************************/
+unsigned long Key(void *data)
+{
+	/* The low four bits tell apart elements of equal key */
+	return (unsigned long)((size_t)data >> 4);
+}
+/*****************************************************************************/
+unsigned long Identity(void *data)
+{
+	return (unsigned long)(size_t)data;
+}
+/*****************************************************************************/
+unsigned long BatchKey(void *data)
+{
+	/* The low twenty bits number the elements of a batch */
+	return (unsigned long)((size_t)data >> 20);
+}
+/*****************************************************************************/
+unsigned long Descending(void *data)
+{
+	/* Larger data first, as with Cmp, anything beyond the levels ahead of all */
+	return (size_t)data < 4096 ? 4095 - (unsigned long)(size_t)data : 0;
+}
+/*****************************************************************************/
+priority_queue_t *CreateOrdered(size_t engine)
+{
+	/* Any engine, the keyed ones ordered by Descending in the order of Cmp */
+	switch(engine)
+	{
+		case PRIORITY_QUEUE_VEB:
+			return PriorityQueueCreateKeyed(Descending, 12);
+
+		case PRIORITY_QUEUE_BUCKETS:
+			return PriorityQueueCreateBuckets(Descending, 4096);
+
+		default:
+			return PriorityQueueCreateEngine(Cmp, (priority_queue_engine_t)engine);
+	}
 }
 /*****************************************************************************/
+/* A typed queue of longs and the void * API as one more instantiation */
+#define LONG_HIGHER(a, b) ((a) > (b))
+#define POINTER_HIGHER(a, b) (0 < Cmp((b), (a)))
+PRIORITY_QUEUE_TYPED_DECLARE(LongQueue, long)
+PRIORITY_QUEUE_TYPED_DEFINE(LongQueue, long, LONG_HIGHER)
+PRIORITY_QUEUE_TYPED_DECLARE(PointerQueue, void *)
+PRIORITY_QUEUE_TYPED_DEFINE(PointerQueue, void *, POINTER_HIGHER)
+/*****************************************************************************/
 void PriorityQueueCreateTest(void)
 {
 	priority_queue_t *priority_queue = NULL;
@@ -432,3 +619,1816 @@ void PriorityQueueClearTest(void)
 	PriorityQueueDestroy(priority_queue);
 }
 /*****************************************************************************/
+void PriorityQueueHeapEngineTest(void)
+{
+	size_t i = 0;
+	size_t previous = 0;
+	size_t current = 0;
+	priority_queue_t *priority_queue = NULL;
+	int status = 0;
+	void *result = NULL;
+	assert(NULL == priority_queue && "Creation failed");
+	priority_queue = PriorityQueueCreateEngine(Cmp, PRIORITY_QUEUE_BINARY_HEAP);
+	assert(priority_queue && "Creation failed");
+	assert(1 == PriorityQueueIsEmpty(priority_queue));
+	assert(NULL == PriorityQueuePeek(priority_queue));
+	result = PriorityQueueDequeue(priority_queue);
+	assert(NULL == result);
+
+	/* Crosses several chunk borders on the way up and down */
+	for(i = 0; i < 100000; ++i)
+	{
+		status = PriorityQueueEnqueue(priority_queue, (void *)((i * 7919) % 100003));
+		assert(0 == status);
+	}
+
+	assert(100000 == PriorityQueueSize(priority_queue));
+	result = PriorityQueueErase(priority_queue, Match, (void *)77);
+	assert((void *)77 == result);
+	result = PriorityQueueErase(priority_queue, Match, (void *)100003);
+	assert((void *)priority_queue == result);
+	assert(99999 == PriorityQueueSize(priority_queue));
+
+	previous = (size_t)PriorityQueueDequeue(priority_queue);
+	for(i = 1; i < 99999; ++i)
+	{
+		current = (size_t)PriorityQueueDequeue(priority_queue);
+		assert(current <= previous);
+		previous = current;
+	}
+
+	assert(1 == PriorityQueueIsEmpty(priority_queue));
+	PriorityQueueEnqueue(priority_queue, (void *)1);
+	PriorityQueueEnqueue(priority_queue, (void *)18);
+	PriorityQueueEnqueue(priority_queue, (void *)9);
+	assert((void *)18 == PriorityQueuePeek(priority_queue));
+	PriorityQueueClear(priority_queue);
+	assert(1 == PriorityQueueIsEmpty(priority_queue));
+	assert(0 == PriorityQueueSize(priority_queue));
+	PriorityQueueDestroy(priority_queue);
+	(void)previous;
+	(void)status;
+	(void)result;
+}
+/*****************************************************************************/
+void PriorityQueueHandleTest(void)
+{
+	size_t i = 0;
+	priority_queue_handle_t handles[1000] = {NULL};
+	priority_queue_handle_t first = NULL;
+	priority_queue_t *priority_queue = NULL;
+	void *result = NULL;
+	assert(NULL == priority_queue && "Creation failed");
+
+	priority_queue = PriorityQueueCreate(Cmp);
+	assert(priority_queue && "Creation failed");
+	result = PriorityQueueEnqueueHandle(priority_queue, (void *)1);
+	assert(NULL == result);
+	assert(1 == PriorityQueueIsEmpty(priority_queue));
+	PriorityQueueDestroy(priority_queue);
+
+	priority_queue = PriorityQueueCreateEngine(Cmp, PRIORITY_QUEUE_BINARY_HEAP);
+	assert(priority_queue && "Creation failed");
+	first = PriorityQueueEnqueueHandle(priority_queue, (void *)500);
+	assert(first);
+
+	/* Handles survive growth and reordering of the heap */
+	for(i = 0; i < 1000; ++i)
+	{
+		handles[i] = PriorityQueueEnqueueHandle(priority_queue, (void *)(i + 1000));
+		assert(handles[i]);
+	}
+
+	result = PriorityQueueEraseHandle(priority_queue, first);
+	assert((void *)500 == result);
+	result = PriorityQueueEraseHandle(priority_queue, handles[500]);
+	assert((void *)1500 == result);
+	PriorityQueueUpdateHandle(priority_queue, handles[0], (void *)5000);
+	assert((void *)5000 == PriorityQueuePeek(priority_queue));
+	PriorityQueueUpdateHandle(priority_queue, handles[0], (void *)1);
+	assert((void *)1999 == PriorityQueuePeek(priority_queue));
+	assert(999 == PriorityQueueSize(priority_queue));
+
+	for(i = 999; i > 1; --i)
+	{
+		if(500 != i)
+		{
+			result = PriorityQueueDequeue(priority_queue);
+			assert((void *)(i + 1000) == result);
+		}
+	}
+
+	assert((void *)1001 == PriorityQueuePeek(priority_queue));
+	result = PriorityQueueEraseHandle(priority_queue, handles[0]);
+	assert((void *)1 == result);
+	result = PriorityQueueEraseHandle(priority_queue, handles[1]);
+	assert((void *)1001 == result);
+	assert(1 == PriorityQueueIsEmpty(priority_queue));
+	PriorityQueueDestroy(priority_queue);
+	(void)first;
+	(void)result;
+}
+/*****************************************************************************/
+void PriorityQueueMergeTest(void)
+{
+	size_t i = 0;
+	size_t pair = 0;
+	size_t source_size = 0;
+	priority_queue_handle_t handle = NULL;
+	priority_queue_t *dest = NULL;
+	priority_queue_t *source = NULL;
+	priority_queue_engine_t engines[] = {PRIORITY_QUEUE_SORTED_LIST, PRIORITY_QUEUE_BINARY_HEAP};
+	int status = 0;
+	void *result = NULL;
+
+	/* Every engine pair, with a source smaller and larger than dest */
+	for(pair = 0; pair < 8; ++pair)
+	{
+		dest = PriorityQueueCreateEngine(Cmp, engines[pair % 2]);
+		source = PriorityQueueCreateEngine(Cmp, engines[(pair / 2) % 2]);
+		assert(dest && source && "Creation failed");
+
+		source_size = 4 > pair ? 10 : 1000;
+		for(i = 0; i < 100; ++i)
+		{
+			status = PriorityQueueEnqueue(dest, (void *)(2 * i + 1));
+			assert(0 == status);
+		}
+
+		for(i = 0; i < source_size; ++i)
+		{
+			status = PriorityQueueEnqueue(source, (void *)(2 * i));
+			assert(0 == status);
+		}
+
+		/* Only the heap gives handles, they must survive the merge */
+		handle = PriorityQueueEnqueueHandle(dest, (void *)5000);
+		status = PriorityQueueMerge(dest, source);
+		assert(0 == status);
+		assert(1 == PriorityQueueIsEmpty(source));
+		assert(100 + source_size + (NULL != handle) == PriorityQueueSize(dest));
+		if(NULL != handle)
+		{
+			result = PriorityQueueEraseHandle(dest, handle);
+			assert((void *)5000 == result);
+		}
+
+		for(i = 200 + 2 * source_size; 0 < i; --i)
+		{
+			if((1 == i % 2 && 199 < i) || (0 == i % 2 && 2 * source_size - 2 < i))
+			{
+				continue;
+			}
+
+			result = PriorityQueueDequeue(dest);
+			assert((void *)i == result);
+		}
+
+		result = PriorityQueueDequeue(dest);
+		assert((void *)0 == result);
+		assert(1 == PriorityQueueIsEmpty(dest));
+		PriorityQueueDestroy(source);
+		PriorityQueueDestroy(dest);
+	}
+	(void)status;
+	(void)result;
+}
+/*****************************************************************************/
+void PriorityQueueStatsTest(void)
+{
+	size_t i = 0;
+	priority_queue_stats_t stats;
+	priority_queue_t *queue = PriorityQueueCreate(Cmp);
+	int status = 0;
+	void *result = NULL;
+	assert(queue && "Creation failed");
+
+	/* Ascending inserts land at the front, one comparison each but the first */
+	for(i = 1; i <= 100; ++i)
+	{
+		status = PriorityQueueEnqueue(queue, (void *)i);
+		assert(0 == status);
+	}
+
+	PriorityQueueStats(queue, &stats);
+	assert(100 == stats.insert_comparisons.samples);
+	assert(99 == stats.insert_comparisons.total);
+	assert(1 == stats.insert_comparisons.max);
+	assert(1 == stats.insert_comparisons.buckets[0]);
+	assert(99 == stats.insert_comparisons.buckets[1]);
+
+	/* The lowest priority is the last element, the highest the first */
+	result = PriorityQueueErase(queue, Match, (void *)1);
+	assert((void *)1 == result);
+	result = PriorityQueueErase(queue, Match, (void *)100);
+	assert((void *)100 == result);
+	result = PriorityQueueErase(queue, Match, (void *)500);
+	assert((void *)queue == result);
+	PriorityQueueStats(queue, &stats);
+	assert(3 == stats.scan_length.samples);
+	assert(100 + 1 + 98 == stats.scan_length.total);
+	assert(100 == stats.scan_length.max);
+	assert(1 == stats.scan_length.buckets[1]);
+	assert(2 == stats.scan_length.buckets[7]);
+
+	/* The sorted list dequeues without comparing */
+	result = PriorityQueueDequeue(queue);
+	assert((void *)99 == result);
+	result = PriorityQueueDequeue(queue);
+	assert(NULL != result);
+	PriorityQueueStats(queue, &stats);
+	assert(2 == stats.dequeue_comparisons.samples);
+	assert(0 == stats.dequeue_comparisons.total);
+	assert(100 == stats.enqueued);
+	assert(2 + 2 == stats.dequeued);
+
+	PriorityQueueStatsReset(queue);
+	PriorityQueueStats(queue, &stats);
+	assert(0 == stats.insert_comparisons.samples);
+	assert(0 == stats.scan_length.buckets[7]);
+	assert(0 == stats.enqueued && 0 == stats.dequeued);
+	PriorityQueueDestroy(queue);
+
+	/* A heap pop sifts down a full path of a thousand elements */
+	queue = PriorityQueueCreateEngine(Cmp, PRIORITY_QUEUE_BINARY_HEAP);
+	assert(queue && "Creation failed");
+	for(i = 1; i <= 1000; ++i)
+	{
+		status = PriorityQueueEnqueue(queue, (void *)i);
+		assert(0 == status);
+	}
+
+	result = PriorityQueueDequeue(queue);
+	assert((void *)1000 == result);
+	PriorityQueueStats(queue, &stats);
+	assert(1000 == stats.insert_comparisons.samples);
+	assert(1 == stats.dequeue_comparisons.samples);
+	assert(0 < stats.dequeue_comparisons.total);
+	assert(0 == stats.dequeue_comparisons.buckets[0]);
+	PriorityQueueDestroy(queue);
+	(void)status;
+	(void)result;
+}
+/*****************************************************************************/
+void PriorityQueueMemoryUsageTest(void)
+{
+	size_t i = 0;
+	size_t pass = 0;
+	size_t node_size = 0;
+	priority_queue_memory_t empty;
+	priority_queue_memory_t usage;
+	priority_queue_t *queue = NULL;
+	priority_queue_engine_t engines[] = {PRIORITY_QUEUE_SORTED_LIST, PRIORITY_QUEUE_BINARY_HEAP};
+	int status = 0;
+
+	for(pass = 0; pass < 2; ++pass)
+	{
+		queue = PriorityQueueCreateEngine(Cmp, engines[pass]);
+		assert(queue && "Creation failed");
+
+		PriorityQueueMemoryUsage(queue, &empty);
+		assert(0 == empty.nodes);
+		assert(0 < empty.index);
+		assert(0 < empty.overhead);
+
+		/* Node bytes grow by a fixed size per element */
+		status = PriorityQueueEnqueue(queue, (void *)1);
+		assert(0 == status);
+		PriorityQueueMemoryUsage(queue, &usage);
+		node_size = usage.nodes;
+		assert(0 < node_size);
+		for(i = 2; i <= 1000; ++i)
+		{
+			status = PriorityQueueEnqueue(queue, (void *)i);
+			assert(0 == status);
+		}
+
+		PriorityQueueMemoryUsage(queue, &usage);
+		assert(1000 * node_size == usage.nodes);
+		assert(usage.overhead > empty.overhead);
+
+		/* Only the heap keeps storage around for elements it no longer has */
+		PriorityQueueClear(queue);
+		PriorityQueueMemoryUsage(queue, &usage);
+		assert(0 == usage.nodes);
+		assert((0 == pass) == (0 == usage.spare));
+		PriorityQueueDestroy(queue);
+	}
+
+	(void)node_size;
+	(void)status;
+}
+/*****************************************************************************/
+void PriorityQueueMetricsTest(void)
+{
+	size_t i = 0;
+	size_t length = 0;
+	char text[4096];
+	priority_queue_t *first = PriorityQueueCreate(Cmp);
+	priority_queue_t *second = PriorityQueueCreateEngine(Cmp, PRIORITY_QUEUE_BINARY_HEAP);
+	priority_queue_t *third = PriorityQueueCreate(Cmp);
+	priority_queue_metrics_t *metrics = PriorityQueueMetricsCreate();
+	priority_queue_metrics_source_t *worker = NULL;
+	priority_queue_metrics_source_t *other = NULL;
+	size_t count = 0;
+	int status = 0;
+	void *result = NULL;
+	assert(first && second && third && metrics && "Creation failed");
+
+	/* Two workers share a name and are summed into one series */
+	worker = PriorityQueueMetricsRegister(metrics, first, "jobs");
+	other = PriorityQueueMetricsRegister(metrics, second, "jobs");
+	assert(worker && other && "Registration failed");
+	for(i = 1; i <= 10; ++i)
+	{
+		status = PriorityQueueEnqueue(first, (void *)i);
+		assert(0 == status);
+		status = PriorityQueueEnqueue(second, (void *)i);
+		assert(0 == status);
+	}
+
+	result = PriorityQueueDequeue(first);
+	assert((void *)10 == result);
+
+	/* Both ends and erases count as dequeues, a merge moves without counting */
+	status = PriorityQueueDequeueLast(second, &result);
+	assert(PRIORITY_QUEUE_SUCCESS == status && (void *)1 == result);
+	result = PriorityQueueErase(second, Match, (void *)5);
+	assert((void *)5 == result);
+	PriorityQueueEnqueue(third, (void *)1);
+	PriorityQueueEnqueue(third, (void *)5);
+	status = PriorityQueueMerge(second, third);
+	assert(0 == status);
+	PriorityQueueMetricsObserveSojourn(worker, 0.0005);
+	PriorityQueueMetricsObserveSojourn(worker, 20);
+
+	/* Nothing is visible before it is published */
+	PriorityQueueMetricsRender(metrics, text, sizeof(text));
+	assert(NULL != strstr(text, "priority_queue_depth{queue=\"jobs\"} 0\n"));
+
+	PriorityQueueMetricsPublish(worker);
+	PriorityQueueMetricsPublish(other);
+	length = PriorityQueueMetricsRender(metrics, text, sizeof(text));
+	assert(length == strlen(text));
+	assert(NULL != strstr(text, "# TYPE priority_queue_depth gauge\n"));
+	assert(NULL != strstr(text, "priority_queue_depth{queue=\"jobs\"} 19\n"));
+	assert(NULL != strstr(text, "priority_queue_enqueued_total{queue=\"jobs\"} 20\n"));
+	assert(NULL != strstr(text, "priority_queue_dequeued_total{queue=\"jobs\"} 3\n"));
+	assert(NULL != strstr(text, "priority_queue_comparisons_total{queue=\"jobs\",operation=\"dequeue\"} 0\n"));
+#ifdef PRIORITY_QUEUE_SOJOURN
+	/* The queues measured the dequeue and the removal of the last element */
+	assert(NULL != strstr(text, "priority_queue_time_in_queue_seconds_bucket{queue=\"jobs\",le=\"1\"} 2\n"));
+	assert(NULL != strstr(text, "priority_queue_time_in_queue_seconds_bucket{queue=\"jobs\",le=\"+Inf\"} 2\n"));
+#else
+	assert(NULL != strstr(text, "priority_queue_time_in_queue_seconds_bucket{queue=\"jobs\",le=\"0.0001\"} 0\n"));
+	assert(NULL != strstr(text, "priority_queue_time_in_queue_seconds_bucket{queue=\"jobs\",le=\"0.001\"} 1\n"));
+	assert(NULL != strstr(text, "priority_queue_time_in_queue_seconds_bucket{queue=\"jobs\",le=\"10\"} 1\n"));
+	assert(NULL != strstr(text, "priority_queue_time_in_queue_seconds_bucket{queue=\"jobs\",le=\"+Inf\"} 2\n"));
+#endif
+	assert(NULL != strstr(text, "priority_queue_time_in_queue_seconds_count{queue=\"jobs\"} 2\n"));
+
+	/* A short buffer is truncated and terminated, the full length is reported */
+	count = PriorityQueueMetricsRender(metrics, text, 16);
+	assert(length == count);
+	assert(15 == strlen(text));
+
+	/* Label values are escaped */
+	PriorityQueueMetricsUnregister(metrics, other);
+	other = PriorityQueueMetricsRegister(metrics, second, "a\"b");
+	PriorityQueueMetricsPublish(other);
+	PriorityQueueMetricsRender(metrics, text, sizeof(text));
+	assert(NULL != strstr(text, "priority_queue_depth{queue=\"a\\\"b\"} 10\n"));
+	assert(NULL != strstr(text, "priority_queue_depth{queue=\"jobs\"} 9\n"));
+
+	PriorityQueueMetricsDestroy(metrics);
+	PriorityQueueDestroy(first);
+	PriorityQueueDestroy(second);
+	PriorityQueueDestroy(third);
+	(void)length;
+	(void)count;
+	(void)status;
+	(void)result;
+}
+/*****************************************************************************/
+void PriorityQueueSojournTest(void)
+{
+	size_t i = 0;
+	size_t pass = 0;
+	priority_queue_stats_t stats;
+	priority_queue_handle_t handle = NULL;
+	priority_queue_t *queue = NULL;
+	priority_queue_t *source = NULL;
+	priority_queue_engine_t engines[] = {PRIORITY_QUEUE_SORTED_LIST, PRIORITY_QUEUE_BINARY_HEAP};
+	int status = 0;
+	void *result = NULL;
+
+	for(pass = 0; pass < 2; ++pass)
+	{
+		queue = PriorityQueueCreateEngine(Cmp, engines[pass]);
+		source = PriorityQueueCreateEngine(Cmp, engines[1 - pass]);
+		assert(queue && source && "Creation failed");
+		for(i = 1; i <= 100; ++i)
+		{
+			status = PriorityQueueEnqueue(queue, (void *)i);
+			assert(0 == status);
+			status = PriorityQueueEnqueue(source, (void *)(i + 1000));
+			assert(0 == status);
+		}
+
+		/* Every way out of the queue hands back the user data */
+		handle = PriorityQueueEnqueueHandle(queue, (void *)500);
+		if(NULL != handle)
+		{
+			PriorityQueueUpdateHandle(queue, handle, (void *)5000);
+			assert((void *)5000 == PriorityQueuePeek(queue));
+			result = PriorityQueueEraseHandle(queue, handle);
+			assert((void *)5000 == result);
+		}
+
+		result = PriorityQueueErase(queue, Match, (void *)50);
+		assert((void *)50 == result);
+		status = PriorityQueueMerge(queue, source);
+		assert(0 == status);
+		assert((void *)1100 == PriorityQueuePeek(queue));
+		for(i = 1100; i > 1090; --i)
+		{
+			result = PriorityQueueDequeue(queue);
+			assert((void *)i == result);
+		}
+
+		PriorityQueueStats(queue, &stats);
+#ifdef PRIORITY_QUEUE_SOJOURN
+		assert(10 == stats.sojourn_us.samples);
+		assert(60000000 > stats.sojourn_us.max);
+#else
+		assert(0 == stats.sojourn_us.samples);
+#endif
+
+		PriorityQueueClear(queue);
+		status = PriorityQueueEnqueue(queue, (void *)7);
+		result = PriorityQueueDequeue(queue);
+		assert(0 == status && (void *)7 == result);
+		PriorityQueueEnqueue(queue, (void *)8);
+		PriorityQueueDestroy(source);
+		PriorityQueueDestroy(queue);
+	}
+
+	(void)status;
+	(void)result;
+}
+/*****************************************************************************/
+void PriorityQueueCodelTest(void)
+{
+#ifdef PRIORITY_QUEUE_SOJOURN
+	size_t i = 0;
+	size_t drops = 0;
+	size_t served = 0;
+	int status = 0;
+	void *data = NULL;
+	void *last = NULL;
+	priority_queue_stats_t stats;
+	priority_queue_t *queue = PriorityQueueCreateEngine(Cmp, PRIORITY_QUEUE_BINARY_HEAP);
+	assert(queue && "Creation failed");
+
+	/* Fresh elements are never dropped */
+	status = PriorityQueueSetCodel(queue, 100000, 100000, CountDrop, &drops);
+	assert(0 == status);
+	for(i = 1; i <= 100; ++i)
+	{
+		status = PriorityQueueEnqueue(queue, (void *)i);
+		assert(0 == status);
+		data = PriorityQueueDequeue(queue);
+		assert((void *)i == data);
+	}
+
+	assert(0 == drops);
+
+	/* A standing queue served slowly sheds its lowest elements at an 
+	   increasing rate, while every dequeue still gets the head */
+	status = PriorityQueueSetCodel(queue, 1, 2000, CountDrop, &drops);
+	assert(0 == status);
+	for(i = 1; i <= 200; ++i)
+	{
+		status = PriorityQueueEnqueue(queue, (void *)i);
+		assert(0 == status);
+	}
+
+	Spin(0.03);
+	for(i = 0; i < 200 && !PriorityQueueIsEmpty(queue); ++i)
+	{
+		data = PriorityQueueDequeue(queue);
+		assert((void *)(200 - served) == data);
+		last = data;
+		++served;
+		Spin(0.01);
+	}
+
+	PriorityQueueStats(queue, &stats);
+	assert(PriorityQueueIsEmpty(queue));
+	assert(0 < drops);
+	assert(drops == stats.dropped);
+	assert(200 == served + drops);
+	assert((void *)(drops + 1) == last);
+	assert(50 > served);
+
+	/* Turned off, nothing is dropped however stale */
+	status = PriorityQueueSetCodel(queue, 0, 0, NULL, NULL);
+	assert(0 == status);
+	status = PriorityQueueEnqueue(queue, (void *)1);
+	assert(0 == status);
+	status = PriorityQueueEnqueue(queue, (void *)2);
+	assert(0 == status);
+	Spin(0.01);
+	data = PriorityQueueDequeue(queue);
+	assert((void *)2 == data);
+	data = PriorityQueueDequeue(queue);
+	assert((void *)1 == data);
+	PriorityQueueDestroy(queue);
+	(void)last;
+#else
+	size_t drops = 0;
+	int status = 0;
+	priority_queue_t *queue = PriorityQueueCreateEngine(Cmp, PRIORITY_QUEUE_BINARY_HEAP);
+	assert(queue && "Creation failed");
+
+	/* Without wait times there is nothing to manage */
+	status = PriorityQueueSetCodel(queue, 5000, 100000, CountDrop, &drops);
+	assert(0 != status);
+	PriorityQueueDestroy(queue);
+#endif
+	(void)status;
+}
+/*****************************************************************************/
+void PriorityQueueCapacityTest(void)
+{
+	size_t i = 0;
+	size_t engine = 0;
+	size_t evicted = 0;
+	size_t marks[2] = {0, 0};
+	priority_queue_stats_t stats;
+	priority_queue_t *queue = NULL;
+	priority_queue_t *other = NULL;
+	int status = 0;
+	void *result = NULL;
+
+	for(engine = 0; engine <= PRIORITY_QUEUE_BUCKETS; ++engine)
+	{
+		evicted = 0;
+		marks[0] = marks[1] = 0;
+		queue = CreateOrdered(engine);
+		other = CreateOrdered(engine);
+		assert(queue && other && "Creation failed");
+
+		/* Rejecting keeps what is queued, the high watermark fires once */
+		PriorityQueueSetWatermarks(queue, 8, 2, Watermark, marks);
+		status = PriorityQueueSetCapacity(queue, 10, PRIORITY_QUEUE_REJECT, NULL, NULL);
+		assert(0 == status);
+		for(i = 1; i <= 10; ++i)
+		{
+			status = PriorityQueueEnqueue(queue, (void *)(i * 10));
+			assert(0 == status);
+		}
+
+		assert(0 == marks[0] && 1 == marks[1]);
+		status = PriorityQueueEnqueue(queue, (void *)1000);
+		assert(PRIORITY_QUEUE_FULL == status);
+		result = PriorityQueueEnqueueHandle(queue, (void *)1000);
+		assert(NULL == result);
+		assert(10 == PriorityQueueSize(queue));
+		assert((void *)100 == PriorityQueuePeek(queue));
+
+		/* Evicting replaces the lowest, unless the new element is no higher */
+		status = PriorityQueueSetCapacity(queue, 10, PRIORITY_QUEUE_EVICT_LOWEST, CountDrop, &evicted);
+		assert(0 == status);
+		status = PriorityQueueEnqueue(queue, (void *)1000);
+		assert(0 == status);
+		assert(1 == evicted);
+		status = PriorityQueueEnqueue(queue, (void *)5);
+		assert(PRIORITY_QUEUE_FULL == status);
+		status = PriorityQueueEnqueue(queue, (void *)20);
+		assert(PRIORITY_QUEUE_FULL == status);
+		assert(1 == evicted);
+		assert(10 == PriorityQueueSize(queue));
+
+		PriorityQueueStats(queue, &stats);
+		assert(1 == stats.evicted);
+		assert(3 + (PRIORITY_QUEUE_BINARY_HEAP == engine || PRIORITY_QUEUE_DARY_HEAP == engine) == stats.rejected);
+
+		/* Draining to the low watermark fires it once */
+		result = PriorityQueueDequeue(queue);
+		assert((void *)1000 == result);
+		for(i = 10; i >= 2; --i)
+		{
+			result = PriorityQueueDequeue(queue);
+			assert((void *)(i * 10) == result);
+		}
+
+		assert(1 == marks[0] && 1 == marks[1]);
+		assert(PriorityQueueIsEmpty(queue));
+
+		/* A merge that would not fit moves nothing */
+		status = PriorityQueueSetCapacity(queue, 4, PRIORITY_QUEUE_REJECT, NULL, NULL);
+		assert(0 == status);
+		for(i = 1; i <= 5; ++i)
+		{
+			status = PriorityQueueEnqueue(other, (void *)i);
+			assert(0 == status);
+		}
+
+		status = PriorityQueueMerge(queue, other);
+		assert(PRIORITY_QUEUE_FULL == status);
+		assert(5 == PriorityQueueSize(other));
+		result = PriorityQueueDequeue(other);
+		assert((void *)5 == result);
+		status = PriorityQueueMerge(queue, other);
+		assert(0 == status);
+		assert(4 == PriorityQueueSize(queue));
+		assert(0 == PriorityQueueSize(other));
+
+		/* The capacity can not drop below the size, zero removes the bound */
+		status = PriorityQueueSetCapacity(queue, 3, PRIORITY_QUEUE_REJECT, NULL, NULL);
+		assert(0 != status);
+		status = PriorityQueueSetCapacity(queue, 0, PRIORITY_QUEUE_REJECT, NULL, NULL);
+		assert(0 == status);
+		status = PriorityQueueEnqueue(queue, (void *)5);
+		assert(0 == status);
+		assert(5 == PriorityQueueSize(queue));
+
+		PriorityQueueClear(queue);
+		assert(0 == PriorityQueueSize(queue));
+		PriorityQueueDestroy(other);
+		PriorityQueueDestroy(queue);
+	}
+
+	(void)evicted;
+	(void)status;
+	(void)result;
+}
+/*****************************************************************************/
+void PriorityQueueOomTest(void)
+{
+#ifdef PRIORITY_QUEUE_TEST_OOM
+	long fail = 0;
+	size_t i = 0;
+	size_t engine = 0;
+	size_t stored = 0;
+	size_t failures = 0;
+	int status = 0;
+	void *last = NULL;
+	void *data = NULL;
+	priority_queue_t *queue = NULL;
+
+	for(engine = 0; engine <= PRIORITY_QUEUE_BUCKETS; ++engine)
+	{
+		/* A creation failing at any allocation frees what it had */
+		for(fail = 0; fail < 8; ++fail)
+		{
+			oom_countdown = fail;
+			queue = CreateOrdered(engine);
+			oom_countdown = -1;
+			if(NULL != queue)
+			{
+				PriorityQueueDestroy(queue);
+			}
+		}
+
+		/* A failed enqueue reports it and leaves the queue intact */
+		stored = 0;
+		queue = CreateOrdered(engine);
+		assert(queue && "Creation failed");
+		for(i = 1; i <= 300; ++i)
+		{
+			oom_countdown = (long)(i % 3) - 1;
+			status = PriorityQueueEnqueue(queue, (void *)i);
+			oom_countdown = -1;
+			assert(0 == status || PRIORITY_QUEUE_NO_MEMORY == status);
+			failures += (0 != status);
+			stored += (0 == status);
+			assert(stored == PriorityQueueSize(queue));
+		}
+
+		for(last = (void *)1000; !PriorityQueueIsEmpty(queue); last = data, --stored)
+		{
+			data = PriorityQueueDequeue(queue);
+			assert((size_t)data < (size_t)last);
+		}
+
+		assert(0 == stored);
+		PriorityQueueDestroy(queue);
+	}
+
+	/* Every insert of the sorted list allocates, so some had to fail */
+	assert(100 <= failures);
+#endif
+}
+/*****************************************************************************/
+void PriorityQueueStatusTest(void)
+{
+	size_t i = 0;
+	size_t engine = 0;
+	void *data = NULL;
+	void *batch[8];
+	priority_queue_status_t statuses[8];
+	priority_queue_t *queue = NULL;
+	size_t count = 0;
+	int status = 0;
+
+	for(engine = 0; engine <= PRIORITY_QUEUE_BUCKETS; ++engine)
+	{
+		queue = CreateOrdered(engine);
+		assert(queue && "Creation failed");
+
+		/* Nothing to return is a status, the out-parameter is left alone */
+		data = (void *)7;
+		status = PriorityQueueDequeueInto(queue, &data);
+		assert(PRIORITY_QUEUE_EMPTY == status);
+		assert(PRIORITY_QUEUE_EMPTY == PriorityQueuePeekInto(queue, &data));
+		status = PriorityQueueEraseInto(queue, Match, (void *)7, &data);
+		assert(PRIORITY_QUEUE_NOT_FOUND == status);
+		assert((void *)7 == data);
+
+		/* The queue itself and NULL are ordinary data */
+		status = PriorityQueueEnqueue(queue, (void *)queue);
+		assert(PRIORITY_QUEUE_SUCCESS == status);
+		status = PriorityQueueEraseInto(queue, Match, (void *)queue, &data);
+		assert(PRIORITY_QUEUE_SUCCESS == status);
+		assert((void *)queue == data);
+		status = PriorityQueueEraseInto(queue, Match, (void *)queue, &data);
+		assert(PRIORITY_QUEUE_NOT_FOUND == status);
+		status = PriorityQueueEnqueue(queue, NULL);
+		assert(PRIORITY_QUEUE_SUCCESS == status);
+		assert(PRIORITY_QUEUE_SUCCESS == PriorityQueuePeekInto(queue, &data));
+		assert(NULL == data);
+		data = (void *)7;
+		status = PriorityQueueDequeueInto(queue, &data);
+		assert(PRIORITY_QUEUE_SUCCESS == status);
+		assert(NULL == data);
+
+		/* A batch reports every element, those after a failure are tried too */
+		status = PriorityQueueSetCapacity(queue, 5, PRIORITY_QUEUE_REJECT, NULL, NULL);
+		assert(0 == status);
+		for(i = 0; i < 8; ++i)
+		{
+			batch[i] = (void *)(i + 1);
+		}
+
+		count = PriorityQueueEnqueueBatch(queue, batch, 8, statuses);
+		assert(5 == count);
+		for(i = 0; i < 8; ++i)
+		{
+			assert((i < 5 ? PRIORITY_QUEUE_SUCCESS : PRIORITY_QUEUE_FULL) == statuses[i]);
+		}
+
+		count = PriorityQueueEnqueueBatch(queue, batch, 2, NULL);
+		assert(0 == count);
+		count = PriorityQueueDequeueBatch(queue, batch, 3);
+		assert(3 == count);
+		count = PriorityQueueDequeueBatch(queue, batch + 3, 8);
+		assert(2 == count);
+		for(i = 0; i < 5; ++i)
+		{
+			assert((void *)(5 - i) == batch[i]);
+		}
+
+		count = PriorityQueueDequeueBatch(queue, batch, 8);
+		assert(0 == count);
+		count = PriorityQueueEnqueueBatch(queue, NULL, 0, NULL);
+		assert(0 == count);
+		PriorityQueueDestroy(queue);
+	}
+
+	(void)count;
+	(void)status;
+}
+/*****************************************************************************/
+void PriorityQueueTypedTest(void)
+{
+	size_t i = 0;
+	long value = 0;
+	long previous = 0;
+	void *data = NULL;
+	void *expected = NULL;
+	LongQueue_t *longs = NULL;
+	PointerQueue_t *pointers = NULL;
+	priority_queue_t *queue = NULL;
+	int status = 0;
+
+	longs = LongQueueCreate();
+	assert(longs && "Creation failed");
+	assert(1 == LongQueueIsEmpty(longs));
+	status = LongQueueDequeue(longs, &value);
+	assert(PRIORITY_QUEUE_EMPTY == status);
+	assert(PRIORITY_QUEUE_EMPTY == LongQueuePeek(longs, &value));
+
+	/* Negative keys and duplicates, past the first growth of the array */
+	for(i = 0; i < 1000; ++i)
+	{
+		status = LongQueueEnqueue(longs, (long)(i * 7919 % 211) - 100);
+		assert(PRIORITY_QUEUE_SUCCESS == status);
+	}
+
+	assert(1000 == LongQueueSize(longs));
+	assert(PRIORITY_QUEUE_SUCCESS == LongQueuePeek(longs, &value));
+	assert(110 == value);
+	previous = value;
+	for(i = 0; i < 1000; ++i)
+	{
+		status = LongQueueDequeue(longs, &value);
+		assert(PRIORITY_QUEUE_SUCCESS == status);
+		assert(value <= previous);
+		previous = value;
+	}
+
+	assert(-100 == previous);
+	assert(1 == LongQueueIsEmpty(longs));
+
+	/* Reserved storage is kept by clear, dequeue may discard the element */
+	status = LongQueueReserve(longs, 4096);
+	assert(PRIORITY_QUEUE_SUCCESS == status);
+	status = LongQueueEnqueue(longs, 3);
+	assert(PRIORITY_QUEUE_SUCCESS == status);
+	status = LongQueueEnqueue(longs, 5);
+	assert(PRIORITY_QUEUE_SUCCESS == status);
+	status = LongQueueDequeue(longs, NULL);
+	assert(PRIORITY_QUEUE_SUCCESS == status);
+	assert(PRIORITY_QUEUE_SUCCESS == LongQueuePeek(longs, &value));
+	assert(3 == value);
+	LongQueueClear(longs);
+	assert(0 == LongQueueSize(longs));
+	LongQueueDestroy(longs);
+
+	/* The void * instantiation dequeues in the order of the void * API */
+	pointers = PointerQueueCreate();
+	queue = PriorityQueueCreateEngine(Cmp, PRIORITY_QUEUE_BINARY_HEAP);
+	assert(pointers && queue && "Creation failed");
+	for(i = 0; i < 500; ++i)
+	{
+		data = (void *)(i * 7919 % 499 + 1);
+		status = PointerQueueEnqueue(pointers, data);
+		assert(PRIORITY_QUEUE_SUCCESS == status);
+		status = PriorityQueueEnqueue(queue, data);
+		assert(PRIORITY_QUEUE_SUCCESS == status);
+	}
+
+	while(PRIORITY_QUEUE_SUCCESS == PriorityQueueDequeueInto(queue, &expected))
+	{
+		status = PointerQueueDequeue(pointers, &data);
+		assert(PRIORITY_QUEUE_SUCCESS == status);
+		assert(expected == data);
+	}
+
+	assert(1 == PointerQueueIsEmpty(pointers));
+	PointerQueueDestroy(pointers);
+	PriorityQueueDestroy(queue);
+	(void)previous;
+	(void)status;
+}
+/*****************************************************************************/
+void PriorityQueueCompareTest(void)
+{
+	size_t i = 0;
+	size_t engine = 0;
+	int ints[] = {INT_MIN, -1, 0, 1, INT_MAX};
+	double doubles[] = {-1e300, -0.0, 0.0, 1e-300, 1e300};
+	void *ints_data[5];
+	void *doubles_data[5];
+	void *sizes[] = {(void *)0, (void *)1, (void *)((size_t)INT_MAX + 2), (void *)((size_t)-1)};
+	void *longs[] = {(void *)LONG_MIN, (void *)-1L, (void *)0L, (void *)LONG_MAX};
+	static const priority_queue_engine_t engines[] = {PRIORITY_QUEUE_SORTED_LIST, PRIORITY_QUEUE_BINARY_HEAP, PRIORITY_QUEUE_DARY_HEAP};
+	priority_queue_t *queue = NULL;
+	int status = 0;
+	void *result = NULL;
+
+	for(i = 0; i < 5; ++i)
+	{
+		ints_data[i] = &ints[i];
+		doubles_data[i] = &doubles[i];
+	}
+
+	/* Extremes order correctly where a difference would wrap */
+	assert(1 == PriorityQueueCompareSize(sizes[0], sizes[3]));
+	assert(-1 == PriorityQueueCompareSize(sizes[3], sizes[1]));
+	assert(1 == PriorityQueueCompareLong(longs[0], longs[3]));
+	assert(-1 == PriorityQueueCompareLong(longs[2], longs[1]));
+	assert(1 == PriorityQueueCompareInt(ints_data[0], ints_data[4]));
+	assert(-1 == PriorityQueueCompareInt(ints_data[4], ints_data[0]));
+	assert(0 == PriorityQueueCompareDouble(doubles_data[1], doubles_data[2]));
+	assert(1 == PriorityQueueCompareDouble(doubles_data[2], doubles_data[3]));
+
+	assert(0 == PriorityQueueCheckCompare(PriorityQueueCompareSize, sizes, 4));
+	assert(0 == PriorityQueueCheckCompare(PriorityQueueCompareLong, longs, 4));
+	assert(0 == PriorityQueueCheckCompare(PriorityQueueCompareInt, ints_data, 5));
+	assert(0 == PriorityQueueCheckCompare(PriorityQueueCompareDouble, doubles_data, 5));
+	assert(0 == PriorityQueueCheckCompare(Subtract, sizes, 2));
+	assert(0 < PriorityQueueCheckCompare(Subtract, sizes, 4));
+	assert(0 == PriorityQueueCheckCompare(Subtract, NULL, 0));
+
+	/* The engines that compare dequeue the full range of int from the largest */
+	for(engine = 0; engine < sizeof(engines) / sizeof(engines[0]); ++engine)
+	{
+		queue = PriorityQueueCreateEngine(PriorityQueueCompareInt, engines[engine]);
+		assert(queue && "Creation failed");
+		for(i = 0; i < 5; ++i)
+		{
+			status = PriorityQueueEnqueue(queue, ints_data[(i * 3) % 5]);
+			assert(PRIORITY_QUEUE_SUCCESS == status);
+		}
+
+		for(i = 5; 0 < i; --i)
+		{
+			result = PriorityQueueDequeue(queue);
+			assert(ints_data[i - 1] == result);
+		}
+
+		PriorityQueueDestroy(queue);
+	}
+
+	(void)doubles_data;
+	(void)sizes;
+	(void)longs;
+	(void)status;
+	(void)result;
+}
+/*****************************************************************************/
+void PriorityQueueSelectorTest(void)
+{
+	size_t i = 0;
+	size_t j = 0;
+	size_t seed = 12345;
+	size_t best = 0;
+	void *data = NULL;
+	priority_queue_t *queues[16];
+	priority_queue_t *selected = NULL;
+	priority_queue_handle_t handle = NULL;
+	int status = 0;
+	priority_queue_selector_t *selector = PriorityQueueSelectorCreate(Cmp);
+	assert(selector && "Creation failed");
+	assert(NULL == PriorityQueueSelectorPeek(selector));
+
+	for(i = 0; i < 16; ++i)
+	{
+		queues[i] = PriorityQueueCreateEngine(Cmp, (priority_queue_engine_t)(i % 2));
+		assert(queues[i] && "Creation failed");
+		status = PriorityQueueSelectorAdd(selector, queues[i]);
+		assert(PRIORITY_QUEUE_SUCCESS == status);
+	}
+
+	assert(NULL == PriorityQueueSelectorPeek(selector));
+
+	/* Random traffic, the selected head is always the best of all heads */
+	for(i = 0; i < 4000; ++i)
+	{
+		seed = seed * 1103515245 + 12345;
+		j = (seed >> 8) % 16;
+		if(0 == (seed >> 16) % 3)
+		{
+			PriorityQueueDequeue(queues[j]);
+		}
+		else
+		{
+			status = PriorityQueueEnqueue(queues[j], (void *)((seed >> 12) % 1000 + 1));
+			assert(PRIORITY_QUEUE_SUCCESS == status);
+		}
+
+		for(best = 0, j = 0; j < 16; ++j)
+		{
+			if(!PriorityQueueIsEmpty(queues[j]) && (size_t)PriorityQueuePeek(queues[j]) > best)
+			{
+				best = (size_t)PriorityQueuePeek(queues[j]);
+			}
+		}
+
+		selected = PriorityQueueSelectorPeek(selector);
+		assert(0 == best ? NULL == selected : best == (size_t)PriorityQueuePeek(selected));
+	}
+
+	/* Heads changed by handles, merges, clears and removals are followed */
+	handle = PriorityQueueEnqueueHandle(queues[1], (void *)5000);
+	assert(queues[1] == PriorityQueueSelectorPeek(selector));
+	PriorityQueueUpdateHandle(queues[1], handle, (void *)1);
+	assert(queues[1] != PriorityQueueSelectorPeek(selector));
+	status = PriorityQueueEnqueue(queues[2], (void *)6000);
+	assert(PRIORITY_QUEUE_SUCCESS == status);
+	status = PriorityQueueMerge(queues[4], queues[2]);
+	assert(0 == status);
+	assert(queues[4] == PriorityQueueSelectorPeek(selector));
+	PriorityQueueClear(queues[4]);
+	assert(queues[4] != PriorityQueueSelectorPeek(selector));
+	status = PriorityQueueEnqueue(queues[6], (void *)7000);
+	assert(PRIORITY_QUEUE_SUCCESS == status);
+	PriorityQueueSelectorRemove(selector, queues[6]);
+	PriorityQueueSelectorRemove(selector, queues[6]);
+	assert(queues[6] != PriorityQueueSelectorPeek(selector));
+	status = PriorityQueueSelectorAdd(selector, queues[6]);
+	assert(PRIORITY_QUEUE_SUCCESS == status);
+	assert(queues[6] == PriorityQueueSelectorPeek(selector));
+
+	/* A destroyed queue leaves the selector, draining the rest empties it */
+	PriorityQueueDestroy(queues[6]);
+	for(i = 0; i < 16; ++i)
+	{
+		if(6 != i)
+		{
+			PriorityQueueClear(queues[i]);
+		}
+	}
+
+	assert(NULL == PriorityQueueSelectorPeek(selector));
+	status = PriorityQueueEnqueue(queues[3], NULL);
+	assert(PRIORITY_QUEUE_SUCCESS == status);
+	assert(queues[3] == PriorityQueueSelectorPeek(selector));
+	status = PriorityQueueDequeueInto(queues[3], &data);
+	assert(PRIORITY_QUEUE_SUCCESS == status);
+	assert(NULL == data);
+
+	/* The queues outlive the selector */
+	PriorityQueueSelectorDestroy(selector);
+	status = PriorityQueueEnqueue(queues[0], (void *)1);
+	assert(PRIORITY_QUEUE_SUCCESS == status);
+	for(i = 0; i < 16; ++i)
+	{
+		if(6 != i)
+		{
+			PriorityQueueDestroy(queues[i]);
+		}
+	}
+
+	(void)data;
+	(void)selected;
+	(void)status;
+}
+/*****************************************************************************/
+void PriorityQueueCompareBatchTest(void)
+{
+	size_t i = 0;
+	size_t engine = 0;
+	size_t seed = 777;
+	long fail = 0;
+	void *data = NULL;
+	void *last = NULL;
+	void *batch[1000];
+	priority_queue_status_t statuses[1000];
+	priority_queue_stats_t stats;
+	priority_queue_handle_t handle = NULL;
+	priority_queue_t *queue = PriorityQueueCreate(Cmp);
+	size_t count = 0;
+	int status = 0;
+	void *result = NULL;
+	assert(queue && "Creation failed");
+
+	/* The sorted list has no sift to batch */
+	status = PriorityQueueSetCompareBatch(queue, CmpBatch);
+	assert(0 != status);
+	PriorityQueueDestroy(queue);
+
+	for(i = 0; i < 1000; ++i)
+	{
+		seed = seed * 1103515245 + 12345;
+		batch[i] = (void *)((seed >> 8) % 5000 + 1);
+	}
+
+	for(engine = PRIORITY_QUEUE_BINARY_HEAP; engine <= PRIORITY_QUEUE_DARY_HEAP; ++engine)
+	{
+		queue = PriorityQueueCreateEngine(Cmp, (priority_queue_engine_t)engine);
+		assert(queue && "Creation failed");
+		status = PriorityQueueSetCompareBatch(queue, CmpBatch);
+#ifdef PRIORITY_QUEUE_SOJOURN
+		assert(0 != status);
+#else
+		assert(0 == status);
+#endif
+
+		/* A large batch is built bottom up, a small one sifted up */
+		compare_batch_calls = 0;
+		count = PriorityQueueEnqueueBatch(queue, batch, 1000, statuses);
+		assert(1000 == count);
+		assert(PRIORITY_QUEUE_SUCCESS == statuses[0] && PRIORITY_QUEUE_SUCCESS == statuses[999]);
+		count = PriorityQueueEnqueueBatch(queue, batch, 10, NULL);
+		assert(10 == count);
+		handle = PriorityQueueEnqueueHandle(queue, (void *)1);
+		assert(handle);
+		PriorityQueueUpdateHandle(queue, handle, (void *)9999);
+		assert(1011 == PriorityQueueSize(queue));
+
+		PriorityQueueStats(queue, &stats);
+		assert(1011 == stats.insert_comparisons.samples);
+
+		result = PriorityQueueDequeue(queue);
+		assert((void *)9999 == result);
+		for(last = (void *)9999; !PriorityQueueIsEmpty(queue); last = data)
+		{
+			data = PriorityQueueDequeue(queue);
+			assert((size_t)data <= (size_t)last);
+		}
+
+		/* The sifts went through the batch compare function */
+#ifdef PRIORITY_QUEUE_SOJOURN
+		assert(0 == compare_batch_calls);
+#else
+		assert(0 < compare_batch_calls);
+#endif
+
+		/* Removing the batch compare function goes back to one by one */
+		(void)PriorityQueueSetCompareBatch(queue, NULL);
+		compare_batch_calls = 0;
+		count = PriorityQueueEnqueueBatch(queue, batch, 100, NULL);
+		assert(100 == count);
+		for(last = (void *)9999; !PriorityQueueIsEmpty(queue); last = data)
+		{
+			data = PriorityQueueDequeue(queue);
+			assert((size_t)data <= (size_t)last);
+		}
+
+		assert(0 == compare_batch_calls);
+
+#if defined(PRIORITY_QUEUE_TEST_OOM) && !defined(PRIORITY_QUEUE_SOJOURN)
+		/* A batch that can't grow storage falls back to one by one */
+		for(fail = 0; fail < 4; ++fail)
+		{
+			oom_countdown = fail;
+			count = PriorityQueueEnqueueBatch(queue, batch, 1000, NULL);
+			assert(1000 == count);
+			oom_countdown = -1;
+			for(last = (void *)9999; !PriorityQueueIsEmpty(queue); last = data)
+			{
+				data = PriorityQueueDequeue(queue);
+				assert((size_t)data <= (size_t)last);
+			}
+		}
+#endif
+		(void)fail;
+		PriorityQueueDestroy(queue);
+	}
+
+	(void)last;
+	(void)count;
+	(void)status;
+	(void)result;
+}
+/*****************************************************************************/
+void PriorityQueueVebTest(void)
+{
+	size_t i = 0;
+	size_t j = 0;
+	size_t op = 0;
+	size_t best = 0;
+	size_t count = 0;
+	size_t seed = 99;
+	size_t dropped = 0;
+	size_t value = 0;
+	size_t mask = 0;
+	long fail = 0;
+	int status = 0;
+	void *data = NULL;
+	void *result = NULL;
+	size_t reference[512];
+	static const unsigned int widths[] = {1, 5, 6, 7, 13, 20, 32};
+	priority_queue_memory_t usage;
+	priority_queue_t *queue = NULL;
+	priority_queue_t *other = NULL;
+
+	/* Without a key function there is no order */
+	queue = PriorityQueueCreateEngine(Cmp, PRIORITY_QUEUE_VEB);
+	assert(NULL == queue);
+
+	/* Smallest key first, equal keys in the order they came */
+	queue = PriorityQueueCreateKeyed(Key, 28);
+	assert(queue && "Creation failed");
+	for(i = 0; i < 16; ++i)
+	{
+		status = PriorityQueueEnqueue(queue, (void *)(((i % 4) * 1000 + 7) << 4 | i));
+		assert(0 == status);
+	}
+
+	result = PriorityQueueEnqueueHandle(queue, (void *)(7 << 4));
+	assert(NULL == result);
+	assert((void *)(7 << 4) == PriorityQueuePeek(queue));
+	assert(PRIORITY_QUEUE_SUCCESS == PriorityQueueFindNext(queue, 0, &data) && (void *)(7 << 4) == data);
+	assert(PRIORITY_QUEUE_SUCCESS == PriorityQueueFindNext(queue, 8, &data) && (void *)(1007 << 4 | 1) == data);
+	assert(PRIORITY_QUEUE_SUCCESS == PriorityQueueFindNext(queue, 3007, &data) && (void *)(3007 << 4 | 3) == data);
+	assert(PRIORITY_QUEUE_NOT_FOUND == PriorityQueueFindNext(queue, 3008, &data));
+	assert(PRIORITY_QUEUE_NOT_FOUND == PriorityQueueFindPrev(queue, 6, &data));
+	assert(PRIORITY_QUEUE_SUCCESS == PriorityQueueFindPrev(queue, 2006, &data) && (void *)(1007 << 4 | 1) == data);
+	assert(PRIORITY_QUEUE_SUCCESS == PriorityQueueFindPrev(queue, (1UL << 28) - 1, &data) && (void *)(3007 << 4 | 3) == data);
+
+	result = PriorityQueueErase(queue, Match, (void *)(1007 << 4 | 5));
+	assert((void *)(1007 << 4 | 5) == result);
+	result = PriorityQueueErase(queue, Match, (void *)(1007 << 4 | 5));
+	assert(queue == result);
+	assert(15 == PriorityQueueSize(queue));
+	PriorityQueueMemoryUsage(queue, &usage);
+	assert(0 < usage.nodes && 0 < usage.index);
+
+	for(i = 0; i < 4; ++i)
+	{
+		for(j = 0; j < 4; ++j)
+		{
+			if(1 == i && 1 == j)
+			{
+				continue;
+			}
+
+			result = PriorityQueueDequeue(queue);
+			assert((void *)((i * 1000 + 7) << 4 | (j * 4 + i)) == result);
+		}
+	}
+
+	assert(PriorityQueueIsEmpty(queue));
+	PriorityQueueDestroy(queue);
+
+	/* Random keys across widths, against a plain array */
+	for(i = 0; i < sizeof(widths) / sizeof(widths[0]); ++i)
+	{
+		mask = 32 == widths[i] ? 0xFFFFFFFFUL : (1UL << widths[i]) - 1;
+		queue = PriorityQueueCreateKeyed(Identity, widths[i]);
+		assert(queue && "Creation failed");
+		for(count = 0, op = 0; op < 4000; ++op)
+		{
+			seed = seed * 1103515245 + 12345;
+			value = (seed >> 3) & mask;
+			if(count < 512 && (0 == count || 0 != seed % 3))
+			{
+				reference[count++] = value;
+				status = PriorityQueueEnqueue(queue, (void *)value);
+				assert(0 == status);
+			}
+			else
+			{
+				for(best = 0, j = 1; j < count; ++j)
+				{
+					best = reference[j] < reference[best] ? j : best;
+				}
+
+				result = PriorityQueueDequeue(queue);
+				assert((void *)reference[best] == result);
+				reference[best] = reference[--count];
+			}
+
+			/* The next key not below value and the last not above it */
+			for(best = mask + 1, j = 0; j < count; ++j)
+			{
+				best = reference[j] >= value && (best > mask || reference[j] < best) ? reference[j] : best;
+			}
+
+			status = PriorityQueueFindNext(queue, value, &data);
+			assert(best > mask ? PRIORITY_QUEUE_NOT_FOUND == status : (void *)best == data);
+			for(best = mask + 1, j = 0; j < count; ++j)
+			{
+				best = reference[j] <= value && (best > mask || reference[j] > best) ? reference[j] : best;
+			}
+
+			status = PriorityQueueFindPrev(queue, value, &data);
+			assert(best > mask ? PRIORITY_QUEUE_NOT_FOUND == status : (void *)best == data);
+			assert(count == PriorityQueueSize(queue));
+		}
+
+		PriorityQueueClear(queue);
+		assert(PriorityQueueIsEmpty(queue));
+		PriorityQueueMemoryUsage(queue, &usage);
+		assert(0 == usage.nodes);
+		PriorityQueueDestroy(queue);
+	}
+
+	/* A full queue evicts its largest key for a smaller one */
+	queue = PriorityQueueCreateKeyed(Identity, 32);
+	assert(queue && "Creation failed");
+	status = PriorityQueueSetCapacity(queue, 3, PRIORITY_QUEUE_EVICT_LOWEST, CountDrop, &dropped);
+	assert(0 == status);
+	status = PriorityQueueEnqueue(queue, (void *)5);
+	assert(0 == status);
+	status = PriorityQueueEnqueue(queue, (void *)70000);
+	assert(0 == status);
+	status = PriorityQueueEnqueue(queue, (void *)4000000000UL);
+	assert(0 == status);
+	status = PriorityQueueEnqueue(queue, (void *)6);
+	assert(0 == status);
+	status = PriorityQueueEnqueue(queue, (void *)80000);
+	assert(PRIORITY_QUEUE_FULL == status);
+	assert(1 == dropped);
+	assert(PRIORITY_QUEUE_SUCCESS == PriorityQueueFindPrev(queue, 0xFFFFFFFFUL, &data) && (void *)70000 == data);
+	status = PriorityQueueSetCapacity(queue, 0, PRIORITY_QUEUE_REJECT, NULL, NULL);
+	assert(0 == status);
+
+	/* Merges go key by key, with heaps or other keyed queues */
+	other = PriorityQueueCreateEngine(Cmp, PRIORITY_QUEUE_BINARY_HEAP);
+	assert(other && "Creation failed");
+	status = PriorityQueueEnqueue(other, (void *)3);
+	assert(0 == status);
+	status = PriorityQueueEnqueue(other, (void *)90000);
+	assert(0 == status);
+	status = PriorityQueueMerge(queue, other);
+	assert(0 == status);
+	assert(PriorityQueueIsEmpty(other));
+	PriorityQueueDestroy(other);
+	other = PriorityQueueCreateKeyed(Identity, 20);
+	assert(other && "Creation failed");
+	status = PriorityQueueEnqueue(other, (void *)4);
+	assert(0 == status);
+	status = PriorityQueueMerge(queue, other);
+	assert(0 == status);
+	status = PriorityQueueMerge(other, queue);
+	assert(0 == status);
+	assert(6 == PriorityQueueSize(other));
+	result = PriorityQueueDequeue(other);
+	assert((void *)3 == result);
+	result = PriorityQueueDequeue(other);
+	assert((void *)4 == result);
+	result = PriorityQueueDequeue(other);
+	assert((void *)5 == result);
+	result = PriorityQueueDequeue(other);
+	assert((void *)6 == result);
+	result = PriorityQueueDequeue(other);
+	assert((void *)70000 == result);
+	result = PriorityQueueDequeue(other);
+	assert((void *)90000 == result);
+	PriorityQueueDestroy(other);
+
+#ifdef PRIORITY_QUEUE_TEST_OOM
+	/* A creation failing at any allocation frees what it had */
+	for(fail = 0; fail < 4; ++fail)
+	{
+		oom_countdown = fail;
+		other = PriorityQueueCreateKeyed(Identity, 32);
+		oom_countdown = -1;
+		if(NULL != other)
+		{
+			PriorityQueueDestroy(other);
+		}
+	}
+
+	/* A new key failing at any of its allocations leaves the tree intact */
+	for(count = 0, i = 1; i <= 300; ++i)
+	{
+		oom_countdown = (long)(i % 5) - 1;
+		status = PriorityQueueEnqueue(queue, (void *)((i * 2654435761UL) & 0xFFFFFFFFUL));
+		oom_countdown = -1;
+		assert(0 == status || PRIORITY_QUEUE_NO_MEMORY == status);
+		count += (0 == status);
+		assert(count == PriorityQueueSize(queue));
+	}
+
+	/* A node failing to shrink back to a sorted array stays as it is */
+	for(value = (size_t)-1; 16 < count; value = (size_t)data, --count)
+	{
+		oom_countdown = (long)(count % 3) - 1;
+		status = PriorityQueueDequeueLast(queue, &data);
+		oom_countdown = -1;
+		assert(0 == status);
+		assert((size_t)data <= value);
+	}
+
+	for(value = 0; !PriorityQueueIsEmpty(queue); value = (size_t)data, --count)
+	{
+		data = PriorityQueueDequeue(queue);
+		assert((size_t)data >= value);
+	}
+
+	assert(0 == count);
+#endif
+	(void)fail;
+	PriorityQueueDestroy(queue);
+	(void)dropped;
+	(void)status;
+	(void)result;
+}
+/*****************************************************************************/
+void PriorityQueueBucketsTest(void)
+{
+	size_t i = 0;
+	size_t j = 0;
+	size_t op = 0;
+	size_t best = 0;
+	size_t count = 0;
+	size_t seed = 7;
+	size_t dropped = 0;
+	size_t value = 0;
+	long fail = 0;
+	int status = 0;
+	void *data = NULL;
+	void *result = NULL;
+	size_t reference[512];
+	static const unsigned long levels[] = {1, 63, 64, 65, 4096, 4097, 65536};
+	static const priority_queue_engine_t engines[] = {PRIORITY_QUEUE_SORTED_LIST, PRIORITY_QUEUE_BINARY_HEAP, PRIORITY_QUEUE_DARY_HEAP};
+	priority_queue_memory_t usage;
+	priority_queue_t *queue = NULL;
+	priority_queue_t *other = NULL;
+
+	/* Without a key function there is no order */
+	queue = PriorityQueueCreateEngine(Cmp, PRIORITY_QUEUE_BUCKETS);
+	assert(NULL == queue);
+
+	/* Smallest level first, equal levels in the order they came */
+	queue = PriorityQueueCreateBuckets(Key, 4096);
+	assert(queue && "Creation failed");
+	for(i = 0; i < 16; ++i)
+	{
+		status = PriorityQueueEnqueue(queue, (void *)(((i % 4) * 1000 + 7) << 4 | i));
+		assert(0 == status);
+	}
+
+	result = PriorityQueueEnqueueHandle(queue, (void *)(7 << 4));
+	assert(NULL == result);
+	assert((void *)(7 << 4) == PriorityQueuePeek(queue));
+	assert(PRIORITY_QUEUE_SUCCESS == PriorityQueueFindNext(queue, 0, &data) && (void *)(7 << 4) == data);
+	assert(PRIORITY_QUEUE_SUCCESS == PriorityQueueFindNext(queue, 8, &data) && (void *)(1007 << 4 | 1) == data);
+	assert(PRIORITY_QUEUE_NOT_FOUND == PriorityQueueFindNext(queue, 3008, &data));
+	assert(PRIORITY_QUEUE_NOT_FOUND == PriorityQueueFindNext(queue, 1UL << 20, &data));
+	assert(PRIORITY_QUEUE_NOT_FOUND == PriorityQueueFindPrev(queue, 6, &data));
+	assert(PRIORITY_QUEUE_SUCCESS == PriorityQueueFindPrev(queue, 2006, &data) && (void *)(1007 << 4 | 1) == data);
+	assert(PRIORITY_QUEUE_SUCCESS == PriorityQueueFindPrev(queue, 1UL << 20, &data) && (void *)(3007 << 4 | 3) == data);
+
+	/* The last element is the newest of the largest level */
+	status = PriorityQueueDequeueLast(queue, &data);
+	assert(PRIORITY_QUEUE_SUCCESS == status && (void *)(3007 << 4 | 15) == data);
+	status = PriorityQueueDequeueLast(queue, &data);
+	assert(PRIORITY_QUEUE_SUCCESS == status && (void *)(3007 << 4 | 11) == data);
+	result = PriorityQueueErase(queue, Match, (void *)(1007 << 4 | 5));
+	assert((void *)(1007 << 4 | 5) == result);
+	result = PriorityQueueErase(queue, Match, (void *)(1007 << 4 | 5));
+	assert(queue == result);
+	assert(13 == PriorityQueueSize(queue));
+	PriorityQueueMemoryUsage(queue, &usage);
+	assert(0 < usage.nodes && 0 < usage.index);
+
+	for(i = 0; i < 4; ++i)
+	{
+		for(j = 0; j < 4; ++j)
+		{
+			if((1 == i && 1 == j) || (3 == i && 2 <= j))
+			{
+				continue;
+			}
+
+			result = PriorityQueueDequeue(queue);
+			assert((void *)((i * 1000 + 7) << 4 | (j * 4 + i)) == result);
+		}
+	}
+
+	assert(PriorityQueueIsEmpty(queue));
+	status = PriorityQueueDequeueLast(queue, &data);
+	assert(PRIORITY_QUEUE_EMPTY == status);
+	PriorityQueueDestroy(queue);
+
+	/* Random levels taken from both ends, against a plain array */
+	for(i = 0; i < sizeof(levels) / sizeof(levels[0]); ++i)
+	{
+		queue = PriorityQueueCreateBuckets(Identity, levels[i]);
+		assert(queue && "Creation failed");
+		for(count = 0, op = 0; op < 4000; ++op)
+		{
+			seed = seed * 1103515245 + 12345;
+			value = (seed >> 3) % levels[i];
+			if(count < 512 && (0 == count || 0 != seed % 3))
+			{
+				reference[count++] = value;
+				status = PriorityQueueEnqueue(queue, (void *)value);
+				assert(0 == status);
+			}
+			else if(0 == (seed >> 9) % 2)
+			{
+				for(best = 0, j = 1; j < count; ++j)
+				{
+					best = reference[j] < reference[best] ? j : best;
+				}
+
+				result = PriorityQueueDequeue(queue);
+				assert((void *)reference[best] == result);
+				reference[best] = reference[--count];
+			}
+			else
+			{
+				for(best = 0, j = 1; j < count; ++j)
+				{
+					best = reference[j] > reference[best] ? j : best;
+				}
+
+				status = PriorityQueueDequeueLast(queue, &data);
+				assert(PRIORITY_QUEUE_SUCCESS == status);
+				assert((void *)reference[best] == data);
+				reference[best] = reference[--count];
+			}
+
+			/* The next level not below value and the last not above it */
+			for(best = levels[i], j = 0; j < count; ++j)
+			{
+				best = reference[j] >= value && (best == levels[i] || reference[j] < best) ? reference[j] : best;
+			}
+
+			status = PriorityQueueFindNext(queue, value, &data);
+			assert(best == levels[i] ? PRIORITY_QUEUE_NOT_FOUND == status : (void *)best == data);
+			for(best = levels[i], j = 0; j < count; ++j)
+			{
+				best = reference[j] <= value && (best == levels[i] || reference[j] > best) ? reference[j] : best;
+			}
+
+			status = PriorityQueueFindPrev(queue, value, &data);
+			assert(best == levels[i] ? PRIORITY_QUEUE_NOT_FOUND == status : (void *)best == data);
+			assert(count == PriorityQueueSize(queue));
+		}
+
+		PriorityQueueClear(queue);
+		assert(PriorityQueueIsEmpty(queue));
+		PriorityQueueMemoryUsage(queue, &usage);
+		assert(0 == usage.nodes);
+		PriorityQueueDestroy(queue);
+	}
+
+	/* The other engines give up their lowest element too */
+	for(i = 0; i < sizeof(engines) / sizeof(engines[0]); ++i)
+	{
+		other = PriorityQueueCreateEngine(Cmp, engines[i]);
+		assert(other && "Creation failed");
+		status = PriorityQueueEnqueue(other, (void *)5);
+		assert(0 == status);
+		status = PriorityQueueEnqueue(other, (void *)1);
+		assert(0 == status);
+		status = PriorityQueueEnqueue(other, (void *)9);
+		assert(0 == status);
+		status = PriorityQueueEnqueue(other, (void *)3);
+		assert(0 == status);
+		status = PriorityQueueDequeueLast(other, &data);
+		assert(PRIORITY_QUEUE_SUCCESS == status && (void *)1 == data);
+		status = PriorityQueueDequeueLast(other, &data);
+		assert(PRIORITY_QUEUE_SUCCESS == status && (void *)3 == data);
+		result = PriorityQueueDequeue(other);
+		assert((void *)9 == result);
+		status = PriorityQueueDequeueLast(other, &data);
+		assert(PRIORITY_QUEUE_SUCCESS == status && (void *)5 == data);
+		status = PriorityQueueDequeueLast(other, &data);
+		assert(PRIORITY_QUEUE_EMPTY == status);
+		PriorityQueueDestroy(other);
+	}
+
+	/* A full queue evicts the newest element of its largest level */
+	queue = PriorityQueueCreateBuckets(Identity, 100);
+	assert(queue && "Creation failed");
+	status = PriorityQueueSetCapacity(queue, 3, PRIORITY_QUEUE_EVICT_LOWEST, CountDrop, &dropped);
+	assert(0 == status);
+	status = PriorityQueueEnqueue(queue, (void *)5);
+	assert(0 == status);
+	status = PriorityQueueEnqueue(queue, (void *)50);
+	assert(0 == status);
+	status = PriorityQueueEnqueue(queue, (void *)99);
+	assert(0 == status);
+	status = PriorityQueueEnqueue(queue, (void *)6);
+	assert(0 == status);
+	status = PriorityQueueEnqueue(queue, (void *)80);
+	assert(PRIORITY_QUEUE_FULL == status);
+	assert(1 == dropped);
+	assert(PRIORITY_QUEUE_SUCCESS == PriorityQueueFindPrev(queue, 99, &data) && (void *)50 == data);
+	status = PriorityQueueSetCapacity(queue, 0, PRIORITY_QUEUE_REJECT, NULL, NULL);
+	assert(0 == status);
+
+	/* Merges go element by element, with the vEB as with any engine */
+	other = PriorityQueueCreateKeyed(Identity, 16);
+	assert(other && "Creation failed");
+	status = PriorityQueueEnqueue(other, (void *)4);
+	assert(0 == status);
+	status = PriorityQueueEnqueue(other, (void *)70);
+	assert(0 == status);
+	status = PriorityQueueMerge(queue, other);
+	assert(0 == status);
+	assert(PriorityQueueIsEmpty(other));
+	status = PriorityQueueMerge(other, queue);
+	assert(0 == status);
+	assert(PriorityQueueIsEmpty(queue));
+	assert(5 == PriorityQueueSize(other));
+	result = PriorityQueueDequeue(other);
+	assert((void *)4 == result);
+	result = PriorityQueueDequeue(other);
+	assert((void *)5 == result);
+	result = PriorityQueueDequeue(other);
+	assert((void *)6 == result);
+	result = PriorityQueueDequeue(other);
+	assert((void *)50 == result);
+	result = PriorityQueueDequeue(other);
+	assert((void *)70 == result);
+	PriorityQueueDestroy(other);
+
+#ifdef PRIORITY_QUEUE_TEST_OOM
+	/* A creation failing at any allocation frees what it had */
+	for(fail = 0; fail < 4; ++fail)
+	{
+		oom_countdown = fail;
+		other = PriorityQueueCreateBuckets(Identity, PRIORITY_QUEUE_MAX_LEVELS);
+		oom_countdown = -1;
+		if(NULL != other)
+		{
+			PriorityQueueDestroy(other);
+		}
+	}
+
+	/* An enqueue failing to grow the pool leaves the queue intact */
+	for(count = 0, i = 1; i <= 300; ++i)
+	{
+		oom_countdown = (long)(i % 3) - 1;
+		status = PriorityQueueEnqueue(queue, (void *)((i * 7919) % 100));
+		oom_countdown = -1;
+		assert(0 == status || PRIORITY_QUEUE_NO_MEMORY == status);
+		count += (0 == status);
+		assert(count == PriorityQueueSize(queue));
+	}
+
+	for(value = 0; !PriorityQueueIsEmpty(queue); value = (size_t)data, --count)
+	{
+		data = PriorityQueueDequeue(queue);
+		assert((size_t)data >= value);
+	}
+
+	assert(0 == count);
+#endif
+	(void)fail;
+	PriorityQueueDestroy(queue);
+	(void)dropped;
+	(void)status;
+	(void)result;
+}
+/*****************************************************************************/
+void PriorityQueueKeyedBatchTest(void)
+{
+	size_t i = 0;
+	size_t k = 0;
+	size_t seed = 31;
+	size_t count = 0;
+	size_t last = 0;
+	long fail = 0;
+	void *data = NULL;
+	int status = 0;
+	static void *batch[300000];
+	priority_queue_stats_t stats;
+	priority_queue_t *queue = NULL;
+
+	/* Large enough for the keys to be radix sorted */
+	for(i = 0; i < 300000; ++i)
+	{
+		seed = seed * 1103515245 + 12345;
+		batch[i] = (void *)((((seed >> 8) % 4000 + 5) << 20) | (i + 1));
+	}
+
+	for(k = 0; k < 2; ++k)
+	{
+		queue = 0 == k ? PriorityQueueCreateKeyed(BatchKey, 12) : PriorityQueueCreateBuckets(BatchKey, 4096);
+		assert(queue && "Creation failed");
+
+		/* Queued elements stay ahead of the batch elements of their key */
+		status = PriorityQueueEnqueue(queue, (void *)(5UL << 20));
+		assert(0 == status);
+		count = PriorityQueueEnqueueBatch(queue, batch, 10, NULL);
+		assert(10 == count);
+		count = PriorityQueueEnqueueBatch(queue, batch + 10, 299990, NULL);
+		assert(299990 == count);
+		assert(300001 == PriorityQueueSize(queue));
+		PriorityQueueStats(queue, &stats);
+		assert(300001 == stats.insert_comparisons.samples);
+		assert((void *)(5UL << 20) == PriorityQueuePeek(queue));
+
+		/* Equal keys leave in the order of the batch */
+		for(last = 0; !PriorityQueueIsEmpty(queue); last = (size_t)data)
+		{
+			data = PriorityQueueDequeue(queue);
+			assert((size_t)data > last);
+		}
+
+		/* A batch beyond the capacity goes one by one */
+		status = PriorityQueueSetCapacity(queue, 100, PRIORITY_QUEUE_REJECT, NULL, NULL);
+		assert(0 == status);
+		count = PriorityQueueEnqueueBatch(queue, batch, 200, NULL);
+		assert(100 == count);
+		status = PriorityQueueSetCapacity(queue, 0, PRIORITY_QUEUE_REJECT, NULL, NULL);
+		assert(0 == status);
+		PriorityQueueClear(queue);
+
+#if defined(PRIORITY_QUEUE_TEST_OOM) && !defined(PRIORITY_QUEUE_SOJOURN)
+		/* A batch failing anywhere, the vEB halfway through, leaves nothing
+		   behind and goes one by one */
+		for(fail = 0; fail < 16; ++fail)
+		{
+			oom_countdown = fail;
+			count = PriorityQueueEnqueueBatch(queue, batch, 5000, NULL);
+			oom_countdown = -1;
+			assert(5000 == count);
+			assert(5000 == PriorityQueueSize(queue));
+			for(last = 0; !PriorityQueueIsEmpty(queue); last = (size_t)data)
+			{
+				data = PriorityQueueDequeue(queue);
+				assert((size_t)data > last);
+			}
+		}
+#endif
+		(void)fail;
+		(void)count;
+		PriorityQueueDestroy(queue);
+	}
+
+	(void)last;
+	(void)status;
+}
+/*****************************************************************************/
+void ShmPriorityQueueTest(void)
+{
+	long i = 0;
+	const char *name = "/priority_queue_test";
+	shm_priority_queue_entry_t entry = {0, 0};
+	shm_priority_queue_t *producer = NULL;
+	shm_priority_queue_t *consumer = NULL;
+	int status = 0;
+
+	ShmPriorityQueueUnlink(name);
+	producer = ShmPriorityQueueCreate(name, 100);
+	assert(producer && "Creation failed");
+	consumer = ShmPriorityQueueCreate(name, 100);
+	assert(NULL == consumer);
+
+	/* A second mapping of the same segment lands at another address */
+	consumer = ShmPriorityQueueOpen(name);
+	assert(consumer && "Open failed");
+	assert(100 == ShmPriorityQueueCapacity(consumer));
+	status = ShmPriorityQueueDequeue(consumer, &entry);
+	assert(SHM_PRIORITY_QUEUE_EMPTY == status);
+	assert(SHM_PRIORITY_QUEUE_EMPTY == ShmPriorityQueuePeek(consumer, &entry));
+
+	for(i = 0; i < 100; ++i)
+	{
+		status = ShmPriorityQueueEnqueue(producer, (i * 37) % 100, (ref_queue_offset_t)i);
+		assert(SHM_PRIORITY_QUEUE_SUCCESS == status);
+	}
+
+	status = ShmPriorityQueueEnqueue(producer, 1000, 0);
+	assert(SHM_PRIORITY_QUEUE_FULL == status);
+
+	/* Waiting for room gives up at the deadline */
+	status = ShmPriorityQueueEnqueueTimed(producer, 1000, 0, 0);
+	assert(SHM_PRIORITY_QUEUE_FULL == status);
+	status = ShmPriorityQueueEnqueueTimed(producer, 1000, 0, 2000);
+	assert(SHM_PRIORITY_QUEUE_FULL == status);
+	assert(100 == ShmPriorityQueueSize(consumer));
+	assert(SHM_PRIORITY_QUEUE_SUCCESS == ShmPriorityQueuePeek(consumer, &entry));
+	assert(99 == entry.key);
+
+	for(i = 99; i >= 0; --i)
+	{
+		status = ShmPriorityQueueDequeue(consumer, &entry);
+		assert(SHM_PRIORITY_QUEUE_SUCCESS == status);
+		assert(i == entry.key);
+		assert((ref_queue_offset_t)((i * 73) % 100) == entry.offset);
+	}
+
+	status = ShmPriorityQueueEnqueueTimed(producer, 7, 7, 1000);
+	assert(SHM_PRIORITY_QUEUE_SUCCESS == status);
+	status = ShmPriorityQueueDequeue(consumer, &entry);
+	assert(SHM_PRIORITY_QUEUE_SUCCESS == status);
+	assert(7 == entry.key);
+	assert(0 == ShmPriorityQueueSize(producer));
+	ShmPriorityQueueClose(producer);
+	ShmPriorityQueueClose(consumer);
+	status = ShmPriorityQueueUnlink(name);
+	assert(0 == status);
+	consumer = ShmPriorityQueueOpen(name);
+	assert(NULL == consumer);
+	(void)entry;
+	(void)status;
+}
+/*****************************************************************************/
+void RefQueueTest(void)
+{
+	size_t i = 0;
+	char payloads[64][8] = {{0}};
+	ref_queue_ref_t ref = {0, 0};
+	ref_queue_t *queue = NULL;
+	int status = 0;
+	assert(NULL == queue && "Creation failed");
+	queue = RefQueueCreate();
+	assert(queue && "Creation failed");
+	assert(1 == RefQueueIsEmpty(queue));
+	status = RefQueueDequeue(queue, &ref);
+	assert(0 != status);
+	assert(0 != RefQueuePeek(queue, &ref));
+
+	/* Payloads stay in the caller's buffer, the queue only holds offsets */
+	for(i = 0; i < 64; ++i)
+	{
+		payloads[i][0] = (char)i;
+		status = RefQueueEnqueue(queue, (ref_queue_key_t)((i * 29) % 64), (ref_queue_offset_t)(i * sizeof(payloads[0])));
+		assert(0 == status);
+	}
+
+	assert(64 == RefQueueSize(queue));
+	assert(0 == RefQueuePeek(queue, &ref));
+	assert(63 == ref.key);
+
+	for(i = 64; i > 0; --i)
+	{
+		status = RefQueueDequeue(queue, &ref);
+		assert(0 == status);
+		assert((ref_queue_key_t)(i - 1) == ref.key);
+		assert((i - 1) == (size_t)((*(char *)REF_QUEUE_RESOLVE(payloads, ref) * 29) % 64));
+	}
+
+	assert(1 == RefQueueIsEmpty(queue));
+	RefQueueEnqueue(queue, 1, 0);
+	RefQueueClear(queue);
+	assert(0 == RefQueueSize(queue));
+	RefQueueDestroy(queue);
+	(void)status;
+}
+/*****************************************************************************/